@@ -6,6 +6,7 @@
 #include <blockencodings.h>
 #include <consensus/amount.h>
 #include <kernel/cs_main.h>
+#include <kernel/mempool_options.h>
 #include <net_processing.h>
 #include <primitives/transaction.h>
 #include <script/script.h>
@@ -57,7 +58,28 @@ public:
 };
 } // anon namespace
 
-static void BlockEncodingBench(benchmark::Bench& bench, size_t n_pool, size_t n_extra)
+static CTransactionRef MakeBenchTx(size_t i)
+{
+    // bump up the size of txs
+    std::array<std::byte,200> sigspam;
+    sigspam.fill(std::byte(42));
+
+    CMutableTransaction tx = CMutableTransaction();
+    tx.vin.resize(1);
+    tx.vin[0].scriptSig = CScript() << sigspam;
+    tx.vin[0].scriptWitness.stack.push_back({1});
+    tx.vout.resize(1);
+    tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
+    tx.vout[0].nValue = i;
+    return MakeTransactionRef(tx);
+}
+
+/**
+ * Reconstruct a compact block of 3000 unknown short IDs against a mempool of
+ * n_pool transactions (or, if pool_usage is set, as many transactions as it
+ * takes to reach that mempool memory usage) plus n_extra extra transactions.
+ */
+static void BlockEncodingBench(benchmark::Bench& bench, size_t n_pool, size_t n_extra, size_t pool_usage = 0)
 {
     const auto testing_setup = MakeNoLogFileContext<const ChainTestingSetup>(ChainType::MAIN);
     CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
@@ -68,22 +90,11 @@ static void BlockEncodingBench(benchmark::Bench& bench, size_t n_pool, size_t n_
     std::vector<std::pair<Wtxid, CTransactionRef>> extratxn;
     extratxn.reserve(n_extra);
 
-    // bump up the size of txs
-    std::array<std::byte,200> sigspam;
-    sigspam.fill(std::byte(42));
-
     // a reasonably large mempool of 50k txs, ~10MB total
     std::vector<CTransactionRef> refs;
     refs.reserve(n_pool + n_extra);
     for (size_t i = 0; i < n_pool + n_extra; ++i) {
-        CMutableTransaction tx = CMutableTransaction();
-        tx.vin.resize(1);
-        tx.vin[0].scriptSig = CScript() << sigspam;
-        tx.vin[0].scriptWitness.stack.push_back({1});
-        tx.vout.resize(1);
-        tx.vout[0].scriptPubKey = CScript() << OP_1 << OP_EQUAL;
-        tx.vout[0].nValue = i;
-        refs.push_back(MakeTransactionRef(tx));
+        refs.push_back(MakeBenchTx(i));
     }
 
     // ensure mempool ordering is different to memory ordering of transactions,
@@ -96,6 +107,10 @@ static void BlockEncodingBench(benchmark::Bench& bench, size_t n_pool, size_t n_
     for (size_t i = n_pool; i < n_pool + n_extra; ++i) {
         extratxn.emplace_back(refs[i]->GetWitnessHash(), refs[i]);
     }
+    for (size_t i = n_pool + n_extra; pool.DynamicMemoryUsage() < pool_usage; ++i) {
+        const auto tx{MakeBenchTx(i)};
+        AddTx(tx, /*fee=*/tx->vout[0].nValue, pool);
+    }
 
     BenchCBHAST cmpctblock{rng, 3000};
 
@@ -126,6 +141,13 @@ static void BlockEncodingLargeExtra(benchmark::Bench& bench)
     BlockEncodingBench(bench, 50000, 5000);
 }
 
+static void BlockEncodingFullMempool(benchmark::Bench& bench)
+{
+    // a mempool filled up to the default -maxmempool of 300MB
+    BlockEncodingBench(bench, 0, 100, DEFAULT_MAX_MEMPOOL_SIZE_MB * 1'000'000);
+}
+
 BENCHMARK(BlockEncodingNoExtra, benchmark::PriorityLevel::HIGH);
 BENCHMARK(BlockEncodingStdExtra, benchmark::PriorityLevel::HIGH);
 BENCHMARK(BlockEncodingLargeExtra, benchmark::PriorityLevel::HIGH);
+BENCHMARK(BlockEncodingFullMempool, benchmark::PriorityLevel::LOW);
@@ -7,6 +7,7 @@
 #include <kernel/cs_main.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
+#include <random.h>
 #include <script/script.h>
 #include <sync.h>
 #include <test/util/setup_common.h>
@@ -144,4 +145,51 @@ static void MempoolEviction(benchmark::Bench& bench)
     });
 }
 
+/** Trim a full 50 MB mempool of small clusters 200 kB at a time. As the lowest-feerate
+ *  chunk is found in the sorted chunk index, the time per step should not depend on the size
+ *  of the mempool. */
+static void MempoolEvictionFull(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>();
+    CTxMemPool& pool = *Assert(testing_setup->m_node.mempool);
+    FastRandomContext det_rand{/*fDeterministic=*/true};
+    constexpr size_t FULL_MEMPOOL_BYTES{50'000'000};
+    constexpr size_t MAX_CHAIN_LENGTH{8};
+    constexpr size_t TRIM_STEP_BYTES{200'000};
+
+    LOCK2(cs_main, pool.cs);
+    CTransactionRef parent;
+    size_t chain_length{0};
+    while (pool.DynamicMemoryUsage() < FULL_MEMPOOL_BYTES) {
+        CMutableTransaction tx;
+        tx.vin.resize(1);
+        // Extend the current chain with a probability of 3/4, otherwise start a new cluster.
+        if (parent && chain_length < MAX_CHAIN_LENGTH && det_rand.randrange(4) != 0) {
+            tx.vin[0].prevout = COutPoint(parent->GetHash(), 0);
+            ++chain_length;
+        } else {
+            tx.vin[0].prevout = COutPoint(Txid::FromUint256(det_rand.rand256()), 0);
+            chain_length = 1;
+        }
+        tx.vin[0].scriptWitness.stack.push_back(det_rand.randbytes(72));
+        tx.vin[0].scriptWitness.stack.push_back(det_rand.randbytes(33));
+        tx.vout.resize(2);
+        for (auto& out : tx.vout) {
+            out.scriptPubKey = CScript() << OP_0 << det_rand.randbytes(20);
+            out.nValue = 10 * COIN;
+        }
+        parent = MakeTransactionRef(tx);
+        AddTx(parent, 1000 + det_rand.randrange(100000), pool);
+    }
+    // Get all clusters linearized before measuring.
+    pool.TrimToSize(FULL_MEMPOOL_BYTES);
+
+    size_t limit{pool.DynamicMemoryUsage()};
+    bench.epochs(10).epochIterations(1).run([&]() NO_THREAD_SAFETY_ANALYSIS {
+        limit -= TRIM_STEP_BYTES;
+        pool.TrimToSize(limit);
+    });
+}
+
 BENCHMARK(MempoolEviction, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolEvictionFull, benchmark::PriorityLevel::LOW);
@@ -0,0 +1,102 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <kernel/mempool_removal_reason.h>
+#include <node/mempool_persist.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <tinyformat.h>
+#include <txmempool.h>
+#include <uint256.h>
+#include <util/fs.h>
+#include <validation.h>
+
+#include <cassert>
+#include <cstddef>
+#include <vector>
+
+using node::DumpMempool;
+using node::LoadMempool;
+
+namespace {
+/** Number of transactions in each mempool dump. */
+constexpr size_t NUM_TXS{1000};
+/**
+ * Number of dumps of different transactions spending the same coins. Each is only loaded once,
+ * as loading a dump again would find all its signatures in the signature cache.
+ */
+constexpr size_t NUM_DUMPS{5};
+
+void ClearMempool(CTxMemPool& pool)
+{
+    LOCK(pool.cs);
+    for (const auto& info : pool.infoAll()) {
+        pool.removeRecursive(*info.tx, MemPoolRemovalReason::REPLACED);
+    }
+}
+
+/** Load mempool dumps of NUM_TXS signed one-input transactions each. */
+void LoadMempoolBench(benchmark::Bench& bench, bool trust_unchanged_tip)
+{
+    const auto test_setup = MakeNoLogFileContext<TestChain100Setup>();
+    CTxMemPool& pool{*test_setup->m_node.mempool};
+    Chainstate& chainstate{test_setup->m_node.chainman->ActiveChainstate()};
+    const CScript p2pk{CScript() << ToByteVector(test_setup->coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+
+    // Fan out a mature coinbase output to one confirmed coin per transaction.
+    const CTransactionRef& coinbase{test_setup->m_coinbase_txns[0]};
+    const CAmount coin_value{(coinbase->vout[0].nValue - COIN) / static_cast<CAmount>(NUM_TXS)};
+    const CMutableTransaction fanout{test_setup->CreateValidTransaction({coinbase}, {COutPoint{coinbase->GetHash(), 0}}, /*input_height=*/1,
+                                                                        {test_setup->coinbaseKey}, std::vector<CTxOut>(NUM_TXS, CTxOut{coin_value, p2pk}),
+                                                                        /*feerate=*/std::nullopt, /*fee_output=*/std::nullopt).first};
+    test_setup->CreateAndProcessBlock({fanout}, p2pk);
+    const int fanout_height{WITH_LOCK(::cs_main, return chainstate.m_chain.Height())};
+    const uint256 tip_hash{WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash())};
+    const CTransactionRef fanout_ref{MakeTransactionRef(fanout)};
+
+    // The dumped transactions are added to the mempool without validating them, so that their
+    // signatures and scripts are not in the validation caches when the dumps are loaded.
+    std::vector<fs::path> dumps;
+    TestMemPoolEntryHelper entry;
+    for (size_t dump{0}; dump < NUM_DUMPS; ++dump) {
+        for (size_t i{0}; i < NUM_TXS; ++i) {
+            const CAmount fee{1000 + static_cast<CAmount>(dump)};
+            const auto [tx, tx_fee]{test_setup->CreateValidTransaction({fanout_ref}, {COutPoint{fanout_ref->GetHash(), static_cast<uint32_t>(i)}}, fanout_height,
+                                                                       {test_setup->coinbaseKey}, {CTxOut{coin_value - fee, p2pk}},
+                                                                       /*feerate=*/std::nullopt, /*fee_output=*/std::nullopt)};
+            LOCK2(::cs_main, pool.cs);
+            AddToMempool(pool, entry.Fee(tx_fee).FromTx(tx));
+        }
+        dumps.push_back(test_setup->m_path_root / fs::u8path(strprintf("mempool%u.dat", dump)));
+        assert(DumpMempool(pool, dumps.back(), tip_hash, fsbridge::fopen, /*skip_file_commit=*/true));
+        ClearMempool(pool);
+    }
+
+    size_t dump{0};
+    bench.epochs(NUM_DUMPS).epochIterations(1).batch(NUM_TXS).unit("tx").run([&] {
+        assert(LoadMempool(pool, dumps[dump++ % NUM_DUMPS], chainstate,
+                           {.use_current_time = true, .trust_unchanged_tip = trust_unchanged_tip}));
+        assert(pool.size() == NUM_TXS);
+        ClearMempool(pool);
+    });
+}
+} // namespace
+
+static void MempoolLoad(benchmark::Bench& bench)
+{
+    LoadMempoolBench(bench, /*trust_unchanged_tip=*/false);
+}
+
+static void MempoolLoadTrusted(benchmark::Bench& bench)
+{
+    LoadMempoolBench(bench, /*trust_unchanged_tip=*/true);
+}
+
+BENCHMARK(MempoolLoad, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolLoadTrusted, benchmark::PriorityLevel::HIGH);
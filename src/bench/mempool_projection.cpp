@@ -0,0 +1,113 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <consensus/amount.h>
+#include <kernel/cs_main.h>
+#include <kernel/mempool_removal_reason.h>
+#include <policy/feerate.h>
+#include <policy/policy.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <script/script.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <test/util/txmempool.h>
+#include <txmempool.h>
+#include <util/check.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace {
+/** Transactions in the mempool when the replay starts, about 15 blocks worth. */
+constexpr size_t NUM_PREFILL_TXS{6000};
+/** Transactions arriving during the replay. */
+constexpr size_t NUM_REPLAY_TXS{6000};
+/** Transactions arriving between two projections. */
+constexpr size_t TXS_PER_STEP{100};
+/** Arrival batches between two blocks, so that blocks remove about as much as arrives in between. */
+constexpr size_t STEPS_PER_BLOCK{4};
+/** Transactions swapped in one at a time to invalidate the cached projection. */
+constexpr size_t NUM_PROBE_TXS{100};
+
+struct ReplayTx {
+    CTransactionRef tx;
+    CAmount fee;
+};
+
+/** Independent transactions of 200 to 5000 vbytes paying 1 to 200 sat/vB. */
+std::vector<ReplayTx> MakeReplayTxs(FastRandomContext& rng, size_t count)
+{
+    std::vector<ReplayTx> txs;
+    txs.reserve(count);
+    for (size_t i{0}; i < count; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{Txid::FromUint256(rng.rand256()), 0});
+        tx.vout.emplace_back(0, CScript() << OP_RETURN << std::vector<unsigned char>(200 + rng.randrange(4800)));
+        const auto ref{MakeTransactionRef(tx)};
+        txs.push_back({ref, GetVirtualTransactionSize(*ref) * static_cast<CAmount>(1 + rng.randrange(200))});
+    }
+    return txs;
+}
+
+void AddTx(const ReplayTx& replay_tx, CTxMemPool& pool) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
+{
+    AddToMempool(pool, TestMemPoolEntryHelper{}.Fee(replay_tx.fee).FromTx(replay_tx.tx));
+}
+
+/** Remove the transactions a miner would put in the next block, as if it was found. */
+void MineBlock(CTxMemPool& pool, unsigned int height) EXCLUSIVE_LOCKS_REQUIRED(cs_main, pool.cs)
+{
+    std::vector<CTransactionRef> block;
+    {
+        const auto builder{pool.GetBlockBuilder()};
+        int64_t block_weight{0};
+        while (const auto chunk{builder->GetCurrentChunk()}) {
+            if (block_weight + chunk->second.size > DEFAULT_BLOCK_MAX_WEIGHT) break;
+            block_weight += chunk->second.size;
+            for (const auto* ref : chunk->first) block.push_back(pool.GetIter(*ref)->GetSharedTx());
+            builder->Include();
+        }
+    }
+    pool.removeForBlock(block, height);
+}
+} // namespace
+
+/**
+ * Project the next blocks of a mempool holding more than CTxMemPool::MAX_PROJECTED_BLOCKS
+ * blocks of transactions, after replaying arrivals and blocks on it. Only the projection is
+ * timed: each iteration swaps a single probe transaction, which is just enough to invalidate
+ * the cached projection.
+ */
+static void MempoolProjectedBlocksReplay(benchmark::Bench& bench)
+{
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>();
+    CTxMemPool& pool = *testing_setup->m_node.mempool;
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto prefill{MakeReplayTxs(rng, NUM_PREFILL_TXS)};
+    const auto replay{MakeReplayTxs(rng, NUM_REPLAY_TXS)};
+    const auto probes{MakeReplayTxs(rng, NUM_PROBE_TXS)};
+
+    LOCK2(cs_main, pool.cs);
+    for (const auto& tx : prefill) AddTx(tx, pool);
+    unsigned int height{1};
+    for (size_t step{0}; step < NUM_REPLAY_TXS / TXS_PER_STEP; ++step) {
+        for (size_t i{step * TXS_PER_STEP}; i < (step + 1) * TXS_PER_STEP; ++i) AddTx(replay[i], pool);
+        if (step % STEPS_PER_BLOCK == STEPS_PER_BLOCK - 1) MineBlock(pool, height++);
+    }
+    assert(pool.GetProjectedBlockFeerates().size() == CTxMemPool::MAX_PROJECTED_BLOCKS);
+
+    size_t probe{0};
+    bench.unit("projection").run([&]() NO_THREAD_SAFETY_ANALYSIS {
+        pool.removeRecursive(*probes[probe % NUM_PROBE_TXS].tx, MemPoolRemovalReason::REPLACED);
+        AddTx(probes[++probe % NUM_PROBE_TXS], pool);
+        const auto projected{pool.GetProjectedBlockFeerates()};
+        assert(projected.size() == CTxMemPool::MAX_PROJECTED_BLOCKS);
+    });
+}
+
+BENCHMARK(MempoolProjectedBlocksReplay, benchmark::PriorityLevel::HIGH);
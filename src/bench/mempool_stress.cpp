@@ -4,6 +4,7 @@
 
 #include <bench/bench.h>
 #include <consensus/amount.h>
+#include <memusage.h>
 #include <policy/policy.h>
 #include <primitives/transaction.h>
 #include <random.h>
@@ -11,12 +12,14 @@
 #include <sync.h>
 #include <test/util/setup_common.h>
 #include <test/util/txmempool.h>
+#include <tinyformat.h>
 #include <txmempool.h>
 #include <validation.h>
 
 #include <cstddef>
 #include <cstdint>
 #include <memory>
+#include <utility>
 #include <vector>
 
 class CCoinsViewCache;
@@ -126,5 +129,37 @@ static void MempoolCheck(benchmark::Bench& bench)
     });
 }
 
+/**
+ * Fill the mempool and report its memory usage per transaction. The name also shows the usage
+ * with mapTx and mapNextTx accounted for as one heap allocation per node, as they used to be.
+ */
+static void MempoolMemoryUsage(benchmark::Bench& bench)
+{
+    FastRandomContext det_rand{true};
+    std::vector<CTransactionRef> ordered_coins = CreateOrderedCoins(det_rand, /*childTxs=*/5000, /*min_ancestors=*/1);
+    const auto testing_setup = MakeNoLogFileContext<const TestingSetup>(ChainType::MAIN);
+    CTxMemPool& pool = *testing_setup.get()->m_node.mempool;
+    LOCK2(cs_main, pool.cs);
+
+    for (auto& tx : ordered_coins) {
+        AddTx(tx, pool);
+    }
+    const size_t num_txs{pool.size()};
+    const size_t node_index_usage{memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 15 * sizeof(void*)) * num_txs +
+                                      memusage::MallocUsage(sizeof(memusage::stl_tree_node<std::pair<const COutPoint*, const CTransaction*>>)) * pool.mapNextTx.size()};
+    const size_t pooled_index_usage{pool.mapTx.get_allocator().resource()->UsedBytes()};
+    const size_t usage{pool.DynamicMemoryUsage()};
+    bench.name(strprintf("%s (%u bytes per tx, %u with per-node accounting)", __func__,
+                         usage / num_txs, (usage - pooled_index_usage + node_index_usage) / num_txs));
+
+    bench.batch(num_txs).unit("tx").run([&]() NO_THREAD_SAFETY_ANALYSIS {
+        pool.TrimToSize(0);
+        for (auto& tx : ordered_coins) {
+            AddTx(tx, pool);
+        }
+    });
+}
+
 BENCHMARK(ComplexMemPool, benchmark::PriorityLevel::HIGH);
+BENCHMARK(MempoolMemoryUsage, benchmark::PriorityLevel::HIGH);
 BENCHMARK(MempoolCheck, benchmark::PriorityLevel::HIGH);
@@ -17,6 +17,7 @@
 #include <univalue.h>
 #include <validation.h>
 
+#include <cassert>
 #include <cstddef>
 #include <memory>
 #include <vector>
@@ -86,3 +87,17 @@ static void BlockToJsonVerboseWrite(benchmark::Bench& bench)
 }
 
 BENCHMARK(BlockToJsonVerboseWrite, benchmark::PriorityLevel::HIGH);
+
+static void BlockToJsonVerboseRead(benchmark::Bench& bench)
+{
+    TestBlockAndIndex data;
+    const uint256 pow_limit{data.testing_setup->m_node.chainman->GetParams().GetConsensus().powLimit};
+    const auto str{blockToJSON(data.testing_setup->m_node.chainman->m_blockman, data.block, data.blockindex, data.blockindex, TxVerbosity::SHOW_DETAILS_AND_PREVOUT, pow_limit).write()};
+    bench.run([&] {
+        UniValue univalue;
+        assert(univalue.read(str));
+        ankerl::nanobench::doNotOptimizeAway(univalue);
+    });
+}
+
+BENCHMARK(BlockToJsonVerboseRead, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,65 @@
+// Copyright (c) The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <coins.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <rpc/blockchain.h>
+#include <script/script.h>
+#include <txdb.h>
+#include <uint256.h>
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
+
+static constexpr size_t NUM_COINS{100'000};
+
+//! Scan a UTXO set of NUM_COINS coins for one script, split into n_ranges ranges scanned in parallel
+static void ScanTxOutSet(benchmark::Bench& bench, size_t n_ranges)
+{
+    CCoinsViewDB db{{.path = "scantxoutset_bench", .cache_bytes = 1 << 20, .memory_only = true}, {}};
+    const CScript needle{CScript() << OP_TRUE};
+    const CScript other{CScript() << OP_FALSE};
+    FastRandomContext rng{/*fDeterministic=*/true};
+    {
+        CCoinsViewCache cache{&db};
+        for (size_t i{0}; i < NUM_COINS; ++i) {
+            const COutPoint outpoint{Txid::FromUint256(rng.rand256()), 0};
+            cache.AddCoin(outpoint, Coin{CTxOut{1000, i % 100 == 0 ? needle : other}, 1, false}, /*possible_overwrite=*/true);
+        }
+        cache.SetBestBlock(uint256::ONE);
+        assert(cache.Flush());
+    }
+
+    const std::set<CScript> scripts{needle};
+    std::function<void()> interruption_point{[] {}};
+    bench.unit("coin").batch(NUM_COINS).run([&] {
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+        for (size_t i{0}; i < n_ranges; ++i) cursors.push_back(db.Cursor(ScanRangeStart(i, n_ranges)));
+        std::atomic<int> progress{0};
+        const std::atomic<bool> should_abort{false};
+        int64_t count{0};
+        std::map<COutPoint, Coin> found;
+        const bool success{FindScriptPubKey(progress, should_abort, count, cursors, scripts, found, interruption_point)};
+        assert(success);
+        assert(count == int64_t(NUM_COINS));
+        assert(found.size() == NUM_COINS / 100);
+    });
+}
+
+static void ScanTxOutSetSingle(benchmark::Bench& bench) { ScanTxOutSet(bench, 1); }
+static void ScanTxOutSetRanges4(benchmark::Bench& bench) { ScanTxOutSet(bench, 4); }
+static void ScanTxOutSetRanges16(benchmark::Bench& bench) { ScanTxOutSet(bench, 16); }
+
+BENCHMARK(ScanTxOutSetSingle, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ScanTxOutSetRanges4, benchmark::PriorityLevel::HIGH);
+BENCHMARK(ScanTxOutSetRanges16, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,119 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <node/txreconciliation.h>
+#include <protocol.h>
+#include <random.h>
+#include <serialize.h>
+#include <streams.h>
+#include <tinyformat.h>
+#include <util/check.h>
+
+#include <cassert>
+#include <memory>
+#include <vector>
+
+namespace {
+/** Number of peers we relay transactions to. */
+constexpr int NUM_PEERS{200};
+/** Number of transactions relayed to each peer between two reconciliations with it. */
+constexpr int TXS_PER_ROUND{500};
+/** Size of a serialized inventory entry. */
+constexpr size_t INV_ENTRY_SIZE{36};
+
+/**
+ * Transactions to relay on a single connection during one round. In a well-connected
+ * network most transactions reach both ends of a connection from other peers before the
+ * connection reconciles, so they are in both reconciliation sets and cancel out. Flooding
+ * announces every one of them on every connection regardless.
+ */
+struct LinkTxs {
+    std::vector<Wtxid> ours, theirs;
+};
+
+std::vector<LinkTxs> MakeLinkTxs(FastRandomContext& rng)
+{
+    std::vector<LinkTxs> links(NUM_PEERS);
+    for (auto& link : links) {
+        for (int i = 0; i < TXS_PER_ROUND; ++i) {
+            const Wtxid wtxid{Wtxid::FromUint256(rng.rand256())};
+            // 95% of transactions are known to both sides, the rest only to one side.
+            const auto r{rng.randrange(40)};
+            if (r != 0) link.ours.push_back(wtxid);
+            if (r != 1) link.theirs.push_back(wtxid);
+        }
+    }
+    return links;
+}
+} // namespace
+
+/** A full reconciliation round with each of NUM_PEERS peers, with us as the initiator. */
+static void TxReconciliationRound(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto links{MakeLinkTxs(rng)};
+
+    TxReconciliationTracker ours(TXRECONCILIATION_VERSION);
+    std::vector<std::unique_ptr<TxReconciliationTracker>> theirs;
+    for (NodeId peer = 0; peer < NUM_PEERS; ++peer) {
+        theirs.push_back(std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION));
+        const uint64_t our_salt{ours.PreRegisterPeer(peer)};
+        const uint64_t their_salt{theirs.back()->PreRegisterPeer(0)};
+        Assert(ours.RegisterPeer(peer, /*is_peer_inbound=*/false, TXRECONCILIATION_VERSION, their_salt) == ReconciliationRegisterResult::SUCCESS);
+        Assert(theirs.back()->RegisterPeer(0, /*is_peer_inbound=*/true, TXRECONCILIATION_VERSION, our_salt) == ReconciliationRegisterResult::SUCCESS);
+    }
+
+    std::chrono::microseconds now{0};
+    auto run_round = [&] {
+        now += RECON_REQUEST_INTERVAL;
+        size_t bytes{0};
+        for (NodeId peer = 0; peer < NUM_PEERS; ++peer) {
+            for (const auto& wtxid : links[peer].ours) ours.AddToSet(peer, wtxid);
+            for (const auto& wtxid : links[peer].theirs) theirs[peer]->AddToSet(0, wtxid);
+
+            const auto request{*Assert(ours.InitiateReconciliationRequest(peer, now))};
+            const auto sketch{*Assert(theirs[peer]->HandleReconciliationRequest(0, request.first, request.second))};
+            const auto outcome{*Assert(ours.HandleSketch(peer, sketch))};
+            const auto their_announce{*Assert(theirs[peer]->HandleReconciliationDifference(0, outcome.success, outcome.ask_shortids))};
+            assert(outcome.success);
+
+            // reqrecon, sketch, reconcildiff and the resulting inv messages in both directions
+            bytes += 4 + GetSerializeSize(sketch);
+            bytes += 1 + GetSerializeSize(outcome.ask_shortids);
+            bytes += (outcome.announce.size() + their_announce.size()) * INV_ENTRY_SIZE;
+        }
+        return bytes;
+    };
+
+    bench.name(strprintf("%s (%u bytes per peer per round)", __func__, run_round() / NUM_PEERS));
+    bench.batch(NUM_PEERS).unit("peer").run([&] { run_round(); });
+}
+
+/** Announcing the same transactions to each of NUM_PEERS peers by flooding invs. */
+static void TxFloodRelay(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const auto links{MakeLinkTxs(rng)};
+
+    auto run_round = [&] {
+        size_t bytes{0};
+        for (const auto& link : links) {
+            std::vector<CInv> invs;
+            invs.reserve(link.ours.size());
+            for (const auto& wtxid : link.ours) invs.emplace_back(MSG_WTX, wtxid.ToUint256());
+            DataStream stream;
+            stream << invs;
+            // Transactions only the peer knows about are announced to us instead.
+            bytes += stream.size() + (TXS_PER_ROUND - link.ours.size()) * INV_ENTRY_SIZE;
+        }
+        return bytes;
+    };
+
+    bench.name(strprintf("%s (%u bytes per peer per round)", __func__, run_round() / NUM_PEERS));
+    bench.batch(NUM_PEERS).unit("peer").run([&] { run_round(); });
+}
+
+BENCHMARK(TxReconciliationRound, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxFloodRelay, benchmark::PriorityLevel::HIGH);
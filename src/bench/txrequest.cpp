@@ -0,0 +1,79 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <net.h>
+#include <primitives/transaction.h>
+#include <random.h>
+#include <txrequest.h>
+#include <uint256.h>
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <span>
+#include <vector>
+
+namespace {
+/** Number of peers that announce the same transactions. */
+constexpr int NUM_PEERS{1000};
+/** Number of transactions in the flood. */
+constexpr size_t NUM_TXS{200};
+/** Number of announcements per inv message, roughly what trickling produces at high transaction rates. */
+constexpr size_t INV_SIZE{35};
+/** Expiry of requests made by the benchmark. */
+constexpr std::chrono::microseconds REQUEST_EXPIRY{60s};
+
+std::vector<GenTxid> MakeFlood()
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<GenTxid> gtxids;
+    for (size_t i = 0; i < NUM_TXS; ++i) gtxids.emplace_back(Wtxid::FromUint256(rng.rand256()));
+    return gtxids;
+}
+
+/**
+ * Every peer announces the whole flood, in inv messages of INV_SIZE entries each, after which
+ * each peer is asked for its requestable transactions and those are marked as requested.
+ */
+template <typename AnnounceFn>
+void TxRequestFlood(benchmark::Bench& bench, AnnounceFn announce)
+{
+    const auto flood{MakeFlood()};
+    bench.batch(NUM_PEERS * NUM_TXS).unit("announcement").run([&] {
+        TxRequestTracker tracker{/*deterministic=*/true};
+        const std::chrono::microseconds now{1s};
+        for (NodeId peer = 0; peer < NUM_PEERS; ++peer) {
+            for (size_t pos = 0; pos < flood.size(); pos += INV_SIZE) {
+                announce(tracker, peer, std::span{flood}.subspan(pos, std::min(INV_SIZE, flood.size() - pos)), now);
+            }
+        }
+        for (NodeId peer = 0; peer < NUM_PEERS; ++peer) {
+            for (const auto& gtxid : tracker.GetRequestable(peer, now)) {
+                tracker.RequestedTx(peer, gtxid.ToUint256(), now + REQUEST_EXPIRY);
+            }
+        }
+        assert(tracker.Size() == NUM_PEERS * NUM_TXS);
+    });
+}
+} // namespace
+
+/** Announcements are added one by one. */
+static void TxRequestFloodSingle(benchmark::Bench& bench)
+{
+    TxRequestFlood(bench, [](TxRequestTracker& tracker, NodeId peer, std::span<const GenTxid> inv, std::chrono::microseconds now) {
+        for (const auto& gtxid : inv) tracker.ReceivedInv(peer, gtxid, /*preferred=*/peer % 8 == 0, now);
+    });
+}
+
+/** Announcements are added one inv message at a time. */
+static void TxRequestFloodBatched(benchmark::Bench& bench)
+{
+    TxRequestFlood(bench, [](TxRequestTracker& tracker, NodeId peer, std::span<const GenTxid> inv, std::chrono::microseconds now) {
+        tracker.ReceivedInvs(peer, inv, /*preferred=*/peer % 8 == 0, now);
+    });
+}
+
+BENCHMARK(TxRequestFloodSingle, benchmark::PriorityLevel::HIGH);
+BENCHMARK(TxRequestFloodBatched, benchmark::PriorityLevel::HIGH);
@@ -0,0 +1,70 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <bench/bench.h>
+#include <random.h>
+#include <univalue.h>
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+/** Number of elements in the benchmarked arrays. */
+constexpr size_t NUM_ELEMENTS{10000};
+
+/** Strings of 10 to 200 characters of printable ASCII, one in eight holding a character that needs escaping. */
+UniValue MakeStrings(FastRandomContext& rng)
+{
+    UniValue arr{UniValue::VARR};
+    for (size_t i{0}; i < NUM_ELEMENTS; ++i) {
+        std::string str(10 + rng.randrange(190), ' ');
+        for (auto& ch : str) ch = static_cast<char>(' ' + rng.randrange(95));
+        if (rng.randrange(8) == 0) str[rng.randrange(str.size())] = "\"\\\n\t"[rng.randrange(4)];
+        arr.push_back(std::move(str));
+    }
+    return arr;
+}
+} // namespace
+
+static void UniValueWriteStrings(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const UniValue arr{MakeStrings(rng)};
+    bench.batch(NUM_ELEMENTS).unit("string").run([&] {
+        auto str{arr.write()};
+        ankerl::nanobench::doNotOptimizeAway(str);
+    });
+}
+
+static void UniValueReadStrings(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    const std::string json{MakeStrings(rng).write()};
+    bench.batch(NUM_ELEMENTS).unit("string").run([&] {
+        UniValue arr;
+        assert(arr.read(json));
+        ankerl::nanobench::doNotOptimizeAway(arr);
+    });
+}
+
+static void UniValueFromIntegers(benchmark::Bench& bench)
+{
+    FastRandomContext rng{/*fDeterministic=*/true};
+    std::vector<int64_t> ints(NUM_ELEMENTS);
+    for (auto& i : ints) i = static_cast<int64_t>(rng.rand64() >> rng.randrange(64));
+    bench.batch(NUM_ELEMENTS).unit("integer").run([&] {
+        UniValue arr{UniValue::VARR};
+        arr.reserve(NUM_ELEMENTS);
+        for (const int64_t i : ints) arr.push_back(i);
+        ankerl::nanobench::doNotOptimizeAway(arr);
+    });
+}
+
+BENCHMARK(UniValueWriteStrings, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UniValueReadStrings, benchmark::PriorityLevel::HIGH);
+BENCHMARK(UniValueFromIntegers, benchmark::PriorityLevel::HIGH);
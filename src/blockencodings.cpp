@@ -15,6 +15,8 @@
 #include <txmempool.h>
 #include <validation.h>
 
+#include <algorithm>
+#include <future>
 #include <unordered_map>
 
 CBlockHeaderAndShortTxIDs::CBlockHeaderAndShortTxIDs(const CBlock& block, const uint64_t nonce) :
@@ -114,29 +116,51 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     std::vector<bool> have_txn(txn_available.size());
     {
     LOCK(pool->cs);
-    for (const auto& [wtxid, txit] : pool->txns_randomized) {
-        uint64_t shortid = cmpctblock.GetShortID(wtxid);
-        std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
-        if (idit != shorttxids.end()) {
-            if (!have_txn[idit->second]) {
-                txn_available[idit->second] = txit->GetSharedTx();
-                have_txn[idit->second]  = true;
-                mempool_count++;
-            } else {
-                // If we find two mempool txn that match the short id, just request it.
-                // This should be rare enough that the extra bandwidth doesn't matter,
-                // but eating a round-trip due to FillBlock failure would be annoying
-                if (txn_available[idit->second]) {
-                    txn_available[idit->second].reset();
-                    mempool_count--;
-                }
+    if (pool->txns_randomized.size() < SHORTID_PARALLEL_MIN_TXS) {
+        for (const auto& [wtxid, txit] : pool->txns_randomized) {
+            uint64_t shortid = cmpctblock.GetShortID(wtxid);
+            std::unordered_map<uint64_t, uint16_t>::iterator idit = shorttxids.find(shortid);
+            if (idit != shorttxids.end()) {
+                AddMempoolMatch(idit->second, txit->GetSharedTx(), have_txn);
+            }
+            // Though ideally we'd continue scanning for the two-txn-match-shortid case,
+            // the performance win of an early exit here is too good to pass up and worth
+            // the extra risk.
+            if (mempool_count == shorttxids.size())
+                break;
+        }
+    } else {
+        // For large mempools, hashing every wtxid dominates reconstruction time. Split
+        // the mempool into contiguous ranges and compute (and look up) the short IDs of
+        // each range on its own thread. The workers only read from the mempool and the
+        // short ID map while we hold pool->cs, and report (mempool position, block
+        // position) pairs which are applied below in mempool order, so that the result
+        // matches the sequential scan (minus its early exit).
+        const auto& txns{pool->txns_randomized};
+        const size_t n_workers{std::min<size_t>(std::clamp(GetNumCores(), 1, SHORTID_PARALLEL_MAX_THREADS), txns.size() / SHORTID_PARALLEL_MIN_TXS + 1)};
+        const size_t chunk_size{(txns.size() + n_workers - 1) / n_workers};
+        auto scan_range = [&](size_t begin, size_t end) {
+            std::vector<std::pair<size_t, uint16_t>> matches;
+            for (size_t i = begin; i < end; ++i) {
+                const auto idit{shorttxids.find(cmpctblock.GetShortID(txns[i].first))};
+                if (idit != shorttxids.end()) matches.emplace_back(i, idit->second);
+            }
+            return matches;
+        };
+        std::vector<std::future<std::vector<std::pair<size_t, uint16_t>>>> workers;
+        workers.reserve(n_workers - 1);
+        for (size_t begin = chunk_size; begin < txns.size(); begin += chunk_size) {
+            workers.push_back(std::async(std::launch::async, scan_range, begin, std::min(begin + chunk_size, txns.size())));
+        }
+        // Scan the first range on this thread while the workers handle the rest.
+        for (const auto& [mempool_pos, block_pos] : scan_range(0, std::min(chunk_size, txns.size()))) {
+            AddMempoolMatch(block_pos, txns[mempool_pos].second->GetSharedTx(), have_txn);
+        }
+        for (auto& worker : workers) {
+            for (const auto& [mempool_pos, block_pos] : worker.get()) {
+                AddMempoolMatch(block_pos, txns[mempool_pos].second->GetSharedTx(), have_txn);
             }
         }
-        // Though ideally we'd continue scanning for the two-txn-match-shortid case,
-        // the performance win of an early exit here is too good to pass up and worth
-        // the extra risk.
-        if (mempool_count == shorttxids.size())
-            break;
     }
     }
 
@@ -176,6 +200,23 @@ ReadStatus PartiallyDownloadedBlock::InitData(const CBlockHeaderAndShortTxIDs& c
     return READ_STATUS_OK;
 }
 
+void PartiallyDownloadedBlock::AddMempoolMatch(uint16_t index, const CTransactionRef& tx, std::vector<bool>& have_txn)
+{
+    if (!have_txn[index]) {
+        txn_available[index] = tx;
+        have_txn[index] = true;
+        mempool_count++;
+    } else {
+        // If we find two mempool txn that match the short id, just request it.
+        // This should be rare enough that the extra bandwidth doesn't matter,
+        // but eating a round-trip due to FillBlock failure would be annoying
+        if (txn_available[index]) {
+            txn_available[index].reset();
+            mempool_count--;
+        }
+    }
+}
+
 bool PartiallyDownloadedBlock::IsTxAvailable(size_t index) const
 {
     if (header.IsNull()) return false;
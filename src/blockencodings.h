@@ -130,11 +130,19 @@ public:
     }
 };
 
+/** Mempool size (in transactions) from which short ID computation in InitData is split across threads */
+static constexpr size_t SHORTID_PARALLEL_MIN_TXS{20000};
+/** Maximum number of threads used to compute mempool short IDs for a single compact block */
+static constexpr int SHORTID_PARALLEL_MAX_THREADS{8};
+
 class PartiallyDownloadedBlock {
 protected:
     std::vector<CTransactionRef> txn_available;
     size_t prefilled_count = 0, mempool_count = 0, extra_count = 0;
     const CTxMemPool* pool;
+
+    // Record that mempool transaction tx matched the short ID at index, handling collisions
+    void AddMempoolMatch(uint16_t index, const CTransactionRef& tx, std::vector<bool>& have_txn);
 public:
     CBlockHeader header;
 
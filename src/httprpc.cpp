@@ -11,24 +11,35 @@
 #include <netaddress.h>
 #include <rpc/protocol.h>
 #include <rpc/server.h>
+#include <sync.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
 #include <util/strencodings.h>
 #include <util/string.h>
+#include <util/time.h>
+#include <util/trace.h>
 #include <walletinitinterface.h>
 
 #include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
 #include <iterator>
 #include <map>
 #include <memory>
 #include <optional>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 using util::SplitString;
 using util::TrimStringView;
 
+TRACEPOINT_SEMAPHORE(rpc, request_served);
+
 /** WWW-Authenticate to present with 401 Unauthorized response */
 static const char* WWW_AUTH_HEADER_DATA = "Basic realm=\"jsonrpc\"";
 
@@ -37,6 +48,10 @@ static std::vector<std::vector<std::string>> g_rpcauth;
 /* RPC Auth Whitelist */
 static std::map<std::string, std::set<std::string>> g_rpc_whitelist;
 static bool g_rpc_whitelist_default = false;
+/* Number of HTTP worker threads a batch request may use besides its own */
+static size_t g_batch_helpers{0};
+/* Largest request body parsed to choose the priority of a JSON-RPC request, larger ones are NORMAL */
+static constexpr size_t MAX_CLASSIFIED_BODY_SIZE{4096};
 
 static void JSONErrorReply(HTTPRequest* req, UniValue objError, const JSONRPCRequest& jreq)
 {
@@ -101,8 +116,128 @@ static bool RPCAuthorized(const std::string& strAuth, std::string& strAuthUserna
     return CheckUserAuthorized(user, pass);
 }
 
+/** Execute one element of a batch request. Returns nothing for notifications. */
+static std::optional<UniValue> ExecBatchElement(JSONRPCRequest& jreq, const UniValue& request)
+{
+    // Batches never throw HTTP errors, they are always just included
+    // in "HTTP OK" responses. Notifications never get any response.
+    UniValue response;
+    try {
+        jreq.parse(request);
+        response = JSONRPCExec(jreq, /*catch_errors=*/true);
+    } catch (UniValue& e) {
+        response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
+    } catch (const std::exception& e) {
+        response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
+    }
+    if (jreq.IsNotification()) return std::nullopt;
+    return response;
+}
+
+/** Whether a batch element may run concurrently with its neighbours, see IsRPCParallelSafe() */
+static bool IsParallelBatchElement(const UniValue& request)
+{
+    if (!request.isObject()) return false;
+    const UniValue& method{request.find_value("method")};
+    return method.isStr() && IsRPCParallelSafe(method.get_str());
+}
+
+/**
+ * Queue single calls of parallel-safe methods, which only read node state, ahead of
+ * the other requests. Batches and large bodies are not parsed here, on the event loop
+ * thread, and are queued as NORMAL.
+ */
+static HTTPPriority ClassifyJSONRPCRequest(const HTTPRequest& req)
+{
+    if (req.GetRequestMethod() != HTTPRequest::POST) return HTTPPriority::NORMAL;
+    const auto body{req.PeekBody(MAX_CLASSIFIED_BODY_SIZE)};
+    UniValue request;
+    if (!body || !request.read(*body)) return HTTPPriority::NORMAL;
+    return IsParallelBatchElement(request) ? HTTPPriority::HIGH : HTTPPriority::NORMAL;
+}
+
+/**
+ * A run of consecutive parallel-safe elements of a batch, executed by the thread
+ * handling the request and by helper tasks on the HTTP worker threads.
+ *
+ * Threads claim elements one at a time, so the request thread never waits on an
+ * element no thread has started: helpers stuck behind other requests in the work
+ * queue find nothing left when they get to run. They keep the run alive through
+ * a shared_ptr, but only touch the batch and the responses for elements they claim.
+ */
+class ParallelBatchRun
+{
+    const JSONRPCRequest m_base_request;
+    const UniValue& m_batch;
+    std::vector<std::optional<UniValue>>& m_responses;
+    const size_t m_end;
+    std::atomic<size_t> m_next;
+    Mutex m_mutex;
+    std::condition_variable m_done_cv;
+    size_t m_num_done GUARDED_BY(m_mutex){0};
+
+public:
+    ParallelBatchRun(const JSONRPCRequest& base_request, const UniValue& batch, std::vector<std::optional<UniValue>>& responses, size_t begin, size_t end)
+        : m_base_request{base_request}, m_batch{batch}, m_responses{responses}, m_end{end}, m_next{begin} {}
+
+    /** Execute unclaimed elements until there are none left. */
+    void Work() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        for (size_t i{m_next++}; i < m_end; i = m_next++) {
+            JSONRPCRequest jreq{m_base_request};
+            m_responses[i] = ExecBatchElement(jreq, m_batch[i]);
+            LOCK(m_mutex);
+            ++m_num_done;
+            m_done_cv.notify_all();
+        }
+    }
+
+    /** Wait until all elements have been executed, after Work() returned. */
+    void WaitDone(size_t count) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex)
+    {
+        WAIT_LOCK(m_mutex, lock);
+        m_done_cv.wait(lock, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) { return m_num_done == count; });
+    }
+};
+
+/**
+ * Execute a batch request. Runs of consecutive elements calling parallel-safe
+ * methods are spread over up to g_batch_helpers HTTP worker threads besides the
+ * current one; every other element runs on its own, in order, so that batches
+ * relying on the side effects of earlier elements keep working.
+ */
+static UniValue ExecBatch(JSONRPCRequest& jreq, const UniValue& batch)
+{
+    std::vector<std::optional<UniValue>> responses(batch.size());
+    for (size_t i{0}; i < batch.size();) {
+        size_t end{i};
+        while (end < batch.size() && IsParallelBatchElement(batch[end])) ++end;
+        if (end - i < 2) {
+            responses[i] = ExecBatchElement(jreq, batch[i]);
+            ++i;
+            continue;
+        }
+
+        const auto run{std::make_shared<ParallelBatchRun>(jreq, batch, responses, i, end)};
+        const size_t num_helpers{std::min(end - i - 1, g_batch_helpers)};
+        for (size_t h{0}; h < num_helpers; ++h) {
+            if (!EnqueueHTTPWork([run] { run->Work(); })) break;
+        }
+        run->Work();
+        run->WaitDone(end - i);
+        i = end;
+    }
+
+    UniValue reply{UniValue::VARR};
+    for (auto& response : responses) {
+        if (response) reply.push_back(std::move(*response));
+    }
+    return reply;
+}
+
 static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
 {
+    const auto handler_start{SteadyClock::now()};
     // JSONRPC handles only POST
     if (req->GetRequestMethod() != HTTPRequest::POST) {
         req->WriteReply(HTTP_BAD_METHOD, "JSONRPC server handles only POST requests");
@@ -141,6 +276,9 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
         // Set the URI
         jreq.URI = req->GetURI();
 
+        const auto execution_start{SteadyClock::now()};
+        // Method to time the request under, see RecordRPCPhaseTime(). Empty for batches.
+        std::string method;
         UniValue reply;
         bool user_has_whitelist = g_rpc_whitelist.count(jreq.authUser);
         if (!user_has_whitelist && g_rpc_whitelist_default) {
@@ -162,6 +300,7 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
             // 2.0 behavior is to catch exceptions and return HTTP success with
             // RPC errors, as long as there is not an actual HTTP server error.
             const bool catch_errors{jreq.m_json_version == JSONRPCVersion::V2};
+            method = jreq.strMethod;
             reply = JSONRPCExec(jreq, catch_errors);
 
             if (jreq.IsNotification()) {
@@ -190,24 +329,7 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
                 }
             }
 
-            // Execute each request
-            reply = UniValue::VARR;
-            for (size_t i{0}; i < valRequest.size(); ++i) {
-                // Batches never throw HTTP errors, they are always just included
-                // in "HTTP OK" responses. Notifications never get any response.
-                UniValue response;
-                try {
-                    jreq.parse(valRequest[i]);
-                    response = JSONRPCExec(jreq, /*catch_errors=*/true);
-                } catch (UniValue& e) {
-                    response = JSONRPCReplyObj(NullUniValue, std::move(e), jreq.id, jreq.m_json_version);
-                } catch (const std::exception& e) {
-                    response = JSONRPCReplyObj(NullUniValue, JSONRPCError(RPC_PARSE_ERROR, e.what()), jreq.id, jreq.m_json_version);
-                }
-                if (!jreq.IsNotification()) {
-                    reply.push_back(std::move(response));
-                }
-            }
+            reply = ExecBatch(jreq, valRequest);
             // Return no response for an all-notification batch, but only if the
             // batch request is non-empty. Technically according to the JSON-RPC
             // 2.0 spec, an empty batch request should also return no response,
@@ -225,8 +347,25 @@ static bool HTTPReq_JSONRPC(const std::any& context, HTTPRequest* req)
         else
             throw JSONRPCError(RPC_PARSE_ERROR, "Top-level object parse error");
 
+        // Execution is timed per method by the RPC server, the rest of the phases is timed here
+        const auto queue_wait{std::chrono::duration_cast<std::chrono::microseconds>(handler_start - req->GetReceivedTime())};
+        const auto execution{std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - execution_start)};
+        RecordRPCPhaseTime(method, RPCPhase::QUEUE, queue_wait);
+        req->SetReplySentCallback([method, queue_wait, execution, serialization_start = SteadyClock::now()](SteadyClock::time_point handed_over) {
+            const auto serialization{std::chrono::duration_cast<std::chrono::microseconds>(handed_over - serialization_start)};
+            const auto send{std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - handed_over)};
+            RecordRPCPhaseTime(method, RPCPhase::SERIALIZATION, serialization);
+            RecordRPCPhaseTime(method, RPCPhase::SEND, send);
+            TRACEPOINT(rpc, request_served,
+                method.c_str(),
+                count_microseconds(queue_wait),
+                count_microseconds(execution),
+                count_microseconds(serialization),
+                count_microseconds(send)
+            );
+        });
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, reply.write() + "\n");
+        req->WriteJSONReply(HTTP_OK, reply);
     } catch (UniValue& e) {
         JSONErrorReply(req, std::move(e), jreq);
         return false;
@@ -334,8 +473,10 @@ bool StartHTTPRPC(const std::any& context)
     if (!InitRPCAuthentication())
         return false;
 
+    g_batch_helpers = std::max<int64_t>(gArgs.GetIntArg("-rpcthreads", DEFAULT_HTTP_THREADS), 1) - 1;
+
     auto handle_rpc = [context](HTTPRequest* req, const std::string&) { return HTTPReq_JSONRPC(context, req); };
-    RegisterHTTPHandler("/", true, handle_rpc);
+    RegisterHTTPHandler("/", true, handle_rpc, ClassifyJSONRPCRequest);
     if (g_wallet_init_interface.HasWalletSupport()) {
         RegisterHTTPHandler("/wallet/", false, handle_rpc);
     }
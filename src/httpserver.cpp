@@ -2,6 +2,8 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <bitcoin-build-config.h> // IWYU pragma: keep
+
 #include <httpserver.h>
 
 #include <chainparamsbase.h>
@@ -14,21 +16,34 @@
 #include <rpc/protocol.h>
 #include <sync.h>
 #include <util/check.h>
+#include <util/fs.h>
 #include <util/signalinterrupt.h>
+#include <util/sock.h>
 #include <util/strencodings.h>
 #include <util/threadnames.h>
+#include <util/time.h>
 #include <util/translation.h>
 
+#include <univalue.h>
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
 #include <condition_variable>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <deque>
+#include <functional>
+#include <future>
 #include <memory>
 #include <optional>
 #include <span>
 #include <string>
 #include <thread>
 #include <unordered_map>
+#include <utility>
 #include <vector>
 
 #include <sys/types.h>
@@ -44,6 +59,10 @@
 
 #include <support/events.h>
 
+#ifdef HAVE_SOCKADDR_UN
+#include <sys/un.h>
+#endif
+
 using common::InvalidPortErrMsg;
 
 /** Maximum size of http request (request line + headers) */
@@ -69,16 +88,39 @@ private:
     HTTPRequestHandler func;
 };
 
+/** Work item running an arbitrary function, see EnqueueHTTPWork() */
+class HTTPFunctionWorkItem final : public HTTPClosure
+{
+public:
+    explicit HTTPFunctionWorkItem(std::function<void()> func) : m_func(std::move(func)) {}
+    void operator()() override
+    {
+        m_func();
+    }
+
+private:
+    std::function<void()> m_func;
+};
+
 /** Simple work queue for distributing work over multiple threads.
  * Work items are simply callable objects.
+ *
+ * There is one queue of items for each priority. Workers take the oldest item
+ * of the highest priority waiting, so HIGH items do not wait behind NORMAL ones.
  */
 template <typename WorkItem>
 class WorkQueue
 {
 private:
+    struct QueuedItem {
+        std::unique_ptr<WorkItem> item;
+        SteadyClock::time_point enqueued;
+    };
+
     Mutex cs;
     std::condition_variable cond GUARDED_BY(cs);
-    std::deque<std::unique_ptr<WorkItem>> queue GUARDED_BY(cs);
+    std::array<std::deque<QueuedItem>, NUM_HTTP_PRIORITIES> m_queues GUARDED_BY(cs);
+    std::array<HTTPWorkQueueStats, NUM_HTTP_PRIORITIES> m_stats GUARDED_BY(cs){};
     bool running GUARDED_BY(cs){true};
     const size_t maxDepth;
 
@@ -90,13 +132,15 @@ public:
      */
     ~WorkQueue() = default;
     /** Enqueue a work item */
-    bool Enqueue(WorkItem* item) EXCLUSIVE_LOCKS_REQUIRED(!cs)
+    bool Enqueue(WorkItem* item, HTTPPriority priority = HTTPPriority::NORMAL) EXCLUSIVE_LOCKS_REQUIRED(!cs)
     {
+        const auto p{static_cast<size_t>(priority)};
         LOCK(cs);
-        if (!running || queue.size() >= maxDepth) {
+        if (!running || m_queues[p].size() >= maxDepth) {
+            ++m_stats[p].rejected;
             return false;
         }
-        queue.emplace_back(std::unique_ptr<WorkItem>(item));
+        m_queues[p].push_back({std::unique_ptr<WorkItem>(item), SteadyClock::now()});
         cond.notify_one();
         return true;
     }
@@ -107,12 +151,23 @@ public:
             std::unique_ptr<WorkItem> i;
             {
                 WAIT_LOCK(cs, lock);
-                while (running && queue.empty())
+                const auto any_queued{[&]() EXCLUSIVE_LOCKS_REQUIRED(cs) {
+                    return std::ranges::any_of(m_queues, [](const auto& queue) { return !queue.empty(); });
+                }};
+                while (running && !any_queued())
                     cond.wait(lock);
-                if (!running && queue.empty())
+                if (!running && !any_queued())
                     break;
-                i = std::move(queue.front());
-                queue.pop_front();
+                size_t p{0};
+                while (m_queues[p].empty()) ++p;
+                QueuedItem& queued{m_queues[p].front()};
+                HTTPWorkQueueStats& stats{m_stats[p]};
+                const auto wait{std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - queued.enqueued)};
+                ++stats.processed;
+                stats.total_wait += wait;
+                stats.max_wait = std::max(stats.max_wait, wait);
+                i = std::move(queued.item);
+                m_queues[p].pop_front();
             }
             (*i)();
         }
@@ -124,17 +179,28 @@ public:
         running = false;
         cond.notify_all();
     }
+    /** Return the counters for each priority */
+    std::vector<HTTPWorkQueueStats> GetStats() EXCLUSIVE_LOCKS_REQUIRED(!cs)
+    {
+        LOCK(cs);
+        std::vector<HTTPWorkQueueStats> stats{m_stats.begin(), m_stats.end()};
+        for (size_t p{0}; p < NUM_HTTP_PRIORITIES; ++p) stats[p].queued = m_queues[p].size();
+        return stats;
+    }
 };
 
 struct HTTPPathHandler
 {
-    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler):
-        prefix(_prefix), exactMatch(_exactMatch), handler(_handler)
+    HTTPPathHandler(std::string _prefix, bool _exactMatch, HTTPRequestHandler _handler, HTTPPriority _priority, HTTPPriorityClassifier _classify = {}):
+        prefix(_prefix), exactMatch(_exactMatch), handler(_handler), priority(_priority), classify(_classify)
     {
     }
     std::string prefix;
     bool exactMatch;
     HTTPRequestHandler handler;
+    HTTPPriority priority;
+    //! If set, chooses the priority of each request instead of priority
+    HTTPPriorityClassifier classify;
 };
 
 /** HTTP module state */
@@ -152,6 +218,8 @@ static GlobalMutex g_httppathhandlers_mutex;
 static std::vector<HTTPPathHandler> pathHandlers GUARDED_BY(g_httppathhandlers_mutex);
 //! Bound listening sockets
 static std::vector<evhttp_bound_socket *> boundSockets;
+//! Paths of the bound unix domain sockets, removed when stopping
+static std::vector<fs::path> g_unix_socket_paths;
 
 /**
  * @brief Helps keep track of open `evhttp_connection`s with active `evhttp_requests`
@@ -208,6 +276,24 @@ public:
 //! Track active requests
 static HTTPRequestTracker g_requests;
 
+/** A reply handed to the event loop thread, see HTTPRequest::SetReplySentCallback(). */
+struct TimedReply {
+    const evhttp_connection* conn;
+    SteadyClock::time_point handed_over;
+    std::function<void(SteadyClock::time_point)> callback;
+};
+//! Replies being sent that have a callback. Only accessed from the event loop thread.
+static std::unordered_map<const evhttp_request*, TimedReply> g_timed_replies;
+
+/** Start timing the sending of a reply, call before passing it to libevent. */
+static void TimeReplySending(evhttp_request* req, SteadyClock::time_point handed_over, std::function<void(SteadyClock::time_point)> callback)
+{
+    // Without a connection libevent frees the request right away, and never completes it
+    const evhttp_connection* conn{evhttp_request_get_connection(req)};
+    if (!callback || !conn) return;
+    g_timed_replies.insert_or_assign(req, TimedReply{conn, handed_over, std::move(callback)});
+}
+
 /** Check if a network address is allowed to access the HTTP server */
 static bool ClientAllowed(const CNetAddr& netaddr)
 {
@@ -219,6 +305,20 @@ static bool ClientAllowed(const CNetAddr& netaddr)
     return false;
 }
 
+/** Check if a connection was accepted on one of the unix domain sockets */
+static bool IsUnixSocketConnection(evhttp_connection* conn)
+{
+#ifdef HAVE_SOCKADDR_UN
+    bufferevent* bev{conn ? evhttp_connection_get_bufferevent(conn) : nullptr};
+    if (!bev) return false;
+    struct sockaddr_storage addr;
+    socklen_t len{sizeof(addr)};
+    return getsockname(bufferevent_getfd(bev), (struct sockaddr*)&addr, &len) == 0 && addr.ss_family == AF_UNIX;
+#else
+    return false;
+#endif
+}
+
 /** Initialize ACL list for HTTP server */
 static bool InitHTTPAllowList()
 {
@@ -269,12 +369,19 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
         g_requests.AddRequest(req);
         evhttp_request_set_on_complete_cb(req, [](struct evhttp_request* req, void*) {
             g_requests.RemoveRequest(req);
+            if (auto node{g_timed_replies.extract(req)}) {
+                node.mapped().callback(node.mapped().handed_over);
+            }
         }, nullptr);
         evhttp_connection_set_closecb(conn, [](evhttp_connection* conn, void* arg) {
             g_requests.RemoveConnection(conn);
+            std::erase_if(g_timed_replies, [conn](const auto& entry) { return entry.second.conn == conn; });
         }, nullptr);
     }
 
+    // libevent only parses the next request on a connection once the reply to this one has been
+    // sent, so the pipelined requests of a client are served one at a time and answered in order.
+
     // Disable reading to work around a libevent bug, fixed in 2.1.9
     // See https://github.com/libevent/libevent/commit/5ff8eb26371c4dc56f384b2de35bea2d87814779
     // and https://github.com/bitcoin/bitcoin/pull/11593.
@@ -288,8 +395,9 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
     }
     auto hreq{std::make_unique<HTTPRequest>(req, *static_cast<const util::SignalInterrupt*>(arg))};
 
-    // Early address-based allow check
-    if (!ClientAllowed(hreq->GetPeer())) {
+    // Early address-based allow check. Access to unix domain sockets is
+    // controlled by their file permissions instead.
+    if (!ClientAllowed(hreq->GetPeer()) && !IsUnixSocketConnection(conn)) {
         LogDebug(BCLog::HTTP, "HTTP request from %s rejected: Client network is not allowed RPC access\n",
                  hreq->GetPeer().ToStringAddrPort());
         hreq->WriteReply(HTTP_FORBIDDEN);
@@ -327,9 +435,10 @@ static void http_request_cb(struct evhttp_request* req, void* arg)
 
     // Dispatch to worker thread
     if (i != iend) {
+        const HTTPPriority priority{i->classify ? i->classify(*hreq) : i->priority};
         std::unique_ptr<HTTPWorkItem> item(new HTTPWorkItem(std::move(hreq), path, i->handler));
         assert(g_work_queue);
-        if (g_work_queue->Enqueue(item.get())) {
+        if (g_work_queue->Enqueue(item.get(), priority)) {
             item.release(); /* if true, queue took ownership */
         } else {
             LogPrintf("WARNING: request rejected because http work queue depth exceeded, it can be increased with the -rpcworkqueue= setting\n");
@@ -357,28 +466,85 @@ static void ThreadHTTP(struct event_base* base)
     LogDebug(BCLog::HTTP, "Exited http event loop\n");
 }
 
+#ifdef HAVE_SOCKADDR_UN
+/** Listen for HTTP requests on a unix domain socket at path */
+static evhttp_bound_socket* HTTPBindUnixSocket(struct evhttp* http, const fs::path& path)
+{
+    const std::string path_str{fs::PathToString(path)};
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    if (path_str.size() >= sizeof(addr.sun_path)) {
+        LogError("Unix socket path %s is too long\n", path_str);
+        return nullptr;
+    }
+    memcpy(addr.sun_path, path_str.c_str(), path_str.size());
+
+    // Replace a socket left behind by an unclean shutdown, but nothing else
+    std::error_code ec;
+    if (fs::symlink_status(path, ec).type() == fs::file_type::socket) fs::remove(path, ec);
+
+    const evutil_socket_t fd{socket(AF_UNIX, SOCK_STREAM, 0)};
+    if (fd < 0) return nullptr;
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == SOCKET_ERROR || listen(fd, SOMAXCONN) == SOCKET_ERROR ||
+        evutil_make_socket_nonblocking(fd) != 0 || evutil_make_socket_closeonexec(fd) != 0) {
+        LogError("Unable to listen on unix socket %s: %s\n", path_str, NetworkErrorString(WSAGetLastError()));
+        evutil_closesocket(fd);
+        return nullptr;
+    }
+    // libevent takes ownership of fd and closes it in evhttp_del_accept_socket
+    evhttp_bound_socket* bind_handle{evhttp_accept_socket_with_handle(http, fd)};
+    if (!bind_handle) {
+        evutil_closesocket(fd);
+        fs::remove(path, ec);
+        return nullptr;
+    }
+    g_unix_socket_paths.push_back(path);
+    return bind_handle;
+}
+#endif
+
 /** Bind HTTP server to specified addresses */
 static bool HTTPBindAddresses(struct evhttp* http)
 {
     uint16_t http_port{static_cast<uint16_t>(gArgs.GetIntArg("-rpcport", BaseParams().RPCPort()))};
     std::vector<std::pair<std::string, uint16_t>> endpoints;
+    std::vector<std::string> rpc_bind;
+
+    // Unix domain sockets are only reachable from this machine, with access
+    // controlled by their file permissions, so they do not need -rpcallowip.
+    for (const std::string& strRPCBind : gArgs.GetArgs("-rpcbind")) {
+#ifdef HAVE_SOCKADDR_UN
+        if (strRPCBind.starts_with(ADDR_PREFIX_UNIX)) {
+            const fs::path path{AbsPathForConfigVal(gArgs, fs::PathFromString(strRPCBind.substr(ADDR_PREFIX_UNIX.length())))};
+            LogInfo("Binding RPC on unix socket %s", fs::PathToString(path));
+            if (evhttp_bound_socket* bind_handle{HTTPBindUnixSocket(http, path)}) {
+                boundSockets.push_back(bind_handle);
+            } else {
+                LogPrintf("Binding RPC on unix socket %s failed.\n", fs::PathToString(path));
+            }
+            continue;
+        }
+#endif
+        rpc_bind.push_back(strRPCBind);
+    }
 
     // Determine what addresses to bind to
     // To prevent misconfiguration and accidental exposure of the RPC
     // interface, require -rpcallowip and -rpcbind to both be specified
     // together. If either is missing, ignore both values, bind to localhost
     // instead, and log warnings.
-    if (gArgs.GetArgs("-rpcallowip").empty() || gArgs.GetArgs("-rpcbind").empty()) { // Default to loopback if not allowing external IPs
+    if (gArgs.GetArgs("-rpcallowip").empty() || rpc_bind.empty()) { // Default to loopback if not allowing external IPs
         endpoints.emplace_back("::1", http_port);
         endpoints.emplace_back("127.0.0.1", http_port);
         if (!gArgs.GetArgs("-rpcallowip").empty()) {
             LogPrintf("WARNING: option -rpcallowip was specified without -rpcbind; this doesn't usually make sense\n");
         }
-        if (!gArgs.GetArgs("-rpcbind").empty()) {
+        if (!rpc_bind.empty()) {
             LogPrintf("WARNING: option -rpcbind was ignored because -rpcallowip was not specified, refusing to allow everyone to connect\n");
         }
     } else { // Specific bind addresses
-        for (const std::string& strRPCBind : gArgs.GetArgs("-rpcbind")) {
+        for (const std::string& strRPCBind : rpc_bind) {
             uint16_t port{http_port};
             std::string host;
             if (!SplitHostPort(strRPCBind, port, host)) {
@@ -537,6 +703,11 @@ void StopHTTPServer()
         evhttp_del_accept_socket(eventHTTP, socket);
     }
     boundSockets.clear();
+    for (const fs::path& path : g_unix_socket_paths) {
+        std::error_code ec;
+        fs::remove(path, ec);
+    }
+    g_unix_socket_paths.clear();
     {
         if (const auto n_connections{g_requests.CountActiveConnections()}; n_connections != 0) {
             LogDebug(BCLog::HTTP, "Waiting for %d connections to stop HTTP server\n", n_connections);
@@ -558,6 +729,7 @@ void StopHTTPServer()
         event_base_free(eventBase);
         eventBase = nullptr;
     }
+    g_timed_replies.clear();
     g_work_queue.reset();
     LogDebug(BCLog::HTTP, "Stopped HTTP server\n");
 }
@@ -567,6 +739,21 @@ struct event_base* EventBase()
     return eventBase;
 }
 
+bool EnqueueHTTPWork(std::function<void()> func, HTTPPriority priority)
+{
+    if (!g_work_queue) return false;
+    auto item{std::make_unique<HTTPFunctionWorkItem>(std::move(func))};
+    if (!g_work_queue->Enqueue(item.get(), priority)) return false;
+    item.release(); // queue took ownership
+    return true;
+}
+
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats()
+{
+    if (!g_work_queue) return {};
+    return g_work_queue->GetStats();
+}
+
 static void httpevent_callback_fn(evutil_socket_t, short, void* data)
 {
     // Static handler: simply call inner handler
@@ -600,7 +787,11 @@ HTTPRequest::HTTPRequest(struct evhttp_request* _req, const util::SignalInterrup
 
 HTTPRequest::~HTTPRequest()
 {
-    if (!replySent) {
+    if (m_chunked_reply) {
+        // The status was already sent, so all that can be done is cutting the body short.
+        LogPrintf("%s: Unfinished chunked reply\n", __func__);
+        EndChunkedReply();
+    } else if (!replySent) {
         // Keep track of whether reply was sent to avoid request leaks
         LogPrintf("%s: Unhandled request\n", __func__);
         WriteReply(HTTP_INTERNAL_SERVER_ERROR, "Unhandled request");
@@ -639,6 +830,19 @@ std::string HTTPRequest::ReadBody()
     return rv;
 }
 
+std::optional<std::string> HTTPRequest::PeekBody(size_t max_size) const
+{
+    struct evbuffer* buf = evhttp_request_get_input_buffer(req);
+    if (!buf)
+        return "";
+    size_t size = evbuffer_get_length(buf);
+    if (size > max_size) return std::nullopt;
+    const char* data = (const char*)evbuffer_pullup(buf, size);
+    if (!data) // returns nullptr in case of empty buffer
+        return "";
+    return std::string(data, size);
+}
+
 void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
 {
     struct evkeyvalq* headers = evhttp_request_get_output_headers(req);
@@ -646,6 +850,22 @@ void HTTPRequest::WriteHeader(const std::string& hdr, const std::string& value)
     evhttp_add_header(headers, hdr.c_str(), value.c_str());
 }
 
+/** Re-enable reading from the socket once a reply was sent. This is the second part of the
+ * libevent workaround in http_request_cb.
+ */
+static void ReenableReading(evhttp_request* req)
+{
+    if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
+        evhttp_connection* conn = evhttp_request_get_connection(req);
+        if (conn) {
+            bufferevent* bev = evhttp_connection_get_bufferevent(conn);
+            if (bev) {
+                bufferevent_enable(bev, EV_READ | EV_WRITE);
+            }
+        }
+    }
+}
+
 /** Closure sent to main thread to request a reply to be sent to
  * a HTTP request.
  * Replies must be sent in the main loop in the main http thread,
@@ -662,21 +882,127 @@ void HTTPRequest::WriteReply(int nStatus, std::span<const std::byte> reply)
     assert(evb);
     evbuffer_add(evb, reply.data(), reply.size());
     auto req_copy = req;
-    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus, handed_over = SteadyClock::now(), callback = std::move(m_reply_sent_callback)]() mutable {
+        TimeReplySending(req_copy, handed_over, std::move(callback));
         evhttp_send_reply(req_copy, nStatus, nullptr, nullptr);
-        // Re-enable reading from the socket. This is the second part of the libevent
-        // workaround above.
-        if (event_get_version_number() >= 0x02010600 && event_get_version_number() < 0x02010900) {
+        ReenableReading(req_copy);
+    });
+    ev->trigger(nullptr);
+    replySent = true;
+    req = nullptr; // transferred back to main thread
+}
+
+void HTTPRequest::WriteJSONReply(int nStatus, const UniValue& reply)
+{
+    bool replied{false};
+    // Set once the client is gone, after which the rest of the serialization is dropped.
+    bool abandoned{false};
+    reply.writeChunked([&](std::string_view chunk) {
+        if (abandoned) return;
+        if (!m_chunked_reply && chunk.size() < HTTP_REPLY_CHUNK_SIZE) {
+            // The whole reply fit in a single piece, send it with a Content-Length.
+            WriteReply(nStatus, std::string{chunk} + "\n");
+            replied = true;
+            return;
+        }
+        if (!m_chunked_reply) {
+            StartChunkedReply(nStatus);
+        } else if (!WaitForReplyChunksSent(HTTP_REPLY_MAX_UNSENT)) {
+            abandoned = true;
+            return;
+        }
+        WriteReplyChunk(chunk);
+    }, HTTP_REPLY_CHUNK_SIZE);
+    if (!replied) {
+        if (!abandoned) WriteReplyChunk("\n");
+        EndChunkedReply();
+    }
+}
+
+/* The events below are all triggered from the worker thread handling the request, and libevent
+ * runs active events of the same priority in the order they were activated, so the parts of a
+ * chunked reply are sent in order.
+ */
+void HTTPRequest::StartChunkedReply(int nStatus)
+{
+    assert(!replySent && !m_chunked_reply && req);
+    if (m_interrupt) {
+        WriteHeader("Connection", "close");
+    }
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, nStatus]{
+        evhttp_send_reply_start(req_copy, nStatus, nullptr);
+    });
+    ev->trigger(nullptr);
+    m_chunked_reply = true;
+}
+
+void HTTPRequest::WriteReplyChunk(std::span<const std::byte> chunk)
+{
+    assert(m_chunked_reply && req);
+    if (chunk.empty()) return; // an empty chunk would end the body
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, data = std::vector<std::byte>{chunk.begin(), chunk.end()}]{
+        evbuffer* buf = evbuffer_new();
+        if (!buf) return;
+        evbuffer_add(buf, data.data(), data.size());
+        evhttp_send_reply_chunk(req_copy, buf);
+        evbuffer_free(buf);
+    });
+    ev->trigger(nullptr);
+}
+
+bool HTTPRequest::WaitForReplyChunksSent(size_t max_unsent)
+{
+    assert(m_chunked_reply && req);
+    // Poll rarely while the client is slow, and give up once it stops reading altogether.
+    std::chrono::milliseconds poll_interval{10};
+    std::optional<size_t> min_unsent;
+    auto last_progress{SteadyClock::now()};
+    while (!m_interrupt) {
+        // Ask the event loop, after the chunks queued so far, how much output the connection has
+        // buffered. Once the client disconnected, libevent detaches the request from it.
+        auto unsent{std::make_shared<std::promise<std::optional<size_t>>>()};
+        auto unsent_future{unsent->get_future()};
+        auto req_copy = req;
+        HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, unsent]{
             evhttp_connection* conn = evhttp_request_get_connection(req_copy);
-            if (conn) {
-                bufferevent* bev = evhttp_connection_get_bufferevent(conn);
-                if (bev) {
-                    bufferevent_enable(bev, EV_READ | EV_WRITE);
-                }
-            }
+            if (!conn) return unsent->set_value(std::nullopt);
+            unsent->set_value(evbuffer_get_length(bufferevent_get_output(evhttp_connection_get_bufferevent(conn))));
+        });
+        ev->trigger(nullptr);
+        while (unsent_future.wait_for(std::chrono::milliseconds{100}) != std::future_status::ready) {
+            if (m_interrupt) return false;
+        }
+        const auto n_unsent{unsent_future.get()};
+        if (!n_unsent) return false;
+        if (*n_unsent <= max_unsent) return true;
+        const auto now{SteadyClock::now()};
+        if (!min_unsent || *n_unsent < *min_unsent) {
+            min_unsent = n_unsent;
+            last_progress = now;
+        } else if (now - last_progress > HTTP_REPLY_STALL_TIMEOUT) {
+            LogDebug(BCLog::HTTP, "Giving up on reply to %s, nothing was sent for %d seconds\n",
+                     GetPeer().ToStringAddrPort(), count_seconds(HTTP_REPLY_STALL_TIMEOUT));
+            return false;
         }
+        UninterruptibleSleep(poll_interval);
+        poll_interval = std::min(poll_interval * 2, std::chrono::milliseconds{100});
+    }
+    return false;
+}
+
+void HTTPRequest::EndChunkedReply()
+{
+    assert(m_chunked_reply && req);
+    auto req_copy = req;
+    HTTPEvent* ev = new HTTPEvent(eventBase, true, [req_copy, handed_over = SteadyClock::now(), callback = std::move(m_reply_sent_callback)]() mutable {
+        TimeReplySending(req_copy, handed_over, std::move(callback));
+        evhttp_send_reply_end(req_copy);
+        ReenableReading(req_copy);
     });
     ev->trigger(nullptr);
+    m_chunked_reply = false;
     replySent = true;
     req = nullptr; // transferred back to main thread
 }
@@ -756,11 +1082,18 @@ std::optional<std::string> GetQueryParameterFromUri(const char* uri, const std::
     return result;
 }
 
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler)
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, HTTPPriority priority)
+{
+    LogDebug(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
+    LOCK(g_httppathhandlers_mutex);
+    pathHandlers.emplace_back(prefix, exactMatch, handler, priority);
+}
+
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler, const HTTPPriorityClassifier &classify)
 {
     LogDebug(BCLog::HTTP, "Registering HTTP handler for %s (exactmatch %d)\n", prefix, exactMatch);
     LOCK(g_httppathhandlers_mutex);
-    pathHandlers.emplace_back(prefix, exactMatch, handler);
+    pathHandlers.emplace_back(prefix, exactMatch, handler, HTTPPriority::NORMAL, classify);
 }
 
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch)
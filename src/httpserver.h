@@ -5,10 +5,17 @@
 #ifndef BITCOIN_HTTPSERVER_H
 #define BITCOIN_HTTPSERVER_H
 
+#include <util/time.h>
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
 #include <optional>
 #include <span>
 #include <string>
+#include <utility>
+#include <vector>
 
 namespace util {
 class SignalInterrupt;
@@ -20,17 +27,25 @@ class SignalInterrupt;
 static const int DEFAULT_HTTP_THREADS=16;
 
 /**
- * The default value for `-rpcworkqueue`. This is the maximum depth of the work queue,
- * we don't allocate this number of work queue items upfront.
+ * The default value for `-rpcworkqueue`. This is the maximum depth of the work queue
+ * for each HTTPPriority, we don't allocate this number of work queue items upfront.
  */
 static const int DEFAULT_HTTP_WORKQUEUE=64;
 
 static const int DEFAULT_HTTP_SERVER_TIMEOUT=30;
 
+/** Size of the pieces HTTPRequest::WriteJSONReply() sends large replies in. */
+static constexpr size_t HTTP_REPLY_CHUNK_SIZE{256 * 1024};
+/** Time without progress after which HTTPRequest::WaitForReplyChunksSent() gives up on a client. */
+static constexpr std::chrono::seconds HTTP_REPLY_STALL_TIMEOUT{30};
+/** Bytes of a JSON reply HTTPRequest::WriteJSONReply() lets wait for a slow client before serializing more. */
+static constexpr size_t HTTP_REPLY_MAX_UNSENT{4 * HTTP_REPLY_CHUNK_SIZE};
+
 struct evhttp_request;
 struct event_base;
 class CService;
 class HTTPRequest;
+class UniValue;
 
 /** Initialize HTTP server.
  * Call this before RegisterHTTPHandler or EventBase().
@@ -49,13 +64,29 @@ void StopHTTPServer();
 /** Change logging level for libevent. */
 void UpdateHTTPServerLogging(bool enable);
 
+/** Scheduling class of work for the HTTP worker threads. */
+enum class HTTPPriority {
+    HIGH,   //!< Cheap to serve, taken by workers before any waiting NORMAL work
+    NORMAL,
+};
+static constexpr size_t NUM_HTTP_PRIORITIES{2};
+
 /** Handler for requests to a certain HTTP path */
 typedef std::function<bool(HTTPRequest* req, const std::string &)> HTTPRequestHandler;
+/** Function choosing the priority of a request for a certain HTTP path from its contents */
+typedef std::function<HTTPPriority(const HTTPRequest& req)> HTTPPriorityClassifier;
 /** Register handler for prefix.
  * If multiple handlers match a prefix, the first-registered one will
- * be invoked.
+ * be invoked. Requests for the prefix are queued for the worker threads
+ * with the given priority.
+ */
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler,
+                         HTTPPriority priority = HTTPPriority::NORMAL);
+/** Register handler for prefix, queueing each request with the priority classify
+ * returns for it. The classifier runs on the event loop thread, so it has to be cheap.
  */
-void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler);
+void RegisterHTTPHandler(const std::string &prefix, bool exactMatch, const HTTPRequestHandler &handler,
+                         const HTTPPriorityClassifier &classify);
 /** Unregister handler for prefix */
 void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
 
@@ -64,6 +95,30 @@ void UnregisterHTTPHandler(const std::string &prefix, bool exactMatch);
  */
 struct event_base* EventBase();
 
+/** Run a function on one of the HTTP worker threads, behind the requests
+ * already waiting for one. Returns false if the work queue is full or the
+ * server is shutting down, in which case the function is not run.
+ */
+bool EnqueueHTTPWork(std::function<void()> func, HTTPPriority priority = HTTPPriority::NORMAL);
+
+/** Counters of the HTTP work queue for one priority. */
+struct HTTPWorkQueueStats {
+    //! Work items waiting for a worker thread
+    size_t queued{0};
+    //! Work items taken by a worker thread since startup
+    uint64_t processed{0};
+    //! Work items rejected since startup because -rpcworkqueue of them were already waiting
+    uint64_t rejected{0};
+    //! Sum and maximum of the time processed work items waited for a worker thread
+    std::chrono::microseconds total_wait{0};
+    std::chrono::microseconds max_wait{0};
+};
+
+/** Return the work queue counters for each HTTPPriority, or nothing if the
+ * HTTP server was not initialized.
+ */
+std::vector<HTTPWorkQueueStats> GetHTTPWorkQueueStats();
+
 /** In-flight HTTP request.
  * Thin C++ wrapper around evhttp_request.
  */
@@ -73,6 +128,12 @@ private:
     struct evhttp_request* req;
     const util::SignalInterrupt& m_interrupt;
     bool replySent;
+    //! Whether StartChunkedReply() was called and EndChunkedReply() was not yet
+    bool m_chunked_reply{false};
+    //! When the request was read and handed to the HTTP server
+    const SteadyClock::time_point m_received{SteadyClock::now()};
+    //! See SetReplySentCallback()
+    std::function<void(SteadyClock::time_point)> m_reply_sent_callback;
 
 public:
     explicit HTTPRequest(struct evhttp_request* req, const util::SignalInterrupt& interrupt, bool replySent = false);
@@ -98,6 +159,22 @@ public:
      */
     RequestMethod GetRequestMethod() const;
 
+    /** Get the time the request was received, before it waited for a worker thread.
+     */
+    SteadyClock::time_point GetReceivedTime() const { return m_received; }
+
+    /**
+     * Set a function to call once the reply has been fully written to the connection, with the
+     * time it was handed to the event loop thread. It is called on that thread, and not at all if
+     * the client disconnects before that.
+     *
+     * @note Call this before sending the reply.
+     */
+    void SetReplySentCallback(std::function<void(SteadyClock::time_point)> callback)
+    {
+        m_reply_sent_callback = std::move(callback);
+    }
+
     /** Get the query parameter value from request uri for a specified key, or std::nullopt if the
      * key is not found.
      *
@@ -123,6 +200,12 @@ public:
      */
     std::string ReadBody();
 
+    /**
+     * Return a copy of the request body without consuming it, or nothing if it is
+     * larger than max_size bytes.
+     */
+    std::optional<std::string> PeekBody(size_t max_size) const;
+
     /**
      * Write output header.
      *
@@ -143,6 +226,45 @@ public:
         WriteReply(nStatus, std::as_bytes(std::span{reply}));
     }
     void WriteReply(int nStatus, std::span<const std::byte> reply);
+
+    /**
+     * Write a reply with the serialized JSON value as body, followed by a newline. Large values are
+     * serialized piece by piece into a chunked reply (see StartChunkedReply()), pausing while more
+     * than HTTP_REPLY_MAX_UNSENT bytes wait to be sent, so that the full serialization is never
+     * held in memory at once. If the client disconnects, the rest of the body is dropped.
+     *
+     * @note Can be called only once, like WriteReply().
+     */
+    void WriteJSONReply(int nStatus, const UniValue& reply);
+
+    /**
+     * Start an HTTP reply whose body is sent in pieces with chunked transfer encoding, as it is
+     * produced, instead of at once. Write the body with WriteReplyChunk() and finish with
+     * EndChunkedReply(). The status cannot be changed after this, so only start a chunked reply
+     * once nothing can fail anymore.
+     *
+     * @note Like WriteReply(), this can be called only once, and instead of it. Headers must be
+     * written before.
+     */
+    void StartChunkedReply(int nStatus);
+    /** Send the next piece of the body of a reply started with StartChunkedReply(). */
+    void WriteReplyChunk(std::string_view chunk)
+    {
+        WriteReplyChunk(std::as_bytes(std::span{chunk}));
+    }
+    void WriteReplyChunk(std::span<const std::byte> chunk);
+    /**
+     * Wait until at most max_unsent bytes of the chunks written so far still have to be sent to
+     * the client, so that a reply produced faster than the client reads it does not pile up in
+     * memory. Returns false if the client disconnected, read nothing for HTTP_REPLY_STALL_TIMEOUT,
+     * or the server is shutting down, in which case the rest of the body can be skipped.
+     */
+    bool WaitForReplyChunksSent(size_t max_unsent);
+    /**
+     * Finish a reply started with StartChunkedReply(). As this gives the request back to the main
+     * thread, do not call any other HTTPRequest methods after calling this.
+     */
+    void EndChunkedReply();
 };
 
 /** Get the query parameter value from request uri for a specified key, or std::nullopt if the key
@@ -0,0 +1,269 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <index/scriptpubkeyindex.h>
+
+#include <coins.h>
+#include <common/args.h>
+#include <crypto/sha256.h>
+#include <dbwrapper.h>
+#include <interfaces/chain.h>
+#include <logging.h>
+#include <primitives/block.h>
+#include <primitives/transaction.h>
+#include <script/script.h>
+#include <serialize.h>
+#include <undo.h>
+#include <util/check.h>
+#include <util/fs.h>
+
+#include <ios>
+#include <utility>
+#include <vector>
+
+static constexpr uint8_t DB_SCRIPTPUBKEY{'s'};
+static constexpr uint8_t DB_BLOCK_UNDO{'u'};
+
+std::unique_ptr<ScriptPubKeyIndex> g_scriptpubkeyindex;
+
+namespace {
+
+/** Hash of an output script, under which its outputs are stored */
+uint256 ScriptHash(const CScript& script)
+{
+    uint256 hash;
+    CSHA256().Write(script.data(), script.size()).Finalize(hash.begin());
+    return hash;
+}
+
+struct DBKey {
+    uint256 script_hash;
+    COutPoint outpoint;
+
+    SERIALIZE_METHODS(DBKey, obj) {
+        uint8_t prefix{DB_SCRIPTPUBKEY};
+        READWRITE(prefix);
+        if (prefix != DB_SCRIPTPUBKEY) {
+            throw std::ios_base::failure("Invalid format for scriptpubkey index DB key");
+        }
+
+        READWRITE(obj.script_hash, obj.outpoint);
+    }
+};
+
+/** Key of the undo record of the block at a height, ordered by height */
+struct DBUndoKey {
+    int height;
+
+    explicit DBUndoKey(int height_in) : height(height_in) {}
+
+    template <typename Stream>
+    void Serialize(Stream& s) const
+    {
+        ser_writedata8(s, DB_BLOCK_UNDO);
+        ser_writedata32be(s, height);
+    }
+
+    template <typename Stream>
+    void Unserialize(Stream& s)
+    {
+        const uint8_t prefix{ser_readdata8(s)};
+        if (prefix != DB_BLOCK_UNDO) {
+            throw std::ios_base::failure("Invalid format for scriptpubkey index DB undo key");
+        }
+        height = ser_readdata32be(s);
+    }
+};
+
+/**
+ * The changes a block made to the index, written in the same batch as them. Records of
+ * blocks above the committed best block let the index roll back changes that were written
+ * but not committed before an unclean shutdown, as the chain may not contain these blocks
+ * anymore on restart.
+ */
+struct BlockUndoRecord {
+    uint256 block_hash{};
+    std::vector<DBKey> created{};
+    std::vector<std::pair<DBKey, Coin>> spent{};
+
+    SERIALIZE_METHODS(BlockUndoRecord, obj) { READWRITE(obj.block_hash, obj.created, obj.spent); }
+};
+
+} // namespace
+
+ScriptPubKeyIndex::ScriptPubKeyIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory, bool f_wipe)
+    : BaseIndex(std::move(chain), "scriptpubkeyindex")
+{
+    fs::path path{gArgs.GetDataDirNet() / "indexes" / "scriptpubkeyindex"};
+    fs::create_directories(path);
+
+    m_db = std::make_unique<ScriptPubKeyIndex::DB>(path / "db", n_cache_size, f_memory, f_wipe);
+}
+
+interfaces::Chain::NotifyOptions ScriptPubKeyIndex::CustomOptions()
+{
+    interfaces::Chain::NotifyOptions options;
+    options.connect_undo_data = true;
+    options.disconnect_data = true;
+    options.disconnect_undo_data = true;
+    return options;
+}
+
+bool ScriptPubKeyIndex::CustomInit(const std::optional<interfaces::BlockRef>& block)
+{
+    // Roll back the blocks written after the committed best block, newest first. Each one is
+    // rolled back in a batch that also erases its record, so an interrupted rollback can simply
+    // be continued.
+    std::vector<int> heights;
+    {
+        std::unique_ptr<CDBIterator> db_it{m_db->NewIterator()};
+        for (db_it->Seek(DBUndoKey{block ? block->height + 1 : 0}); db_it->Valid(); db_it->Next()) {
+            DBUndoKey key{0};
+            if (!db_it->GetKey(key)) break;
+            heights.push_back(key.height);
+        }
+    }
+    if (!heights.empty()) {
+        LogInfo("Rolling back %u uncommitted blocks of %s", heights.size(), GetName());
+    }
+    for (auto height{heights.rbegin()}; height != heights.rend(); ++height) {
+        BlockUndoRecord record;
+        if (!m_db->Read(DBUndoKey{*height}, record)) {
+            LogError("Cannot read undo record of %s at height %d", GetName(), *height);
+            return false;
+        }
+        // Writing the spent coins before erasing the created outputs also drops outputs
+        // created and spent within the block.
+        CDBBatch batch(*m_db);
+        for (const auto& [key, coin] : record.spent) batch.Write(key, coin);
+        for (const DBKey& key : record.created) batch.Erase(key);
+        batch.Erase(DBUndoKey{*height});
+        if (!m_db->WriteBatch(batch)) return false;
+    }
+
+    LOCK(m_mutex);
+    m_best_block = block;
+    return true;
+}
+
+bool ScriptPubKeyIndex::CustomCommit(CDBBatch& batch)
+{
+    // The records of committed blocks are not needed anymore
+    const auto best_block{WITH_LOCK(m_mutex, return m_best_block)};
+    if (!best_block) return true;
+    std::unique_ptr<CDBIterator> db_it{m_db->NewIterator()};
+    for (db_it->Seek(DBUndoKey{0}); db_it->Valid(); db_it->Next()) {
+        DBUndoKey key{0};
+        if (!db_it->GetKey(key) || key.height > best_block->height) break;
+        batch.Erase(key);
+    }
+    return true;
+}
+
+bool ScriptPubKeyIndex::CustomAppend(const interfaces::BlockInfo& block)
+{
+    CDBBatch batch(*m_db);
+    BlockUndoRecord record{.block_hash = block.hash};
+
+    // Exclude genesis block transaction because outputs are not spendable.
+    if (block.height > 0) {
+        assert(block.data);
+        for (size_t i = 0; i < block.data->vtx.size(); ++i) {
+            const auto& tx{block.data->vtx.at(i)};
+
+            // The coinbase tx has no undo data since no former output is spent
+            if (!tx->IsCoinBase()) {
+                const auto& tx_undo{Assert(block.undo_data)->vtxundo.at(i - 1)};
+                for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+                    const Coin& coin{tx_undo.vprevout[j]};
+                    DBKey key{ScriptHash(coin.out.scriptPubKey), tx->vin[j].prevout};
+                    batch.Erase(key);
+                    record.spent.emplace_back(std::move(key), coin);
+                }
+            }
+
+            // Like the UTXO set, skip outputs that can never be spent
+            for (uint32_t j = 0; j < tx->vout.size(); ++j) {
+                const CTxOut& out{tx->vout[j]};
+                if (out.scriptPubKey.IsUnspendable()) continue;
+                DBKey key{ScriptHash(out.scriptPubKey), COutPoint{tx->GetHash(), j}};
+                batch.Write(key, Coin{out, block.height, tx->IsCoinBase()});
+                record.created.push_back(std::move(key));
+            }
+        }
+    }
+    batch.Write(DBUndoKey{block.height}, record);
+
+    LOCK(m_mutex);
+    if (!m_db->WriteBatch(batch)) return false;
+    m_best_block = interfaces::BlockRef{block.hash, block.height};
+    return true;
+}
+
+bool ScriptPubKeyIndex::CustomRemove(const interfaces::BlockInfo& block)
+{
+    CDBBatch batch(*m_db);
+    const uint256& prev_hash{*Assert(block.prev_hash)};
+
+    // Undo the transactions in reverse order, so that outputs created and spent
+    // within the block end up removed
+    assert(block.data);
+    assert(block.undo_data);
+    for (size_t i = block.data->vtx.size(); i-- > 0;) {
+        const auto& tx{block.data->vtx.at(i)};
+
+        for (uint32_t j = 0; j < tx->vout.size(); ++j) {
+            const CTxOut& out{tx->vout[j]};
+            if (out.scriptPubKey.IsUnspendable()) continue;
+            batch.Erase(DBKey{ScriptHash(out.scriptPubKey), COutPoint{tx->GetHash(), j}});
+        }
+
+        // The coinbase tx has no undo data since no former output is spent
+        if (!tx->IsCoinBase()) {
+            const auto& tx_undo{block.undo_data->vtxundo.at(i - 1)};
+            for (size_t j = 0; j < tx_undo.vprevout.size(); ++j) {
+                const Coin& coin{tx_undo.vprevout[j]};
+                batch.Write(DBKey{ScriptHash(coin.out.scriptPubKey), tx->vin[j].prevout}, coin);
+            }
+        }
+    }
+
+    batch.Erase(DBUndoKey{block.height});
+
+    // The committed best block may be the removed one, whose changes are gone now. Move it back
+    // in the same batch, which is always safe, so that a restart does not remove it again.
+    CBlockLocator locator;
+    if (!m_chain->findBlock(prev_hash, interfaces::FoundBlock().locator(locator))) return false;
+    m_db->WriteBestBlock(batch, locator);
+
+    LOCK(m_mutex);
+    if (!m_db->WriteBatch(batch)) return false;
+    m_best_block = interfaces::BlockRef{prev_hash, block.height - 1};
+    return true;
+}
+
+bool ScriptPubKeyIndex::FindUnspentOutputs(const std::set<CScript>& scripts, std::map<COutPoint, Coin>& outputs, interfaces::BlockRef& best_block) const
+{
+    std::unique_ptr<CDBIterator> db_it;
+    {
+        // The iterator reads the database as it is when created, which matches
+        // m_best_block as long as the lock is held
+        LOCK(m_mutex);
+        if (!m_best_block) return false;
+        best_block = *m_best_block;
+        db_it.reset(m_db->NewIterator());
+    }
+
+    for (const CScript& script : scripts) {
+        const uint256 script_hash{ScriptHash(script)};
+        for (db_it->Seek(std::make_pair(DB_SCRIPTPUBKEY, script_hash)); db_it->Valid(); db_it->Next()) {
+            DBKey key;
+            if (!db_it->GetKey(key) || key.script_hash != script_hash) break;
+            Coin coin;
+            if (!db_it->GetValue(coin)) return false;
+            outputs.emplace(key.outpoint, std::move(coin));
+        }
+    }
+    return true;
+}
@@ -0,0 +1,73 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_INDEX_SCRIPTPUBKEYINDEX_H
+#define BITCOIN_INDEX_SCRIPTPUBKEYINDEX_H
+
+#include <index/base.h>
+#include <interfaces/types.h>
+#include <sync.h>
+#include <threadsafety.h>
+
+#include <map>
+#include <memory>
+#include <optional>
+#include <set>
+
+class CScript;
+class Coin;
+class COutPoint;
+
+static constexpr bool DEFAULT_SCRIPTPUBKEYINDEX{false};
+
+/**
+ * ScriptPubKeyIndex is used to look up the unspent outputs paying to an output
+ * script without scanning the whole UTXO set. The index is written to a LevelDB
+ * database and records each unspent output under the hash of its script. Outputs
+ * are removed again when they are spent, so the index only grows with the UTXO
+ * set. The changes of blocks not committed yet are kept as undo records, which
+ * are rolled back on restart.
+ */
+class ScriptPubKeyIndex final : public BaseIndex
+{
+private:
+    std::unique_ptr<BaseIndex::DB> m_db;
+
+    /// Keeps lookups consistent with the block they are reported for
+    mutable Mutex m_mutex;
+    /// The last block whose outputs were written to the database
+    std::optional<interfaces::BlockRef> m_best_block GUARDED_BY(m_mutex);
+
+    bool AllowPrune() const override { return true; }
+
+protected:
+    interfaces::Chain::NotifyOptions CustomOptions() override;
+
+    bool CustomInit(const std::optional<interfaces::BlockRef>& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    bool CustomCommit(CDBBatch& batch) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    bool CustomAppend(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    bool CustomRemove(const interfaces::BlockInfo& block) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    BaseIndex::DB& GetDB() const override { return *m_db; }
+
+public:
+    /// Constructs the index, which becomes available to be queried.
+    explicit ScriptPubKeyIndex(std::unique_ptr<interfaces::Chain> chain, size_t n_cache_size, bool f_memory = false, bool f_wipe = false);
+
+    /// Look up the unspent outputs paying to any of the given scripts.
+    ///
+    /// @param[in]   scripts  The output scripts to look for.
+    /// @param[out]  outputs  The unspent outputs paying to them are added here.
+    /// @param[out]  best_block  The block as of which the outputs are unspent.
+    /// @return  false if the index has not indexed any block yet or on a read error
+    bool FindUnspentOutputs(const std::set<CScript>& scripts, std::map<COutPoint, Coin>& outputs, interfaces::BlockRef& best_block) const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
+/// The global scriptPubKey index, used in scantxoutset and getaddressutxos. May be null.
+extern std::unique_ptr<ScriptPubKeyIndex> g_scriptpubkeyindex;
+
+#endif // BITCOIN_INDEX_SCRIPTPUBKEYINDEX_H
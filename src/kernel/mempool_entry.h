@@ -11,6 +11,7 @@
 #include <policy/policy.h>
 #include <policy/settings.h>
 #include <primitives/transaction.h>
+#include <txgraph.h>
 #include <util/epochguard.h>
 #include <util/overflow.h>
 
@@ -60,9 +61,12 @@ struct CompareIteratorByHash {
  * (m_count_with_descendants, nSizeWithDescendants, and nModFeesWithDescendants) for
  * all ancestors of the newly added transaction.
  *
+ * Each entry in the mempool is also the TxGraph::Ref for its transaction in the
+ * mempool's TxGraph, so that Ref pointers returned by the graph can be converted
+ * back into entries. Copies of an entry do not refer to any graph.
  */
 
-class CTxMemPoolEntry
+class CTxMemPoolEntry : public TxGraph::Ref
 {
 public:
     typedef std::reference_wrapper<const CTxMemPoolEntry> CTxMemPoolEntryRef;
@@ -71,7 +75,30 @@ public:
     typedef std::set<CTxMemPoolEntryRef, CompareIteratorByHash> Children;
 
 private:
-    CTxMemPoolEntry(const CTxMemPoolEntry&) = default;
+    CTxMemPoolEntry(const CTxMemPoolEntry& other)
+        : TxGraph::Ref{},
+          tx{other.tx},
+          m_parents{other.m_parents},
+          m_children{other.m_children},
+          nFee{other.nFee},
+          nTxWeight{other.nTxWeight},
+          nUsageSize{other.nUsageSize},
+          nTime{other.nTime},
+          entry_sequence{other.entry_sequence},
+          entryHeight{other.entryHeight},
+          spendsCoinbase{other.spendsCoinbase},
+          sigOpCost{other.sigOpCost},
+          m_modified_fee{other.m_modified_fee},
+          lockPoints{other.lockPoints},
+          m_count_with_descendants{other.m_count_with_descendants},
+          nSizeWithDescendants{other.nSizeWithDescendants},
+          nModFeesWithDescendants{other.nModFeesWithDescendants},
+          m_count_with_ancestors{other.m_count_with_ancestors},
+          nSizeWithAncestors{other.nSizeWithAncestors},
+          nModFeesWithAncestors{other.nModFeesWithAncestors},
+          nSigOpCostWithAncestors{other.nSigOpCostWithAncestors},
+          idx_randomized{other.idx_randomized},
+          m_epoch_marker{other.m_epoch_marker} {}
     struct ExplicitCopyTag {
         explicit ExplicitCopyTag() = default;
     };
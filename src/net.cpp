@@ -128,6 +128,33 @@ size_t CNetMessage::GetMemoryUsage() const noexcept
     return sizeof(*this) + memusage::DynamicUsage(m_type) + m_recv.GetMemoryUsage();
 }
 
+DataStream RecvBufferPool::Get() noexcept
+{
+    LOCK(m_mutex);
+    if (m_buffers.empty()) return DataStream{};
+    DataStream buffer{std::move(m_buffers.back())};
+    m_buffers.pop_back();
+    m_pooled_bytes -= buffer.GetMemoryUsage();
+    return buffer;
+}
+
+void RecvBufferPool::Put(DataStream&& buffer) noexcept
+{
+    buffer.clear();
+    const size_t usage{buffer.GetMemoryUsage()};
+    // Buffers that never allocated are not worth keeping, and large ones are freed right away.
+    if (usage <= sizeof(DataStream) || usage > sizeof(DataStream) + MAX_BUFFER_SIZE) return;
+    LOCK(m_mutex);
+    if (m_buffers.size() >= MAX_BUFFERS || m_pooled_bytes + usage > m_max_pooled_bytes) return;
+    m_pooled_bytes += usage;
+    m_buffers.push_back(std::move(buffer));
+}
+
+size_t RecvBufferPool::GetPooledBytes() const noexcept
+{
+    return WITH_LOCK(m_mutex, return m_pooled_bytes);
+}
+
 void CConnman::AddAddrFetch(const std::string& strDest)
 {
     LOCK(m_addr_fetches_mutex);
@@ -718,8 +745,8 @@ std::string CNode::DisconnectMsg(bool log_ip) const
                      LogIP(log_ip));
 }
 
-V1Transport::V1Transport(const NodeId node_id) noexcept
-    : m_magic_bytes{Params().MessageStart()}, m_node_id{node_id}
+V1Transport::V1Transport(const NodeId node_id, RecvBufferPool* recv_buffer_pool) noexcept
+    : m_magic_bytes{Params().MessageStart()}, m_node_id{node_id}, m_recv_buffer_pool{recv_buffer_pool}
 {
     LOCK(m_recv_mutex);
     Reset();
@@ -808,6 +835,7 @@ CNetMessage V1Transport::GetReceivedMessage(const std::chrono::microseconds time
     // decompose a single CNetMessage from the TransportDeserializer
     LOCK(m_recv_mutex);
     CNetMessage msg(std::move(vRecv));
+    if (m_recv_buffer_pool) vRecv = m_recv_buffer_pool->Get();
 
     // store message type string, time, and sizes
     msg.m_type = hdr.GetMessageType();
@@ -998,9 +1026,10 @@ void V2Transport::StartSendingHandshake() noexcept
     // We cannot wipe m_send_garbage as it will still be used as AAD later in the handshake.
 }
 
-V2Transport::V2Transport(NodeId nodeid, bool initiating, const CKey& key, std::span<const std::byte> ent32, std::vector<uint8_t> garbage) noexcept
+V2Transport::V2Transport(NodeId nodeid, bool initiating, const CKey& key, std::span<const std::byte> ent32, std::vector<uint8_t> garbage, RecvBufferPool* recv_buffer_pool) noexcept
     : m_cipher{key, ent32}, m_initiating{initiating}, m_nodeid{nodeid},
-      m_v1_fallback{nodeid},
+      m_recv_buffer_pool{recv_buffer_pool},
+      m_v1_fallback{nodeid, recv_buffer_pool},
       m_recv_state{initiating ? RecvState::KEY : RecvState::KEY_MAYBE_V1},
       m_send_garbage{std::move(garbage)},
       m_send_state{initiating ? SendState::AWAITING_KEY : SendState::MAYBE_V1}
@@ -1013,9 +1042,9 @@ V2Transport::V2Transport(NodeId nodeid, bool initiating, const CKey& key, std::s
     }
 }
 
-V2Transport::V2Transport(NodeId nodeid, bool initiating) noexcept
+V2Transport::V2Transport(NodeId nodeid, bool initiating, RecvBufferPool* recv_buffer_pool) noexcept
     : V2Transport{nodeid, initiating, GenerateRandomKey(),
-                  MakeByteSpan(GetRandHash()), GenerateRandomGarbage()} {}
+                  MakeByteSpan(GetRandHash()), GenerateRandomGarbage(), recv_buffer_pool} {}
 
 void V2Transport::SetReceiveState(RecvState recv_state) noexcept
 {
@@ -1459,7 +1488,7 @@ CNetMessage V2Transport::GetReceivedMessage(std::chrono::microseconds time, bool
     Assume(m_recv_state == RecvState::APP_READY);
     std::span<const uint8_t> contents{m_recv_decode_buffer};
     auto msg_type = GetMessageType(contents);
-    CNetMessage msg{DataStream{}};
+    CNetMessage msg{m_recv_buffer_pool ? m_recv_buffer_pool->Get() : DataStream{}};
     // Note that BIP324Cipher::EXPANSION also includes the length descriptor size.
     msg.m_raw_message_size = m_recv_decode_buffer.size() + BIP324Cipher::EXPANSION;
     if (msg_type) {
@@ -3783,12 +3812,12 @@ ServiceFlags CConnman::GetLocalServices() const
     return m_local_services;
 }
 
-static std::unique_ptr<Transport> MakeTransport(NodeId id, bool use_v2transport, bool inbound) noexcept
+static std::unique_ptr<Transport> MakeTransport(NodeId id, bool use_v2transport, bool inbound, RecvBufferPool& recv_buffer_pool) noexcept
 {
     if (use_v2transport) {
-        return std::make_unique<V2Transport>(id, /*initiating=*/!inbound);
+        return std::make_unique<V2Transport>(id, /*initiating=*/!inbound, &recv_buffer_pool);
     } else {
-        return std::make_unique<V1Transport>(id);
+        return std::make_unique<V1Transport>(id, &recv_buffer_pool);
     }
 }
 
@@ -3802,7 +3831,8 @@ CNode::CNode(NodeId idIn,
              ConnectionType conn_type_in,
              bool inbound_onion,
              CNodeOptions&& node_opts)
-    : m_transport{MakeTransport(idIn, node_opts.use_v2transport, conn_type_in == ConnectionType::INBOUND)},
+    : m_recv_buffer_pool{node_opts.recv_flood_size / RECV_BUFFER_POOL_FRACTION},
+      m_transport{MakeTransport(idIn, node_opts.use_v2transport, conn_type_in == ConnectionType::INBOUND, m_recv_buffer_pool)},
       m_permission_flags{node_opts.permission_flags},
       m_sock{sock},
       m_connected{GetTime<std::chrono::seconds>()},
@@ -3847,7 +3877,7 @@ void CNode::MarkReceivedMsgsForProcessing()
     LOCK(m_msg_process_queue_mutex);
     m_msg_process_queue.splice(m_msg_process_queue.end(), vRecvMsg);
     m_msg_process_queue_size += nSizeAdded;
-    fPauseRecv = m_msg_process_queue_size > m_recv_flood_size;
+    fPauseRecv = m_msg_process_queue_size + m_recv_buffer_pool.GetPooledBytes() > m_recv_flood_size;
 }
 
 std::optional<std::pair<CNetMessage, bool>> CNode::PollMessage()
@@ -3859,11 +3889,19 @@ std::optional<std::pair<CNetMessage, bool>> CNode::PollMessage()
     // Just take one message
     msgs.splice(msgs.begin(), m_msg_process_queue, m_msg_process_queue.begin());
     m_msg_process_queue_size -= msgs.front().GetMemoryUsage();
-    fPauseRecv = m_msg_process_queue_size > m_recv_flood_size;
+    fPauseRecv = m_msg_process_queue_size + m_recv_buffer_pool.GetPooledBytes() > m_recv_flood_size;
 
     return std::make_pair(std::move(msgs.front()), !m_msg_process_queue.empty());
 }
 
+void CNode::RecycleRecvBuffer(DataStream&& buffer)
+{
+    m_recv_buffer_pool.Put(std::move(buffer));
+    // Buffers held by the pool count towards the receive flood limit.
+    LOCK(m_msg_process_queue_mutex);
+    fPauseRecv = m_msg_process_queue_size + m_recv_buffer_pool.GetPooledBytes() > m_recv_flood_size;
+}
+
 bool CConnman::NodeFullyConnected(const CNode* pnode)
 {
     return pnode && pnode->fSuccessfullyConnected && !pnode->fDisconnect;
@@ -92,6 +92,8 @@ static constexpr bool DEFAULT_DNSSEED{true};
 static constexpr bool DEFAULT_FIXEDSEEDS{true};
 static const size_t DEFAULT_MAXRECEIVEBUFFER = 5 * 1000;
 static const size_t DEFAULT_MAXSENDBUFFER    = 1 * 1000;
+/** Fraction of the per-connection receive buffer (-maxreceivebuffer) that may be held by idle pooled receive buffers. */
+static constexpr size_t RECV_BUFFER_POOL_FRACTION{16};
 
 static constexpr bool DEFAULT_V2_TRANSPORT{true};
 
@@ -252,6 +254,40 @@ public:
     size_t GetMemoryUsage() const noexcept;
 };
 
+/** A per-connection pool of receive buffers.
+ *
+ * Received messages are deserialized into a fresh DataStream each, which is freed (and zeroed)
+ * once the message has been processed. Instead, the buffers of processed messages are handed
+ * back here and reused by the transport for the following messages, so that a steady stream of
+ * similarly-sized messages does not allocate at all. Only buffers up to MAX_BUFFER_SIZE are
+ * retained, and the total capacity held is bounded, so a single large message (e.g. a block)
+ * does not pin its memory for the lifetime of the connection.
+ */
+class RecvBufferPool
+{
+public:
+    /** Maximum capacity of a single buffer to retain. */
+    static constexpr size_t MAX_BUFFER_SIZE{64 * 1024};
+    /** Maximum number of buffers to retain. */
+    static constexpr size_t MAX_BUFFERS{8};
+
+    /** @param[in] max_pooled_bytes Maximum total memory usage of the retained buffers. */
+    explicit RecvBufferPool(size_t max_pooled_bytes) noexcept : m_max_pooled_bytes{max_pooled_bytes} {}
+
+    /** Get an empty buffer, reusing a retained one if available. */
+    DataStream Get() noexcept EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Hand back a buffer that is no longer used. It is either retained or freed. */
+    void Put(DataStream&& buffer) noexcept EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    /** Total memory usage of the retained buffers. */
+    size_t GetPooledBytes() const noexcept EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    const size_t m_max_pooled_bytes;
+    mutable Mutex m_mutex;
+    std::vector<DataStream> m_buffers GUARDED_BY(m_mutex);
+    size_t m_pooled_bytes GUARDED_BY(m_mutex){0};
+};
+
 /** The Transport converts one connection's sent messages to wire bytes, and received bytes back. */
 class Transport {
 public:
@@ -371,6 +407,7 @@ class V1Transport final : public Transport
 private:
     const MessageStartChars m_magic_bytes;
     const NodeId m_node_id; // Only for logging
+    RecvBufferPool* const m_recv_buffer_pool; //!< Where to take receive buffers from (may be nullptr)
     mutable Mutex m_recv_mutex; //!< Lock for receive state
     mutable CHash256 hasher GUARDED_BY(m_recv_mutex);
     mutable uint256 data_hash GUARDED_BY(m_recv_mutex);
@@ -416,7 +453,8 @@ private:
     size_t m_bytes_sent GUARDED_BY(m_send_mutex) {0};
 
 public:
-    explicit V1Transport(const NodeId node_id) noexcept;
+    /** @param[in] recv_buffer_pool Pool to take receive buffers from, or nullptr. Must outlive the transport. */
+    explicit V1Transport(const NodeId node_id, RecvBufferPool* recv_buffer_pool = nullptr) noexcept;
 
     bool ReceivedMessageComplete() const override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex)
     {
@@ -580,6 +618,8 @@ private:
     const bool m_initiating;
     /** NodeId (for debug logging). */
     const NodeId m_nodeid;
+    /** Where to take receive buffers from (may be nullptr). */
+    RecvBufferPool* const m_recv_buffer_pool;
     /** Encapsulate a V1Transport to fall back to. */
     V1Transport m_v1_fallback;
 
@@ -639,11 +679,12 @@ public:
      *
      * @param[in] nodeid      the node's NodeId (only for debug log output).
      * @param[in] initiating  whether we are the initiator side.
+     * @param[in] recv_buffer_pool  pool to take receive buffers from, or nullptr. Must outlive the transport.
      */
-    V2Transport(NodeId nodeid, bool initiating) noexcept;
+    V2Transport(NodeId nodeid, bool initiating, RecvBufferPool* recv_buffer_pool = nullptr) noexcept;
 
     /** Construct a V2 transport with specified keys and garbage (test use only). */
-    V2Transport(NodeId nodeid, bool initiating, const CKey& key, std::span<const std::byte> ent32, std::vector<uint8_t> garbage) noexcept;
+    V2Transport(NodeId nodeid, bool initiating, const CKey& key, std::span<const std::byte> ent32, std::vector<uint8_t> garbage, RecvBufferPool* recv_buffer_pool = nullptr) noexcept;
 
     // Receive side functions.
     bool ReceivedMessageComplete() const noexcept override EXCLUSIVE_LOCKS_REQUIRED(!m_recv_mutex);
@@ -674,6 +715,10 @@ struct CNodeOptions
 class CNode
 {
 public:
+    /** Receive buffers for m_transport. Buffers of processed messages are handed back through
+     * RecycleRecvBuffer. Declared before m_transport, which refers to it. */
+    RecvBufferPool m_recv_buffer_pool;
+
     /** Transport serializer/deserializer. The receive side functions are only called under cs_vRecv, while
      * the sending side functions are only called under cs_vSend. */
     const std::unique_ptr<Transport> m_transport;
@@ -752,6 +797,11 @@ public:
     std::optional<std::pair<CNetMessage, bool>> PollMessage()
         EXCLUSIVE_LOCKS_REQUIRED(!m_msg_process_queue_mutex);
 
+    /** Hand back the receive buffer of a processed message, so it can be reused for
+     * following messages of this connection. */
+    void RecycleRecvBuffer(DataStream&& buffer)
+        EXCLUSIVE_LOCKS_REQUIRED(!m_msg_process_queue_mutex);
+
     /** Account for the total size of a sent message in the per msg type connection stats. */
     void AccountForSentBytes(const std::string& msg_type, size_t sent_bytes)
         EXCLUSIVE_LOCKS_REQUIRED(cs_vSend)
@@ -64,6 +64,7 @@
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <bit>
 #include <compare>
 #include <cstddef>
 #include <deque>
@@ -88,6 +89,7 @@
 using namespace util::hex_literals;
 
 TRACEPOINT_SEMAPHORE(net, inbound_message);
+TRACEPOINT_SEMAPHORE(net, processed_message);
 TRACEPOINT_SEMAPHORE(net, misbehaving_connection);
 
 /** Headers download timeout.
@@ -523,7 +525,7 @@ public:
     void FinalizeNode(const CNode& node) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_headers_presync_mutex, !m_tx_download_mutex);
     bool HasAllDesirableServiceFlags(ServiceFlags services) const override;
     bool ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, !m_headers_presync_mutex, g_msgproc_mutex, !m_tx_download_mutex, !m_msg_processing_stats_mutex);
     bool SendMessages(CNode* pto) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex, !m_most_recent_block_mutex, g_msgproc_mutex, !m_tx_download_mutex);
 
@@ -535,6 +537,7 @@ public:
     bool GetNodeStateStats(NodeId nodeid, CNodeStateStats& stats) const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     std::vector<node::TxOrphanage::OrphanInfo> GetOrphanTransactions() override EXCLUSIVE_LOCKS_REQUIRED(!m_tx_download_mutex);
     PeerManagerInfo GetInfo() const override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
+    std::map<std::string, MsgTypeProcessingStats> GetMsgTypeProcessingStats() const override EXCLUSIVE_LOCKS_REQUIRED(!m_msg_processing_stats_mutex);
     void SendPings() override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void RelayTransaction(const Txid& txid, const Wtxid& wtxid) override EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
     void SetBestBlock(int height, std::chrono::seconds time) override
@@ -556,6 +559,9 @@ private:
     /** If we have extra outbound peers, try to disconnect the one with the oldest block announcement */
     void EvictExtraOutboundPeers(std::chrono::seconds now) EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
+    /** Announce transactions to a peer we reconcile with, as the outcome of a reconciliation round */
+    void AnnounceReconciledTxs(CNode& node, Peer& peer, std::span<const Wtxid> wtxids) EXCLUSIVE_LOCKS_REQUIRED(g_msgproc_mutex);
+
     /** Retrieve unbroadcast transactions from the mempool and reattempt sending to peers */
     void ReattemptInitialBroadcast(CScheduler& scheduler) EXCLUSIVE_LOCKS_REQUIRED(!m_peer_mutex);
 
@@ -867,6 +873,11 @@ private:
     std::map<NodeId, HeadersPresyncStats> m_headers_presync_stats GUARDED_BY(m_headers_presync_mutex) {};
     /** The peer with the most-work entry in m_headers_presync_stats. */
     NodeId m_headers_presync_bestpeer GUARDED_BY(m_headers_presync_mutex) {-1};
+
+    mutable Mutex m_msg_processing_stats_mutex;
+    /** Processing time statistics per message type. Contains an entry for every known message
+     *  type plus NET_MESSAGE_TYPE_OTHER, under which all unknown message types are counted. */
+    std::map<std::string, MsgTypeProcessingStats> m_msg_processing_stats GUARDED_BY(m_msg_processing_stats_mutex);
     /** The m_headers_presync_stats improved, and needs signalling. */
     std::atomic_bool m_headers_presync_should_signal{false};
 
@@ -1762,6 +1773,27 @@ PeerManagerInfo PeerManagerImpl::GetInfo() const
     };
 }
 
+size_t MsgTypeProcessingStats::HistogramBucket(std::chrono::microseconds duration)
+{
+    return std::min<size_t>(std::bit_width(uint64_t(std::max<int64_t>(duration.count(), 0))), HISTOGRAM_BUCKETS - 1);
+}
+
+void MsgTypeProcessingStats::Update(std::chrono::microseconds processing, std::chrono::microseconds queue_wait)
+{
+    ++count;
+    processing_time += processing;
+    max_processing_time = std::max(max_processing_time, processing);
+    queue_wait_time += queue_wait;
+    ++processing_time_histogram[HistogramBucket(processing)];
+    ++queue_wait_histogram[HistogramBucket(queue_wait)];
+}
+
+std::map<std::string, MsgTypeProcessingStats> PeerManagerImpl::GetMsgTypeProcessingStats() const
+{
+    LOCK(m_msg_processing_stats_mutex);
+    return m_msg_processing_stats;
+}
+
 void PeerManagerImpl::AddToCompactExtraTransactions(const CTransactionRef& tx)
 {
     if (m_opts.max_extra_txs <= 0)
@@ -1902,6 +1934,12 @@ PeerManagerImpl::PeerManagerImpl(CConnman& connman, AddrMan& addrman,
     if (opts.reconcile_txs) {
         m_txreconciliation = std::make_unique<TxReconciliationTracker>(TXRECONCILIATION_VERSION);
     }
+
+    LOCK(m_msg_processing_stats_mutex);
+    for (const std::string& msg_type : ALL_NET_MESSAGE_TYPES) {
+        m_msg_processing_stats[msg_type];
+    }
+    m_msg_processing_stats[NET_MESSAGE_TYPE_OTHER];
 }
 
 void PeerManagerImpl::StartScheduledTasks(CScheduler& scheduler)
@@ -2358,6 +2396,31 @@ void PeerManagerImpl::ProcessGetBlockData(CNode& pfrom, Peer& peer, const CInv&
     }
 }
 
+void PeerManagerImpl::AnnounceReconciledTxs(CNode& node, Peer& peer, std::span<const Wtxid> wtxids)
+{
+    auto tx_relay = peer.GetTxRelay();
+    if (!tx_relay || wtxids.empty()) return;
+
+    const CFeeRate filterrate{tx_relay->m_fee_filter_received.load()};
+    std::vector<CInv> invs;
+    for (const Wtxid& wtxid : wtxids) {
+        // Not in the mempool anymore, or below the peer's fee filter? Don't bother sending it.
+        const auto txinfo = m_mempool.info(wtxid);
+        if (!txinfo.tx || txinfo.fee < filterrate.GetFee(txinfo.vsize)) continue;
+        // Peers we reconcile with always use wtxid relay.
+        invs.emplace_back(MSG_WTX, wtxid.ToUint256());
+        if (invs.size() == MAX_INV_SZ) {
+            MakeAndPushMessage(node, NetMsgType::INV, invs);
+            invs.clear();
+        }
+    }
+    if (!invs.empty()) MakeAndPushMessage(node, NetMsgType::INV, invs);
+
+    // Ensure we'll respond to GETDATA requests for anything we've just announced
+    LOCK(m_mempool.cs);
+    tx_relay->m_last_inv_sequence = m_mempool.GetSequence();
+}
+
 CTransactionRef PeerManagerImpl::FindTxForGetData(const Peer::TxRelay& tx_relay, const GenTxid& gtxid)
 {
     // If a tx was in the mempool prior to the last INV for this peer, permit the request.
@@ -3928,6 +3991,43 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
         return;
     }
 
+    if (msg_type == NetMsgType::REQRECON || msg_type == NetMsgType::SKETCH || msg_type == NetMsgType::RECONCILDIFF) {
+        if (!m_txreconciliation) {
+            LogDebug(BCLog::NET, "%s from peer=%d ignored, as our node does not have txreconciliation enabled\n", msg_type, pfrom.GetId());
+            return;
+        }
+
+        std::optional<std::vector<Wtxid>> to_announce;
+        if (msg_type == NetMsgType::REQRECON) {
+            uint16_t peer_recon_set_size, peer_q;
+            vRecv >> peer_recon_set_size >> peer_q;
+            if (const auto skdata{m_txreconciliation->HandleReconciliationRequest(pfrom.GetId(), peer_recon_set_size, peer_q)}) {
+                MakeAndPushMessage(pfrom, NetMsgType::SKETCH, *skdata);
+                to_announce.emplace();
+            }
+        } else if (msg_type == NetMsgType::SKETCH) {
+            std::vector<uint8_t> skdata;
+            vRecv >> skdata;
+            if (auto outcome{m_txreconciliation->HandleSketch(pfrom.GetId(), skdata)}) {
+                MakeAndPushMessage(pfrom, NetMsgType::RECONCILDIFF, uint8_t{outcome->success}, outcome->ask_shortids);
+                to_announce = std::move(outcome->announce);
+            }
+        } else {
+            uint8_t success;
+            std::vector<uint32_t> ask_shortids;
+            vRecv >> success >> ask_shortids;
+            to_announce = m_txreconciliation->HandleReconciliationDifference(pfrom.GetId(), success, ask_shortids);
+        }
+
+        if (!to_announce) {
+            LogDebug(BCLog::NET, "txreconciliation protocol violation (unexpected %s), %s\n", msg_type, pfrom.DisconnectMsg(fLogIPs));
+            pfrom.fDisconnect = true;
+            return;
+        }
+        AnnounceReconciledTxs(pfrom, *peer, *to_announce);
+        return;
+    }
+
     if (msg_type == NetMsgType::INV) {
         std::vector<CInv> vInv;
         vRecv >> vInv;
@@ -3943,6 +4043,8 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
 
         const auto current_time{GetTime<std::chrono::microseconds>()};
         uint256* best_block{nullptr};
+        // Transaction announcements are handed to m_txdownloadman in one batch after the loop.
+        std::vector<GenTxid> tx_announcements;
 
         for (CInv& inv : vInv) {
             if (interruptMsgProc) return;
@@ -3978,16 +4080,26 @@ void PeerManagerImpl::ProcessMessage(CNode& pfrom, const std::string& msg_type,
                 }
                 const GenTxid gtxid = ToGenTxid(inv);
                 AddKnownTx(*peer, inv.hash);
-
-                if (!m_chainman.IsInitialBlockDownload()) {
-                    const bool fAlreadyHave{m_txdownloadman.AddTxAnnouncement(pfrom.GetId(), gtxid, current_time)};
-                    LogDebug(BCLog::NET, "got inv: %s  %s peer=%d\n", inv.ToString(), fAlreadyHave ? "have" : "new", pfrom.GetId());
+                if (m_txreconciliation && inv.IsMsgWtx()) {
+                    // The peer already has this transaction, so there is no need to reconcile it.
+                    m_txreconciliation->TryRemovingFromSet(pfrom.GetId(), Wtxid::FromUint256(inv.hash));
                 }
+
+                if (!m_chainman.IsInitialBlockDownload()) tx_announcements.push_back(gtxid);
             } else {
                 LogDebug(BCLog::NET, "Unknown inv type \"%s\" received from peer=%d\n", inv.ToString(), pfrom.GetId());
             }
         }
 
+        if (!tx_announcements.empty()) {
+            const auto already_have{m_txdownloadman.AddTxAnnouncements(pfrom.GetId(), tx_announcements, current_time)};
+            for (size_t i = 0; i < tx_announcements.size(); ++i) {
+                const auto& gtxid{tx_announcements[i]};
+                LogDebug(BCLog::NET, "got inv: %s %s  %s peer=%d\n", gtxid.IsWtxid() ? "wtx" : "tx", gtxid.ToUint256().ToString(),
+                         already_have[i] ? "have" : "new", pfrom.GetId());
+            }
+        }
+
         if (best_block != nullptr) {
             // If we haven't started initial headers-sync with this peer, then
             // consider sending a getheaders now. On initial startup, there's a
@@ -5023,8 +5135,13 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
         CaptureMessage(pfrom->addr, msg.m_type, MakeUCharSpan(msg.m_recv), /*is_incoming=*/true);
     }
 
+    // Time the message spent queued between being received and being processed
+    const auto queue_wait{std::max(GetTime<std::chrono::microseconds>() - msg.m_time, 0us)};
+    const auto processing_start{SteadyClock::now()};
+    auto processing_end{processing_start};
     try {
         ProcessMessage(*pfrom, msg.m_type, msg.m_recv, msg.m_time, interruptMsgProc);
+        processing_end = SteadyClock::now();
         if (interruptMsgProc) return false;
         {
             LOCK(peer->m_getdata_requests_mutex);
@@ -5038,11 +5155,33 @@ bool PeerManagerImpl::ProcessMessages(CNode* pfrom, std::atomic<bool>& interrupt
         LOCK(m_tx_download_mutex);
         if (m_txdownloadman.HaveMoreWork(peer->m_id)) fMoreWork = true;
     } catch (const std::exception& e) {
+        processing_end = SteadyClock::now();
         LogDebug(BCLog::NET, "%s(%s, %u bytes): Exception '%s' (%s) caught\n", __func__, SanitizeString(msg.m_type), msg.m_message_size, e.what(), typeid(e).name());
     } catch (...) {
+        processing_end = SteadyClock::now();
         LogDebug(BCLog::NET, "%s(%s, %u bytes): Unknown exception caught\n", __func__, SanitizeString(msg.m_type), msg.m_message_size);
     }
 
+    const auto processing_time{std::chrono::duration_cast<std::chrono::microseconds>(processing_end - processing_start)};
+    TRACEPOINT(net, processed_message,
+        pfrom->GetId(),
+        pfrom->m_addr_name.c_str(),
+        pfrom->ConnectionTypeAsString().c_str(),
+        msg.m_type.c_str(),
+        msg.m_message_size,
+        count_microseconds(queue_wait),
+        count_microseconds(processing_time)
+    );
+    {
+        LOCK(m_msg_processing_stats_mutex);
+        auto it{m_msg_processing_stats.find(msg.m_type)};
+        // Unknown message types are counted under NET_MESSAGE_TYPE_OTHER, which always has an entry
+        if (it == m_msg_processing_stats.end()) it = m_msg_processing_stats.find(NET_MESSAGE_TYPE_OTHER);
+        it->second.Update(processing_time, queue_wait);
+    }
+
+    pfrom->RecycleRecvBuffer(std::move(msg.m_recv));
+
     return fMoreWork;
 }
 
@@ -5771,6 +5910,8 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                     // No reason to drain out at many times the network's capacity,
                     // especially since we have many peers and some will draw much shorter delays.
                     unsigned int nRelayedTransactions = 0;
+                    // Peers we reconcile with learn about transactions at the next reconciliation instead.
+                    const bool reconcile_txs{m_txreconciliation && m_txreconciliation->IsPeerRegistered(pto->GetId())};
                     LOCK(tx_relay->m_bloom_filter_mutex);
                     size_t broadcast_max{INVENTORY_BROADCAST_TARGET + (tx_relay->m_tx_inventory_to_send.size()/1000)*5};
                     broadcast_max = std::min<size_t>(INVENTORY_BROADCAST_MAX, broadcast_max);
@@ -5802,13 +5943,18 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
                             continue;
                         }
                         if (tx_relay->m_bloom_filter && !tx_relay->m_bloom_filter->IsRelevantAndUpdate(*txinfo.tx)) continue;
-                        // Send
-                        vInv.push_back(inv);
-                        nRelayedTransactions++;
-                        if (vInv.size() == MAX_INV_SZ) {
-                            MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
-                            vInv.clear();
+                        // Send, unless it can be added to the peer's reconciliation set. A few
+                        // outbound peers still get every transaction flooded to them (see BIP-330),
+                        // and we also fall back to flooding when the set is full.
+                        if (!reconcile_txs || m_txreconciliation->IsFanoutTarget(pto->GetId(), wtxid) ||
+                            !m_txreconciliation->AddToSet(pto->GetId(), wtxid)) {
+                            vInv.push_back(inv);
+                            if (vInv.size() == MAX_INV_SZ) {
+                                MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
+                                vInv.clear();
+                            }
                         }
+                        nRelayedTransactions++;
                         tx_relay->m_tx_inventory_known_filter.insert(inv.hash);
                     }
 
@@ -5820,6 +5966,16 @@ bool PeerManagerImpl::SendMessages(CNode* pto)
         if (!vInv.empty())
             MakeAndPushMessage(*pto, NetMsgType::INV, vInv);
 
+        //
+        // Message: reqrecon
+        //
+        if (m_txreconciliation) {
+            if (const auto request{m_txreconciliation->InitiateReconciliationRequest(pto->GetId(), current_time)}) {
+                const auto [local_set_size, local_q] = *request;
+                MakeAndPushMessage(*pto, NetMsgType::REQRECON, local_set_size, local_q);
+            }
+        }
+
         // Detect whether we're stalling
         auto stalling_timeout = m_block_stalling_timeout.load();
         if (state.m_stalling_since.count() && state.m_stalling_since < current_time - stalling_timeout) {
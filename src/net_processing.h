@@ -13,9 +13,11 @@
 #include <threadsafety.h>
 #include <validationinterface.h>
 
+#include <array>
 #include <atomic>
 #include <chrono>
 #include <cstdint>
+#include <map>
 #include <memory>
 #include <optional>
 #include <string>
@@ -63,6 +65,29 @@ struct CNodeStateStats {
     std::chrono::seconds time_offset{0};
 };
 
+/** Message processing time statistics for a single message type. */
+struct MsgTypeProcessingStats {
+    /** Number of histogram buckets. Bucket 0 counts durations below 1 microsecond, bucket i
+     *  counts durations in [2^(i-1), 2^i) microseconds, and the last bucket also counts
+     *  anything longer. */
+    static constexpr size_t HISTOGRAM_BUCKETS{24};
+    using Histogram = std::array<uint64_t, HISTOGRAM_BUCKETS>;
+
+    //! Number of messages processed
+    uint64_t count{0};
+    //! Total time spent in ProcessMessage
+    std::chrono::microseconds processing_time{0};
+    //! Longest time spent in ProcessMessage for a single message
+    std::chrono::microseconds max_processing_time{0};
+    //! Total time messages waited between being received and being processed
+    std::chrono::microseconds queue_wait_time{0};
+    Histogram processing_time_histogram{};
+    Histogram queue_wait_histogram{};
+
+    static size_t HistogramBucket(std::chrono::microseconds duration);
+    void Update(std::chrono::microseconds processing, std::chrono::microseconds queue_wait);
+};
+
 struct PeerManagerInfo {
     std::chrono::seconds median_outbound_time_offset{0s};
     bool ignores_incoming_txs{false};
@@ -114,6 +139,9 @@ public:
     /** Get peer manager info. */
     virtual PeerManagerInfo GetInfo() const = 0;
 
+    /** Get message processing time statistics, keyed by message type. */
+    virtual std::map<std::string, MsgTypeProcessingStats> GetMsgTypeProcessingStats() const = 0;
+
     /** Relay transaction to all peers. */
     virtual void RelayTransaction(const Txid& txid, const Wtxid& wtxid) = 0;
 
@@ -40,7 +40,9 @@ class SignalInterrupt;
 }
 
 namespace node {
+class BlockTemplateCache;
 class KernelNotifications;
+class ResponseCache;
 class Warnings;
 
 //! NodeContext struct containing references to chain state and connection
@@ -79,6 +81,10 @@ struct NodeContext {
     //! Reference to chain client that should used to load or create wallets
     //! opened by the gui.
     std::unique_ptr<interfaces::Mining> mining;
+    //! Most recent block template, shared by all mining interface clients
+    std::unique_ptr<BlockTemplateCache> block_template_cache;
+    //! Responses to RPC and REST requests for immutable data, if -rpccachesize is set
+    std::unique_ptr<ResponseCache> response_cache;
     interfaces::WalletLoader* wallet_loader{nullptr};
     std::unique_ptr<CScheduler> scheduler;
     std::function<void()> rpc_interruption_point = [] {};
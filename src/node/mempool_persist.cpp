@@ -4,6 +4,7 @@
 
 #include <node/mempool_persist.h>
 
+#include <chain.h>
 #include <clientversion.h>
 #include <consensus/amount.h>
 #include <logging.h>
@@ -16,6 +17,7 @@
 #include <uint256.h>
 #include <util/fs.h>
 #include <util/fs_helpers.h>
+#include <util/hasher.h>
 #include <util/obfuscation.h>
 #include <util/signalinterrupt.h>
 #include <util/syserror.h>
@@ -28,8 +30,11 @@
 #include <functional>
 #include <map>
 #include <memory>
+#include <optional>
 #include <set>
+#include <span>
 #include <stdexcept>
+#include <unordered_map>
 #include <utility>
 #include <vector>
 
@@ -40,6 +45,56 @@ namespace node {
 static const uint64_t MEMPOOL_DUMP_VERSION_NO_XOR_KEY{1};
 static const uint64_t MEMPOOL_DUMP_VERSION{2};
 
+/** Number of transactions whose scripts are verified in parallel before submitting them one by one. */
+static constexpr size_t LOAD_BATCH_SIZE{500};
+
+namespace {
+/** A transaction entry read from a mempool dump. */
+struct PersistedTx {
+    CTransactionRef tx;
+    int64_t time;
+    int64_t fee_delta;
+};
+
+/**
+ * Order the entries so that every transaction comes after its parents in the file, keeping
+ * the file order otherwise. Dumps are written in this order already, but imported files might
+ * not be.
+ */
+std::vector<PersistedTx> SortByDependencies(std::vector<PersistedTx>&& entries)
+{
+    std::unordered_map<Txid, size_t, SaltedTxidHasher> index;
+    for (size_t i{0}; i < entries.size(); ++i) index.emplace(entries[i].tx->GetHash(), i);
+
+    std::vector<PersistedTx> sorted;
+    sorted.reserve(entries.size());
+    std::vector<bool> visited(entries.size());
+    // Depth-first traversal of the parents: (entry, next input to look at).
+    std::vector<std::pair<size_t, size_t>> stack;
+    for (size_t root{0}; root < entries.size(); ++root) {
+        if (visited[root]) continue;
+        visited[root] = true;
+        stack.emplace_back(root, 0);
+        while (!stack.empty()) {
+            const auto [pos, input]{stack.back()};
+            const CTransaction& tx{*entries[pos].tx};
+            if (input < tx.vin.size()) {
+                ++stack.back().second;
+                const auto it{index.find(tx.vin[input].prevout.hash)};
+                if (it != index.end() && !visited[it->second]) {
+                    visited[it->second] = true;
+                    stack.emplace_back(it->second, 0);
+                }
+            } else {
+                sorted.push_back(std::move(entries[pos]));
+                stack.pop_back();
+            }
+        }
+    }
+    return sorted;
+}
+} // namespace
+
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active_chainstate, ImportMempoolOptions&& opts)
 {
     if (load_path.empty()) return false;
@@ -57,6 +112,11 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
     int64_t unbroadcast = 0;
     const auto now{NodeClock::now()};
 
+    std::vector<PersistedTx> entries;
+    std::map<Txid, CAmount> mapDeltas;
+    std::set<Txid> unbroadcast_txids;
+    std::optional<uint256> dump_tip;
+    bool read_all{false};
     try {
         uint64_t version;
         file >> version;
@@ -73,36 +133,87 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
 
         uint64_t total_txns_to_load;
         file >> total_txns_to_load;
-        uint64_t txns_tried = 0;
         LogInfo("Loading %u mempool transactions from file...\n", total_txns_to_load);
-        int next_tenth_to_report = 0;
-        while (txns_tried < total_txns_to_load) {
-            const int percentage_done(100.0 * txns_tried / total_txns_to_load);
-            if (next_tenth_to_report < percentage_done / 10) {
-                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
-                        percentage_done, txns_tried, total_txns_to_load - txns_tried);
-                next_tenth_to_report = percentage_done / 10;
-            }
-            ++txns_tried;
-
+        while (entries.size() < total_txns_to_load) {
             CTransactionRef tx;
             int64_t nTime;
             int64_t nFeeDelta;
             file >> TX_WITH_WITNESS(tx);
             file >> nTime;
             file >> nFeeDelta;
+            entries.push_back({std::move(tx), nTime, nFeeDelta});
+        }
+        file >> mapDeltas;
+        file >> unbroadcast_txids;
+        read_all = true;
+
+        // Dumps written by older versions end here.
+        uint256 tip_hash;
+        file >> tip_hash;
+        dump_tip = tip_hash;
+    } catch (const std::exception& e) {
+        if (!read_all) {
+            // Still try the transactions read before the error.
+            LogInfo("Failed to deserialize mempool data on file: %s. Continuing anyway.\n", e.what());
+        }
+    }
+
+    // The transactions were valid at the tip the file was written at. If that is still the tip,
+    // their scripts can be trusted if requested, otherwise they are verified in parallel first.
+    const auto at_dump_tip{[&]() EXCLUSIVE_LOCKS_REQUIRED(::cs_main) {
+        const CBlockIndex* tip{active_chainstate.m_chain.Tip()};
+        return tip && dump_tip && tip->GetBlockHash() == *dump_tip;
+    }};
+    const bool trust_scripts{opts.trust_unchanged_tip && read_all && WITH_LOCK(::cs_main, return at_dump_tip())};
+    if (trust_scripts) {
+        LogInfo("Loading mempool transactions saved at the current tip without script verification\n");
+    }
 
+    entries = SortByDependencies(std::move(entries));
+    const uint64_t total_txns_to_load{entries.size()};
+    uint64_t txns_tried = 0;
+    int next_tenth_to_report = 0;
+    for (size_t batch_start{0}; batch_start < entries.size(); batch_start += LOAD_BATCH_SIZE) {
+        const std::span batch{std::span{entries}.subspan(batch_start, std::min(LOAD_BATCH_SIZE, entries.size() - batch_start))};
+        for (PersistedTx& entry : batch) {
             if (opts.use_current_time) {
-                nTime = TicksSinceEpoch<std::chrono::seconds>(now);
+                entry.time = TicksSinceEpoch<std::chrono::seconds>(now);
+            }
+        }
+        const auto is_expired{[&](const PersistedTx& entry) {
+            return entry.time <= TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry);
+        }};
+
+        bool trusted;
+        {
+            LOCK(cs_main);
+            trusted = trust_scripts && at_dump_tip();
+            if (!trusted) {
+                std::vector<CTransactionRef> txs;
+                for (const PersistedTx& entry : batch) {
+                    if (!is_expired(entry)) txs.push_back(entry.tx);
+                }
+                PrewarmMempoolSignatureCache(active_chainstate, txs);
+            }
+        }
+
+        for (const PersistedTx& entry : batch) {
+            const int percentage_done(100.0 * txns_tried / total_txns_to_load);
+            if (next_tenth_to_report < percentage_done / 10) {
+                LogInfo("Progress loading mempool transactions from file: %d%% (tried %u, %u remaining)\n",
+                        percentage_done, txns_tried, total_txns_to_load - txns_tried);
+                next_tenth_to_report = percentage_done / 10;
             }
+            ++txns_tried;
 
-            CAmount amountdelta = nFeeDelta;
+            CAmount amountdelta = entry.fee_delta;
             if (amountdelta && opts.apply_fee_delta_priority) {
-                pool.PrioritiseTransaction(tx->GetHash(), amountdelta);
+                pool.PrioritiseTransaction(entry.tx->GetHash(), amountdelta);
             }
-            if (nTime > TicksSinceEpoch<std::chrono::seconds>(now - pool.m_opts.expiry)) {
+            if (!is_expired(entry)) {
                 LOCK(cs_main);
-                const auto& accepted = AcceptToMemoryPool(active_chainstate, tx, nTime, /*bypass_limits=*/false, /*test_accept=*/false);
+                const auto& accepted = AcceptToMemoryPool(active_chainstate, entry.tx, entry.time, /*bypass_limits=*/false, /*test_accept=*/false,
+                                                          /*skip_script_checks=*/trusted);
                 if (accepted.m_result_type == MempoolAcceptResult::ResultType::VALID) {
                     ++count;
                 } else {
@@ -110,7 +221,7 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
                     // wallet(s) having loaded it while we were processing
                     // mempool transactions; consider these as valid, instead of
                     // failed, but mark them as 'already there'
-                    if (pool.exists(tx->GetHash())) {
+                    if (pool.exists(entry.tx->GetHash())) {
                         ++already_there;
                     } else {
                         ++failed;
@@ -122,35 +233,29 @@ bool LoadMempool(CTxMemPool& pool, const fs::path& load_path, Chainstate& active
             if (active_chainstate.m_chainman.m_interrupt)
                 return false;
         }
-        std::map<Txid, CAmount> mapDeltas;
-        file >> mapDeltas;
+    }
+    if (!read_all) return false;
 
-        if (opts.apply_fee_delta_priority) {
-            for (const auto& i : mapDeltas) {
-                pool.PrioritiseTransaction(i.first, i.second);
-            }
+    if (opts.apply_fee_delta_priority) {
+        for (const auto& i : mapDeltas) {
+            pool.PrioritiseTransaction(i.first, i.second);
         }
+    }
 
-        std::set<Txid> unbroadcast_txids;
-        file >> unbroadcast_txids;
-        if (opts.apply_unbroadcast_set) {
-            unbroadcast = unbroadcast_txids.size();
-            for (const auto& txid : unbroadcast_txids) {
-                // Ensure transactions were accepted to mempool then add to
-                // unbroadcast set.
-                if (pool.get(txid) != nullptr) pool.AddUnbroadcastTx(txid);
-            }
+    if (opts.apply_unbroadcast_set) {
+        unbroadcast = unbroadcast_txids.size();
+        for (const auto& txid : unbroadcast_txids) {
+            // Ensure transactions were accepted to mempool then add to
+            // unbroadcast set.
+            if (pool.get(txid) != nullptr) pool.AddUnbroadcastTx(txid);
         }
-    } catch (const std::exception& e) {
-        LogInfo("Failed to deserialize mempool data on file: %s. Continuing anyway.\n", e.what());
-        return false;
     }
 
     LogInfo("Imported mempool transactions from file: %i succeeded, %i failed, %i expired, %i already there, %i waiting for initial broadcast\n", count, failed, expired, already_there, unbroadcast);
     return true;
 }
 
-bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mockable_fopen_function, bool skip_file_commit)
+bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, const uint256& tip_hash, FopenFn mockable_fopen_function, bool skip_file_commit)
 {
     auto start = SteadyClock::now();
 
@@ -205,6 +310,8 @@ bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, FopenFn mock
         LogInfo("Writing %d unbroadcast transactions to file.\n", unbroadcast_txids.size());
         file << unbroadcast_txids;
 
+        file << tip_hash;
+
         if (!skip_file_commit && !file.Commit()) {
             (void)file.fclose();
             throw std::runtime_error("Commit failed");
@@ -9,11 +9,12 @@
 
 class Chainstate;
 class CTxMemPool;
+class uint256;
 
 namespace node {
 
-/** Dump the mempool to a file. */
-bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path,
+/** Dump the mempool to a file, recording the chain tip its transactions were validated at. */
+bool DumpMempool(const CTxMemPool& pool, const fs::path& dump_path, const uint256& tip_hash,
                  fsbridge::FopenFn mockable_fopen_function = fsbridge::fopen,
                  bool skip_file_commit = false);
 
@@ -22,6 +23,9 @@ struct ImportMempoolOptions {
     bool use_current_time{false};
     bool apply_fee_delta_priority{true};
     bool apply_unbroadcast_set{true};
+    /** Skip script verification if the file was written at the current chain tip. Only for files
+     *  written by this node, as the transactions are assumed to have been validated at that tip. */
+    bool trust_unchanged_tip{false};
 };
 /** Import the file and attempt to add its contents to the mempool. */
 bool LoadMempool(CTxMemPool& pool, const fs::path& load_path,
@@ -16,6 +16,11 @@ namespace node {
  * automatically load the mempool on start and save to disk on shutdown
  */
 static constexpr bool DEFAULT_PERSIST_MEMPOOL{true};
+/**
+ * Default for -persistmempooltrust, indicating whether the scripts of the transactions loaded on
+ * start are assumed valid if the chain tip is the one the mempool was saved at
+ */
+static constexpr bool DEFAULT_PERSIST_MEMPOOL_TRUST{false};
 
 bool ShouldPersistMempool(const ArgsManager& argsman);
 fs::path MempoolPath(const ArgsManager& argsman);
@@ -22,6 +22,7 @@
 #include <policy/policy.h>
 #include <pow.h>
 #include <primitives/transaction.h>
+#include <txgraph.h>
 #include <util/moneystr.h>
 #include <util/signalinterrupt.h>
 #include <util/time.h>
@@ -303,6 +304,11 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
     const auto& mempool{*Assert(m_mempool)};
     LOCK(mempool.cs);
 
+    if (mempool.HaveClusterLinearizations()) {
+        addChunkTxs(mempool, nPackagesSelected);
+        return;
+    }
+
     // mapModifiedTx will store sorted packages after they are modified
     // because some of their txs are already in the block
     indexed_modified_transaction_set mapModifiedTx;
@@ -440,6 +446,72 @@ void BlockAssembler::addPackageTxs(int& nPackagesSelected, int& nDescendantsUpda
     }
 }
 
+// When all of the mempool's clusters are linearized, the mempool already knows the
+// order in which its transactions are best mined: chunks, from highest to lowest
+// feerate, each one only depending on chunks before it. Walk them in that order.
+// A chunk that cannot be included causes the rest of its cluster to be skipped,
+// since later chunks of the same cluster may depend on it.
+void BlockAssembler::addChunkTxs(const CTxMemPool& mempool, int& nPackagesSelected)
+{
+    AssertLockHeld(mempool.cs);
+
+    const int64_t MAX_CONSECUTIVE_FAILURES = 1000;
+    constexpr int32_t BLOCK_FULL_ENOUGH_WEIGHT_DELTA = 4000;
+    int64_t nConsecutiveFailed = 0;
+
+    const auto builder{mempool.GetBlockBuilder()};
+    while (const auto chunk{builder->GetCurrentChunk()}) {
+        const auto& [refs, chunk_feerate] = *chunk;
+        const uint64_t packageSize = chunk_feerate.size / WITNESS_SCALE_FACTOR;
+        const CAmount packageFees = chunk_feerate.fee;
+
+        if (packageFees < m_options.blockMinFeeRate.GetFee(packageSize)) {
+            // Everything else we might consider has a lower fee rate
+            return;
+        }
+
+        CTxMemPool::setEntries package;
+        std::vector<CTxMemPool::txiter> sortedEntries;
+        int64_t packageSigOpsCost = 0;
+        for (const TxGraph::Ref* ref : refs) {
+            const auto it{mempool.GetIter(*ref)};
+            package.insert(it);
+            sortedEntries.push_back(it);
+            packageSigOpsCost += it->GetSigOpCost();
+        }
+
+        if (!TestPackage(packageSize, packageSigOpsCost)) {
+            builder->Skip();
+            ++nConsecutiveFailed;
+
+            if (nConsecutiveFailed > MAX_CONSECUTIVE_FAILURES && nBlockWeight >
+                    m_options.nBlockMaxWeight - BLOCK_FULL_ENOUGH_WEIGHT_DELTA) {
+                // Give up if we're close to full and haven't succeeded in a while
+                break;
+            }
+            continue;
+        }
+
+        // Test if all tx's are Final
+        if (!TestPackageTransactions(package)) {
+            builder->Skip();
+            continue;
+        }
+
+        // This chunk will make it in; reset the failed counter.
+        nConsecutiveFailed = 0;
+
+        // Chunks are reported in linearization order, which is topologically valid.
+        for (const auto& it : sortedEntries) {
+            AddToBlock(it);
+        }
+        builder->Include();
+
+        ++nPackagesSelected;
+        pblocktemplate->m_package_feerates.emplace_back(packageFees, static_cast<int32_t>(packageSize));
+    }
+}
+
 void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t version, uint32_t timestamp, uint32_t nonce)
 {
     if (block.vtx.size() == 0) {
@@ -456,6 +528,7 @@ void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t
 std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainman,
                                                       KernelNotifications& kernel_notifications,
                                                       CTxMemPool* mempool,
+                                                      BlockTemplateCache* template_cache,
                                                       const std::unique_ptr<CBlockTemplate>& block_template,
                                                       const BlockWaitOptions& options,
                                                       const BlockAssembler::Options& assemble_options)
@@ -465,15 +538,31 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
     CAmount current_fees = -1;
 
     // Alternate waiting for a new tip and checking if fees have risen.
-    // The latter check is expensive so we only run it once per second.
+    // Without a template cache, the latter check is expensive so we only run
+    // it once per second. With one, we wait for the cache to assemble a new
+    // template instead, which it does after new tips and mempool additions,
+    // and still check at least once per tick.
     auto now{NodeClock::now()};
     const auto deadline = now + options.timeout;
     const MillisecondsDouble tick{1000};
     const bool allow_min_difficulty{chainman.GetParams().GetConsensus().fPowAllowMinDifficultyBlocks};
+    const bool wait_for_fees{options.fee_threshold < MAX_MONEY};
+    uint64_t assembled_count{template_cache ? template_cache->GetAssembledCount() : 0};
 
     do {
         bool tip_changed{false};
-        {
+        if (template_cache && wait_for_fees) {
+            const auto check_tip{[&] {
+                LOCK(kernel_notifications.m_tip_block_mutex);
+                const auto tip_block{kernel_notifications.TipBlock()};
+                tip_changed = Assume(tip_block) && tip_block != block_template->block.hashPrevBlock;
+            }};
+            check_tip();
+            if (!tip_changed) {
+                assembled_count = template_cache->WaitForAssembly(assembled_count, std::min(now + tick, deadline) - now);
+                check_tip();
+            }
+        } else {
             WAIT_LOCK(kernel_notifications.m_tip_block_mutex, lock);
             // Note that wait_until() checks the predicate before waiting
             kernel_notifications.m_tip_block_cv.wait_until(lock, std::min(now + tick, deadline), [&]() EXCLUSIVE_LOCKS_REQUIRED(kernel_notifications.m_tip_block_mutex) {
@@ -488,8 +577,8 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
         }
 
         if (chainman.m_interrupt) return nullptr;
-        // At this point the tip changed, a full tick went by or we reached
-        // the deadline.
+        // At this point the tip changed, a full tick went by, a new template
+        // was assembled or we reached the deadline.
 
         // Must release m_tip_block_mutex before locking cs_main, to avoid deadlocks.
         LOCK(::cs_main);
@@ -503,19 +592,18 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
         }
 
         /**
-         * We determine if fees increased compared to the previous template by generating
-         * a fresh template. There may be more efficient ways to determine how much
-         * (approximate) fees for the next block increased, perhaps more so after
-         * Cluster Mempool.
+         * We determine if fees increased compared to the previous template by
+         * getting a fresh template, from the cache if there is one.
          *
          * We'll also create a new template if the tip changed during this iteration.
          */
-        if (options.fee_threshold < MAX_MONEY || tip_changed) {
-            auto new_tmpl{BlockAssembler{
-                chainman.ActiveChainstate(),
-                mempool,
-                assemble_options}
-                              .CreateNewBlock()};
+        if (wait_for_fees || tip_changed) {
+            auto new_tmpl{template_cache ? template_cache->Get(assemble_options) :
+                                           BlockAssembler{
+                                               chainman.ActiveChainstate(),
+                                               mempool,
+                                               assemble_options}
+                                               .CreateNewBlock()};
 
             // If the tip changed, return the new template regardless of its fees.
             if (tip_changed) return new_tmpl;
@@ -542,6 +630,129 @@ std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainma
     return nullptr;
 }
 
+static bool SameAssemblerOptions(const BlockAssembler::Options& a, const BlockAssembler::Options& b)
+{
+    return a.use_mempool == b.use_mempool &&
+           a.block_reserved_weight == b.block_reserved_weight &&
+           a.coinbase_output_max_additional_sigops == b.coinbase_output_max_additional_sigops &&
+           a.coinbase_output_script == b.coinbase_output_script &&
+           a.nBlockMaxWeight == b.nBlockMaxWeight &&
+           a.blockMinFeeRate == b.blockMinFeeRate &&
+           a.test_block_validity == b.test_block_validity &&
+           a.print_modified_fee == b.print_modified_fee;
+}
+
+BlockTemplateCache::BlockTemplateCache(ChainstateManager& chainman, const CTxMemPool& mempool)
+    : m_chainman{chainman}, m_mempool{mempool} {}
+
+bool BlockTemplateCache::IsFresh(const Entry& entry) const
+{
+    AssertLockHeld(::cs_main);
+    AssertLockHeld(m_mutex);
+    const CBlockIndex* tip{m_chainman.ActiveChain().Tip()};
+    return tip && tip->GetBlockHash() == entry.block_template->block.hashPrevBlock &&
+           m_mempool.GetTransactionsUpdated() == entry.transactions_updated;
+}
+
+void BlockTemplateCache::Assemble(Entry& entry)
+{
+    AssertLockHeld(::cs_main);
+    AssertLockHeld(m_mutex);
+    // Read the counter first, so that changes made while assembling make the result stale.
+    const unsigned int transactions_updated{m_mempool.GetTransactionsUpdated()};
+    entry.block_template = BlockAssembler{m_chainman.ActiveChainstate(), &m_mempool, entry.options}.CreateNewBlock();
+    entry.transactions_updated = transactions_updated;
+    entry.assembled = MockableSteadyClock::now();
+    ++m_assembled_count;
+    m_assembled_cv.notify_all();
+}
+
+std::unique_ptr<CBlockTemplate> BlockTemplateCache::Get(const BlockAssembler::Options& options)
+{
+    if (!options.use_mempool) {
+        return BlockAssembler{m_chainman.ActiveChainstate(), &m_mempool, options}.CreateNewBlock();
+    }
+
+    LOCK2(::cs_main, m_mutex);
+    Expire();
+    const auto now{MockableSteadyClock::now()};
+    auto it{std::ranges::find_if(m_entries, [&](const Entry& e) { return SameAssemblerOptions(e.options, options); })};
+    if (it == m_entries.end()) {
+        Entry entry{.options = options};
+        Assemble(entry);
+        if (m_entries.size() >= MAX_CACHED_TEMPLATES) {
+            m_entries.erase(std::ranges::min_element(m_entries, {}, &Entry::last_requested));
+        }
+        it = m_entries.insert(m_entries.end(), std::move(entry));
+    } else if (!IsFresh(*it)) {
+        Assemble(*it);
+    }
+    it->last_requested = now;
+
+    auto block_template{std::make_unique<CBlockTemplate>(*it->block_template)};
+    if (it->assembled < now) {
+        UpdateTime(&block_template->block, m_chainman.GetConsensus(), m_chainman.ActiveChain().Tip());
+    }
+    return block_template;
+}
+
+uint64_t BlockTemplateCache::GetAssembledCount() const
+{
+    LOCK(m_mutex);
+    return m_assembled_count;
+}
+
+uint64_t BlockTemplateCache::WaitForAssembly(uint64_t known_count, MillisecondsDouble timeout)
+{
+    WAIT_LOCK(m_mutex, lock);
+    ++m_waiting;
+    m_assembled_cv.wait_for(lock, timeout, [&]() EXCLUSIVE_LOCKS_REQUIRED(m_mutex) {
+        AssertLockHeld(m_mutex);
+        return m_assembled_count > known_count;
+    });
+    --m_waiting;
+    return m_assembled_count;
+}
+
+void BlockTemplateCache::Expire()
+{
+    AssertLockHeld(m_mutex);
+    const auto now{MockableSteadyClock::now()};
+    std::erase_if(m_entries, [&](const Entry& entry) { return now > entry.last_requested + TEMPLATE_EXPIRY; });
+}
+
+void BlockTemplateCache::Refresh()
+{
+    LOCK2(::cs_main, m_mutex);
+    Expire();
+    for (Entry& entry : m_entries) {
+        if (IsFresh(entry)) continue;
+        try {
+            Assemble(entry);
+        } catch (const std::runtime_error& e) {
+            LogWarning("Failed to refresh block template: %s", e.what());
+        }
+    }
+}
+
+void BlockTemplateCache::TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence)
+{
+    {
+        LOCK(m_mutex);
+        // Without clients waiting for a better template, the next Get() reassembles it if needed.
+        if (m_waiting == 0) return;
+        const auto now{MockableSteadyClock::now()};
+        if (std::ranges::none_of(m_entries, [&](const Entry& e) { return now >= e.assembled + TEMPLATE_REFRESH_INTERVAL; })) return;
+    }
+    Refresh();
+}
+
+void BlockTemplateCache::UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload)
+{
+    if (fInitialDownload) return;
+    Refresh();
+}
+
 std::optional<BlockRef> GetTip(ChainstateManager& chainman)
 {
     LOCK(::cs_main);
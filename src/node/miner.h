@@ -10,12 +10,17 @@
 #include <node/types.h>
 #include <policy/policy.h>
 #include <primitives/block.h>
+#include <sync.h>
 #include <txmempool.h>
 #include <util/feefrac.h>
+#include <util/time.h>
+#include <validationinterface.h>
 
+#include <condition_variable>
 #include <cstdint>
 #include <memory>
 #include <optional>
+#include <vector>
 
 #include <boost/multi_index/identity.hpp>
 #include <boost/multi_index/indexed_by.hpp>
@@ -35,6 +40,7 @@ namespace Consensus { struct Params; };
 using interfaces::BlockRef;
 
 namespace node {
+class BlockTemplateCache;
 class KernelNotifications;
 
 static const bool DEFAULT_PRINT_MODIFIED_FEE = false;
@@ -205,6 +211,12 @@ private:
       * @pre BlockAssembler::m_mempool must not be nullptr
     */
     void addPackageTxs(int& nPackagesSelected, int& nDescendantsUpdated) EXCLUSIVE_LOCKS_REQUIRED(!m_mempool->cs);
+    /** Add transactions chunk by chunk, in the order of the mempool's cluster linearizations.
+      * Used by addPackageTxs() when every cluster in the mempool is linearized.
+      *
+      * @pre mempool.HaveClusterLinearizations()
+    */
+    void addChunkTxs(const CTxMemPool& mempool, int& nPackagesSelected) EXCLUSIVE_LOCKS_REQUIRED(mempool.cs);
 
     // helper functions for addPackageTxs()
     /** Remove confirmed (inBlock) entries from given set */
@@ -241,14 +253,88 @@ void AddMerkleRootAndCoinbase(CBlock& block, CTransactionRef coinbase, uint32_t
 /**
  * Return a new block template when fees rise to a certain threshold or after a
  * new tip; return nullopt if timeout is reached.
+ *
+ * If a template_cache is given, fee improvements are checked whenever it
+ * assembles a new template, rather than by assembling one every second.
  */
 std::unique_ptr<CBlockTemplate> WaitAndCreateNewBlock(ChainstateManager& chainman,
                                                       KernelNotifications& kernel_notifications,
                                                       CTxMemPool* mempool,
+                                                      BlockTemplateCache* template_cache,
                                                       const std::unique_ptr<CBlockTemplate>& block_template,
                                                       const BlockWaitOptions& options,
                                                       const BlockAssembler::Options& assemble_options);
 
+/**
+ * Keeps the most recently assembled block templates, and hands out copies of
+ * them for as long as neither the chain tip nor the mempool changed, so that
+ * clients polling for templates do not cause blocks to be reassembled every time.
+ *
+ * Cached templates are also reassembled in the background when the tip
+ * changes, so that requests following it can usually be answered from the
+ * cache too. While clients wait for better templates in WaitForAssembly(), they
+ * are also reassembled at most once every TEMPLATE_REFRESH_INTERVAL when
+ * transactions are added to the mempool, and the waiting clients are woken up
+ * whenever that happens. Only templates drawing from the mempool are cached,
+ * for up to MAX_CACHED_TEMPLATES distinct sets of options, and they are dropped
+ * once they have not been requested for TEMPLATE_EXPIRY.
+ */
+class BlockTemplateCache final : public CValidationInterface
+{
+public:
+    static constexpr std::chrono::milliseconds TEMPLATE_REFRESH_INTERVAL{500};
+    static constexpr size_t MAX_CACHED_TEMPLATES{4};
+    static constexpr std::chrono::seconds TEMPLATE_EXPIRY{60};
+
+    BlockTemplateCache(ChainstateManager& chainman, const CTxMemPool& mempool);
+
+    /** Return a block template for the given options, assembling a new one only if needed. */
+    std::unique_ptr<CBlockTemplate> Get(const BlockAssembler::Options& options) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Number of templates assembled so far. */
+    uint64_t GetAssembledCount() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /**
+     * Wait until more than known_count templates have been assembled, or until
+     * the timeout elapses. Returns the number of templates assembled so far.
+     */
+    uint64_t WaitForAssembly(uint64_t known_count, MillisecondsDouble timeout) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+protected:
+    void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t mempool_sequence) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+    void UpdatedBlockTip(const CBlockIndex* pindexNew, const CBlockIndex* pindexFork, bool fInitialDownload) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Entry {
+        BlockAssembler::Options options;
+        std::unique_ptr<CBlockTemplate> block_template{};
+        //! Value of CTxMemPool::GetTransactionsUpdated() before the template was assembled.
+        unsigned int transactions_updated{0};
+        MockableSteadyClock::time_point assembled{};
+        MockableSteadyClock::time_point last_requested{};
+    };
+
+    ChainstateManager& m_chainman;
+    const CTxMemPool& m_mempool;
+
+    // Always acquired after cs_main, since templates are assembled while holding both.
+    mutable Mutex m_mutex;
+    std::condition_variable m_assembled_cv GUARDED_BY(m_mutex);
+    std::vector<Entry> m_entries GUARDED_BY(m_mutex);
+    uint64_t m_assembled_count GUARDED_BY(m_mutex){0};
+    //! Number of clients currently in WaitForAssembly().
+    size_t m_waiting GUARDED_BY(m_mutex){0};
+
+    /** Whether the cached template is still what BlockAssembler would produce. */
+    bool IsFresh(const Entry& entry) const EXCLUSIVE_LOCKS_REQUIRED(::cs_main, m_mutex);
+    /** Assemble a new template with the options of the given entry. */
+    void Assemble(Entry& entry) EXCLUSIVE_LOCKS_REQUIRED(::cs_main, m_mutex);
+    /** Drop cached templates that were not requested for TEMPLATE_EXPIRY. */
+    void Expire() EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+    /** Reassemble cached templates that are no longer fresh. */
+    void Refresh() EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+};
+
 /* Locks cs_main and returns the block hash and block height of the active chain if it exists; otherwise, returns nullopt.*/
 std::optional<BlockRef> GetTip(ChainstateManager& chainman);
 
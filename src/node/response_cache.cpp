@@ -0,0 +1,83 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <node/response_cache.h>
+
+#include <chain.h>
+
+#include <iterator>
+#include <type_traits>
+#include <utility>
+
+namespace node {
+
+/** Rough estimate of the memory used by a JSON value. */
+// NOLINTNEXTLINE(misc-no-recursion)
+static size_t JSONMemoryUsage(const UniValue& value)
+{
+    size_t usage{sizeof(UniValue) + value.getValStr().size()};
+    if (value.isObject()) {
+        for (const std::string& key : value.getKeys()) usage += sizeof(std::string) + key.size();
+    }
+    if (value.isObject() || value.isArray()) {
+        for (const UniValue& child : value.getValues()) usage += JSONMemoryUsage(child);
+    }
+    return usage;
+}
+
+std::shared_ptr<const ResponseCache::Response> ResponseCache::Get(const CChain& chain, const std::string& key)
+{
+    AssertLockHeld(::cs_main);
+    LOCK(m_mutex);
+    const auto it{m_index.find(key)};
+    if (it == m_index.end()) return nullptr;
+    // The entry may be from before a reorg whose BlockDisconnected notification is still pending
+    if (!chain.Contains(it->second->block)) return nullptr;
+    m_entries.splice(m_entries.begin(), m_entries, it->second);
+    return it->second->response;
+}
+
+void ResponseCache::Put(const CBlockIndex& block, std::string key, Response response)
+{
+    const size_t size{sizeof(Entry) + 2 * key.size() + std::visit([](const auto& r) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(r)>, UniValue>) {
+            return JSONMemoryUsage(r);
+        } else {
+            return r.size();
+        }
+    }, response)};
+    if (size > m_max_size / 4) return;
+
+    LOCK(m_mutex);
+    if (const auto it{m_index.find(key)}; it != m_index.end()) Erase(it->second);
+    m_entries.push_front({std::move(key), &block, std::make_shared<const Response>(std::move(response)), size});
+    m_index.emplace(m_entries.front().key, m_entries.begin());
+    m_size += size;
+    while (m_size > m_max_size) Erase(std::prev(m_entries.end()));
+}
+
+size_t ResponseCache::GetSize() const
+{
+    return WITH_LOCK(m_mutex, return m_size);
+}
+
+void ResponseCache::BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex)
+{
+    LOCK(m_mutex);
+    for (auto it{m_entries.begin()}; it != m_entries.end();) {
+        // Responses depending on the disconnected block or its descendants are stale
+        const auto next{std::next(it)};
+        if (it->block->nHeight >= pindex->nHeight) Erase(it);
+        it = next;
+    }
+}
+
+void ResponseCache::Erase(std::list<Entry>::iterator it)
+{
+    m_size -= it->size;
+    m_index.erase(it->key);
+    m_entries.erase(it);
+}
+
+} // namespace node
@@ -0,0 +1,85 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_NODE_RESPONSE_CACHE_H
+#define BITCOIN_NODE_RESPONSE_CACHE_H
+
+#include <kernel/cs_main.h>
+#include <sync.h>
+#include <threadsafety.h>
+#include <univalue.h>
+#include <validationinterface.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <variant>
+
+class CBlock;
+class CBlockIndex;
+class CChain;
+
+namespace node {
+//! Default for -rpccachesize, in MiB. The cache is disabled by default.
+static constexpr int64_t DEFAULT_RPC_CACHE_SIZE{0};
+
+/**
+ * Cache of RPC results and REST replies for data that does not change as long as
+ * the block it was derived from stays in the active chain, such as the contents
+ * of a buried block or a confirmed transaction. Responses are keyed by a string
+ * naming the method, its parameters and the format.
+ *
+ * A response is only returned while its block is in the active chain, and is
+ * dropped when that block is disconnected. The least recently used responses are
+ * evicted once their total size exceeds the limit.
+ */
+class ResponseCache final : public CValidationInterface
+{
+public:
+    //! An RPC result, or the body of a REST reply
+    using Response = std::variant<UniValue, std::string>;
+
+    explicit ResponseCache(size_t max_size) : m_max_size{max_size} {}
+
+    /** Return the response cached for key, if the block it depends on is in chain. */
+    std::shared_ptr<const Response> Get(const CChain& chain, const std::string& key) EXCLUSIVE_LOCKS_REQUIRED(::cs_main, !m_mutex);
+
+    /**
+     * Cache a response that stays the same as long as block is in the active chain.
+     * Responses larger than a quarter of the cache are not cached.
+     */
+    void Put(const CBlockIndex& block, std::string key, Response response) EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+    /** Approximate memory used by the cached responses. */
+    size_t GetSize() const EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+protected:
+    void BlockDisconnected(const std::shared_ptr<const CBlock>& block, const CBlockIndex* pindex) override EXCLUSIVE_LOCKS_REQUIRED(!m_mutex);
+
+private:
+    struct Entry {
+        std::string key;
+        const CBlockIndex* block;
+        std::shared_ptr<const Response> response;
+        size_t size;
+    };
+
+    const size_t m_max_size;
+
+    mutable Mutex m_mutex;
+    //! Cached responses, most recently used first
+    std::list<Entry> m_entries GUARDED_BY(m_mutex);
+    //! Entries by key, pointing into the keys of m_entries
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> m_index GUARDED_BY(m_mutex);
+    size_t m_size GUARDED_BY(m_mutex){0};
+
+    void Erase(std::list<Entry>::iterator it) EXCLUSIVE_LOCKS_REQUIRED(m_mutex);
+};
+} // namespace node
+
+#endif // BITCOIN_NODE_RESPONSE_CACHE_H
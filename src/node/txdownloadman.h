@@ -11,6 +11,8 @@
 
 #include <cstdint>
 #include <memory>
+#include <span>
+#include <vector>
 
 class CBlock;
 class CRollingBloomFilter;
@@ -137,6 +139,11 @@ public:
      * Returns true if this was a dropped inv (p2p_inv=true and we already have the tx), false otherwise. */
     bool AddTxAnnouncement(NodeId peer, const GenTxid& gtxid, std::chrono::microseconds now);
 
+    /** Consider adding a batch of tx hashes received from one peer (e.g. a whole inv message) to txrequest.
+     * Equivalent to calling AddTxAnnouncement for each of them in order, but updates txrequest in a single
+     * batch. Returns, for each of gtxids, whether it was a dropped inv. */
+    std::vector<bool> AddTxAnnouncements(NodeId peer, std::span<const GenTxid> gtxids, std::chrono::microseconds now);
+
     /** Get getdata requests to send. */
     std::vector<GenTxid> GetRequestsToSend(NodeId nodeid, std::chrono::microseconds current_time);
 
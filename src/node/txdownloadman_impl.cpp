@@ -43,6 +43,10 @@ bool TxDownloadManager::AddTxAnnouncement(NodeId peer, const GenTxid& gtxid, std
 {
     return m_impl->AddTxAnnouncement(peer, gtxid, now);
 }
+std::vector<bool> TxDownloadManager::AddTxAnnouncements(NodeId peer, std::span<const GenTxid> gtxids, std::chrono::microseconds now)
+{
+    return m_impl->AddTxAnnouncements(peer, gtxids, now);
+}
 std::vector<GenTxid> TxDownloadManager::GetRequestsToSend(NodeId nodeid, std::chrono::microseconds current_time)
 {
     return m_impl->GetRequestsToSend(nodeid, current_time);
@@ -169,43 +173,58 @@ void TxDownloadManagerImpl::DisconnectedPeer(NodeId nodeid)
 
 bool TxDownloadManagerImpl::AddTxAnnouncement(NodeId peer, const GenTxid& gtxid, std::chrono::microseconds now)
 {
-    // If this is an orphan we are trying to resolve, consider this peer as a orphan resolution candidate instead.
-    // - is wtxid matching something in orphanage
-    // - exists in orphanage
-    // - peer can be an orphan resolution candidate
-    if (const auto* wtxid = std::get_if<Wtxid>(&gtxid)) {
-        if (auto orphan_tx{m_orphanage->GetTx(*wtxid)}) {
-            auto unique_parents{GetUniqueParents(*orphan_tx)};
-            std::erase_if(unique_parents, [&](const auto& txid) {
-                return AlreadyHaveTx(txid, /*include_reconsiderable=*/false);
-            });
-
-            // The missing parents may have all been rejected or accepted since the orphan was added to the orphanage.
-            // Do not delete from the orphanage, as it may be queued for processing.
-            if (unique_parents.empty()) {
-                return true;
-            }
+    return AddTxAnnouncements(peer, std::span{&gtxid, 1}, now).front();
+}
 
-            if (MaybeAddOrphanResolutionCandidate(unique_parents, *wtxid, peer, now)) {
-                m_orphanage->AddAnnouncer(orphan_tx->GetWitnessHash(), peer);
+std::vector<bool> TxDownloadManagerImpl::AddTxAnnouncements(NodeId peer, std::span<const GenTxid> gtxids, std::chrono::microseconds now)
+{
+    std::vector<bool> dropped(gtxids.size(), false);
+    std::vector<GenTxid> to_add;
+    to_add.reserve(gtxids.size());
+    for (size_t i = 0; i < gtxids.size(); ++i) {
+        const GenTxid& gtxid{gtxids[i]};
+        // If this is an orphan we are trying to resolve, consider this peer as a orphan resolution candidate instead.
+        // - is wtxid matching something in orphanage
+        // - exists in orphanage
+        // - peer can be an orphan resolution candidate
+        if (const auto* wtxid = std::get_if<Wtxid>(&gtxid)) {
+            if (auto orphan_tx{m_orphanage->GetTx(*wtxid)}) {
+                auto unique_parents{GetUniqueParents(*orphan_tx)};
+                std::erase_if(unique_parents, [&](const auto& txid) {
+                    return AlreadyHaveTx(txid, /*include_reconsiderable=*/false);
+                });
+
+                // The missing parents may have all been rejected or accepted since the orphan was added to the orphanage.
+                // Do not delete from the orphanage, as it may be queued for processing.
+                if (!unique_parents.empty() && MaybeAddOrphanResolutionCandidate(unique_parents, *wtxid, peer, now)) {
+                    m_orphanage->AddAnnouncer(orphan_tx->GetWitnessHash(), peer);
+                }
+
+                // Drop even if the peer isn't an orphan resolution candidate. This would be caught by AlreadyHaveTx.
+                dropped[i] = true;
+                continue;
             }
+        }
 
-            // Return even if the peer isn't an orphan resolution candidate. This would be caught by AlreadyHaveTx.
-            return true;
+        // If this is an inv received from a peer and we already have it, we can drop it.
+        if (AlreadyHaveTx(gtxid, /*include_reconsiderable=*/true)) {
+            dropped[i] = true;
+            continue;
         }
+        to_add.push_back(gtxid);
     }
-
-    // If this is an inv received from a peer and we already have it, we can drop it.
-    if (AlreadyHaveTx(gtxid, /*include_reconsiderable=*/true)) return true;
+    if (to_add.empty()) return dropped;
 
     auto it = m_peer_info.find(peer);
-    if (it == m_peer_info.end()) return false;
+    if (it == m_peer_info.end()) return dropped;
     const auto& info = it->second.m_connection_info;
-    if (!info.m_relay_permissions && m_txrequest.Count(peer) >= MAX_PEER_TX_ANNOUNCEMENTS) {
-        // Too many queued announcements for this peer
-        return false;
+    if (!info.m_relay_permissions) {
+        // Only accept as many announcements as fit within the per-peer limit.
+        const size_t limit{MAX_PEER_TX_ANNOUNCEMENTS};
+        const size_t count{m_txrequest.Count(peer)};
+        to_add.resize(count >= limit ? 0 : std::min(to_add.size(), limit - count));
     }
-    // Decide the TxRequestTracker parameters for this announcement:
+    // Decide the TxRequestTracker parameters for these announcements:
     // - "preferred": if fPreferredDownload is set (= outbound, or NetPermissionFlags::NoBan permission)
     // - "reqtime": current time plus delays for:
     //   - NONPREF_PEER_TX_DELAY for announcements from non-preferred connections
@@ -214,13 +233,21 @@ bool TxDownloadManagerImpl::AddTxAnnouncement(NodeId peer, const GenTxid& gtxid,
     //     MAX_PEER_TX_REQUEST_IN_FLIGHT requests in flight (and don't have NetPermissionFlags::Relay).
     auto delay{0us};
     if (!info.m_preferred) delay += NONPREF_PEER_TX_DELAY;
-    if (!gtxid.IsWtxid() && m_num_wtxid_peers > 0) delay += TXID_RELAY_DELAY;
     const bool overloaded = !info.m_relay_permissions && m_txrequest.CountInFlight(peer) >= MAX_PEER_TX_REQUEST_IN_FLIGHT;
     if (overloaded) delay += OVERLOADED_PEER_TX_DELAY;
 
-    m_txrequest.ReceivedInv(peer, gtxid, info.m_preferred, now + delay);
+    // Hand the announcements to txrequest in runs that share the same reqtime.
+    std::span<const GenTxid> remaining{to_add};
+    while (!remaining.empty()) {
+        const bool is_wtxid{remaining.front().IsWtxid()};
+        const auto run_end{std::ranges::find_if(remaining, [&](const GenTxid& gtxid) { return gtxid.IsWtxid() != is_wtxid; })};
+        const auto run{remaining.first(run_end - remaining.begin())};
+        const auto txid_delay{!is_wtxid && m_num_wtxid_peers > 0 ? TXID_RELAY_DELAY : 0us};
+        m_txrequest.ReceivedInvs(peer, run, info.m_preferred, now + delay + txid_delay);
+        remaining = remaining.subspan(run.size());
+    }
 
-    return false;
+    return dropped;
 }
 
 bool TxDownloadManagerImpl::MaybeAddOrphanResolutionCandidate(const std::vector<Txid>& unique_parents, const Wtxid& wtxid, NodeId nodeid, std::chrono::microseconds now)
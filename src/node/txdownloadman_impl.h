@@ -165,6 +165,9 @@ public:
      */
     bool AddTxAnnouncement(NodeId peer, const GenTxid& gtxid, std::chrono::microseconds now);
 
+    /** Batched version of AddTxAnnouncement for all announcements of one inv message. */
+    std::vector<bool> AddTxAnnouncements(NodeId peer, std::span<const GenTxid> gtxids, std::chrono::microseconds now);
+
     /** Get getdata requests to send. */
     std::vector<GenTxid> GetRequestsToSend(NodeId nodeid, std::chrono::microseconds current_time);
 
@@ -5,15 +5,26 @@
 #include <node/txreconciliation.h>
 
 #include <common/system.h>
+#include <crypto/siphash.h>
 #include <logging.h>
+#include <node/minisketchwrapper.h>
 #include <util/check.h>
 
+#include <algorithm>
+#include <limits>
+#include <set>
 #include <unordered_map>
+#include <unordered_set>
 #include <variant>
 
 
 namespace {
 
+/** Size in bits of the short txids used in sketches, see BIP-330. */
+constexpr uint32_t RECON_FIELD_SIZE{32};
+/** Sketch capacity is chosen so that a decoded difference is wrong with probability at most 2^-16. */
+constexpr uint32_t RECON_FALSE_POSITIVE_COEF{16};
+
 /** Static salt component used to compute short txids for sketch construction, see BIP-330. */
 const std::string RECON_STATIC_SALT = "Tx Relay Salting";
 const HashWriter RECON_SALT_HASHER = TaggedHash(RECON_STATIC_SALT);
@@ -29,6 +40,20 @@ uint256 ComputeSalt(uint64_t salt1, uint64_t salt2)
     return (HashWriter(RECON_SALT_HASHER) << std::min(salt1, salt2) << std::max(salt1, salt2)).GetSHA256();
 }
 
+/**
+ * Estimate the capacity of the sketch needed to decode the difference between two sets of the
+ * given sizes (see BIP-330), with enough extra capacity to keep the probability of decoding a
+ * wrong difference below 2^-RECON_FALSE_POSITIVE_COEF.
+ */
+size_t EstimateSketchCapacity(size_t local_set_size, size_t remote_set_size, uint16_t q)
+{
+    const size_t set_size_diff{local_set_size > remote_set_size ? local_set_size - remote_set_size : remote_set_size - local_set_size};
+    const size_t min_size{std::min(local_set_size, remote_set_size)};
+    const size_t weighted_min_size{min_size * q / Q_PRECISION};
+    const size_t estimated_diff{set_size_diff + weighted_min_size + 1};
+    return std::min(Minisketch::ComputeCapacity(RECON_FIELD_SIZE, estimated_diff, RECON_FALSE_POSITIVE_COEF), MAX_SKETCH_CAPACITY);
+}
+
 /**
  * Keeps track of txreconciliation-related per-peer state.
  */
@@ -36,9 +61,6 @@ class TxReconciliationState
 {
 public:
     /**
-     * TODO: This field is public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * Reconciliation protocol assumes using one role consistently: either a reconciliation
      * initiator (requesting sketches), or responder (sending sketches). This defines our role,
      * based on the direction of the p2p connection.
@@ -47,14 +69,46 @@ public:
     bool m_we_initiate;
 
     /**
-     * TODO: These fields are public to ignore -Wunused-private-field. Make private once used in
-     * the following commits.
-     *
      * These values are used to salt short IDs, which is necessary for transaction reconciliations.
      */
     uint64_t m_k0, m_k1;
 
+    /** Transactions we want to announce to the peer at the next reconciliation. */
+    std::set<Wtxid> m_local_set;
+
+    /**
+     * As a responder, the set we sent a sketch of, kept until the initiator tells us which
+     * transactions from it to announce.
+     */
+    std::set<Wtxid> m_local_set_snapshot;
+
+    /** As an initiator, whether we sent a reqrecon and are waiting for the peer's sketch. */
+    bool m_awaiting_sketch{false};
+
+    /** As a responder, whether we sent a sketch and are waiting for the peer's reconcildiff. */
+    bool m_awaiting_diff{false};
+
+    /** As an initiator, when we should send the next reqrecon. */
+    std::chrono::microseconds m_next_request_time{0};
+
     TxReconciliationState(bool we_initiate, uint64_t k0, uint64_t k1) : m_we_initiate(we_initiate), m_k0(k0), m_k1(k1) {}
+
+    /** Compute the 32-bit short ID of a transaction used in sketches, see BIP-330. */
+    uint32_t ComputeShortID(const Wtxid& wtxid) const
+    {
+        const uint64_t s{SipHashUint256(m_k0, m_k1, wtxid.ToUint256())};
+        return 1 + uint32_t(s % 0xFFFFFFFF);
+    }
+
+    /** Build a sketch of the given capacity over a set of transactions. */
+    Minisketch ComputeSketch(const std::set<Wtxid>& set, size_t capacity) const
+    {
+        Minisketch sketch{node::MakeMinisketch32(capacity)};
+        for (const auto& wtxid : set) {
+            sketch.Add(ComputeShortID(wtxid));
+        }
+        return sketch;
+    }
 };
 
 } // namespace
@@ -76,6 +130,9 @@ private:
      */
     std::unordered_map<NodeId, std::variant<uint64_t, TxReconciliationState>> m_states GUARDED_BY(m_txreconciliation_mutex);
 
+    /** Salt used to pick the outbound peers each transaction is flooded to. */
+    const uint64_t m_fanout_k0{FastRandomContext().rand64()}, m_fanout_k1{FastRandomContext().rand64()};
+
 public:
     explicit Impl(uint32_t recon_version) : m_recon_version(recon_version) {}
 
@@ -142,6 +199,162 @@ public:
         return (recon_state != m_states.end() &&
                 std::holds_alternative<TxReconciliationState>(recon_state->second));
     }
+
+    bool IsFanoutTarget(NodeId peer_id, const Wtxid& wtxid) const EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        const auto is_outbound = [](const auto& state) {
+            const auto* peer_state{std::get_if<TxReconciliationState>(&state)};
+            return peer_state && peer_state->m_we_initiate;
+        };
+        const auto rank = [&](NodeId id) { return SipHashUint256Extra(m_fanout_k0, m_fanout_k1, wtxid.ToUint256(), uint32_t(id)); };
+
+        const auto recon_state{m_states.find(peer_id)};
+        if (recon_state == m_states.end() || !is_outbound(recon_state->second)) return false;
+        // The transaction is flooded to the outbound peers with the lowest ranks.
+        const uint64_t peer_rank{rank(peer_id)};
+        size_t lower_ranked{0};
+        for (const auto& [id, state] : m_states) {
+            if (id == peer_id || !is_outbound(state) || rank(id) > peer_rank) continue;
+            if (++lower_ranked >= OUTBOUND_FANOUT_DESTINATIONS) return false;
+        }
+        return true;
+    }
+
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || peer_state->m_local_set.size() >= MAX_RECONSET_SIZE) return false;
+        peer_state->m_local_set.insert(wtxid);
+        return true;
+    }
+
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state{GetRegisteredPeerState(peer_id)};
+        return peer_state && peer_state->m_local_set.erase(wtxid) > 0;
+    }
+
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || !peer_state->m_we_initiate || peer_state->m_awaiting_sketch) return std::nullopt;
+        if (peer_state->m_next_request_time > now) return std::nullopt;
+
+        peer_state->m_next_request_time = now + RECON_REQUEST_INTERVAL;
+        peer_state->m_awaiting_sketch = true;
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Initiate reconciliation with peer=%d with the following params: local_set_size=%i\n",
+                      peer_id, peer_state->m_local_set.size());
+        // MAX_RECONSET_SIZE fits in 16 bits, so the set size does not need clamping.
+        static_assert(MAX_RECONSET_SIZE <= std::numeric_limits<uint16_t>::max());
+        return std::make_pair(uint16_t(peer_state->m_local_set.size()), uint16_t(RECON_Q * Q_PRECISION));
+    }
+
+    std::optional<std::vector<uint8_t>> HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || peer_state->m_we_initiate || peer_state->m_awaiting_diff) return std::nullopt;
+
+        peer_state->m_local_set_snapshot = std::move(peer_state->m_local_set);
+        peer_state->m_local_set.clear();
+        peer_state->m_awaiting_diff = true;
+
+        // An empty sketch tells the initiator that we have nothing to offer.
+        std::vector<uint8_t> skdata;
+        if (!peer_state->m_local_set_snapshot.empty()) {
+            const size_t capacity{EstimateSketchCapacity(peer_state->m_local_set_snapshot.size(), peer_recon_set_size, peer_q)};
+            skdata = peer_state->ComputeSketch(peer_state->m_local_set_snapshot, capacity).Serialize();
+        }
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Respond to reconciliation request from peer=%d with a sketch of %u bytes (local_set_size=%i, remote_set_size=%i)\n",
+                      peer_id, skdata.size(), peer_state->m_local_set_snapshot.size(), peer_recon_set_size);
+        return skdata;
+    }
+
+    std::optional<ReconciliationOutcome> HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || !peer_state->m_we_initiate || !peer_state->m_awaiting_sketch) return std::nullopt;
+        if (skdata.size() % BYTES_PER_SKETCH_CAPACITY != 0) return std::nullopt;
+        const size_t remote_capacity{skdata.size() / BYTES_PER_SKETCH_CAPACITY};
+        if (remote_capacity > MAX_SKETCH_CAPACITY) return std::nullopt;
+        peer_state->m_awaiting_sketch = false;
+
+        ReconciliationOutcome outcome{.success = true, .ask_shortids = {}, .announce = {}};
+        if (remote_capacity == 0) {
+            // The peer has nothing to offer, so it is missing our whole set.
+            outcome.announce.assign(peer_state->m_local_set.begin(), peer_state->m_local_set.end());
+        } else {
+            Minisketch remote_sketch{node::MakeMinisketch32(remote_capacity)};
+            remote_sketch.Deserialize(skdata);
+            const auto differences{peer_state->ComputeSketch(peer_state->m_local_set, remote_capacity).Merge(remote_sketch).DecodeFP(RECON_FALSE_POSITIVE_COEF)};
+            if (!differences) {
+                // The difference is larger than the sketch capacity. Without sketch extensions,
+                // fall back to announcing our whole set.
+                outcome.success = false;
+                outcome.announce.assign(peer_state->m_local_set.begin(), peer_state->m_local_set.end());
+            } else {
+                std::unordered_map<uint32_t, Wtxid> local_shortids;
+                local_shortids.reserve(peer_state->m_local_set.size());
+                for (const auto& wtxid : peer_state->m_local_set) {
+                    local_shortids.emplace(peer_state->ComputeShortID(wtxid), wtxid);
+                }
+                for (const uint64_t diff : *differences) {
+                    const auto it{local_shortids.find(uint32_t(diff))};
+                    if (it != local_shortids.end()) {
+                        outcome.announce.push_back(it->second);
+                    } else {
+                        outcome.ask_shortids.push_back(uint32_t(diff));
+                    }
+                }
+            }
+        }
+        LogPrintLevel(BCLog::TXRECONCILIATION, BCLog::Level::Debug, "Reconciliation with peer=%d %s: %u to announce, %u to request\n",
+                      peer_id, outcome.success ? "succeeded" : "failed", outcome.announce.size(), outcome.ask_shortids.size());
+        peer_state->m_local_set.clear();
+        return outcome;
+    }
+
+    std::optional<std::vector<Wtxid>> HandleReconciliationDifference(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids) EXCLUSIVE_LOCKS_REQUIRED(!m_txreconciliation_mutex)
+    {
+        AssertLockNotHeld(m_txreconciliation_mutex);
+        LOCK(m_txreconciliation_mutex);
+        auto* peer_state{GetRegisteredPeerState(peer_id)};
+        if (!peer_state || peer_state->m_we_initiate || !peer_state->m_awaiting_diff) return std::nullopt;
+        if (ask_shortids.size() > MAX_SKETCH_CAPACITY) return std::nullopt;
+        peer_state->m_awaiting_diff = false;
+
+        std::vector<Wtxid> announce;
+        if (!success) {
+            announce.assign(peer_state->m_local_set_snapshot.begin(), peer_state->m_local_set_snapshot.end());
+        } else if (!ask_shortids.empty()) {
+            const std::unordered_set<uint32_t> asked(ask_shortids.begin(), ask_shortids.end());
+            for (const auto& wtxid : peer_state->m_local_set_snapshot) {
+                if (asked.contains(peer_state->ComputeShortID(wtxid))) announce.push_back(wtxid);
+            }
+        }
+        peer_state->m_local_set_snapshot.clear();
+        return announce;
+    }
+
+private:
+    TxReconciliationState* GetRegisteredPeerState(NodeId peer_id) EXCLUSIVE_LOCKS_REQUIRED(m_txreconciliation_mutex)
+    {
+        AssertLockHeld(m_txreconciliation_mutex);
+        auto recon_state = m_states.find(peer_id);
+        if (recon_state == m_states.end()) return nullptr;
+        return std::get_if<TxReconciliationState>(&recon_state->second);
+    }
 };
 
 TxReconciliationTracker::TxReconciliationTracker(uint32_t recon_version) : m_impl{std::make_unique<TxReconciliationTracker::Impl>(recon_version)} {}
@@ -168,3 +381,38 @@ bool TxReconciliationTracker::IsPeerRegistered(NodeId peer_id) const
 {
     return m_impl->IsPeerRegistered(peer_id);
 }
+
+bool TxReconciliationTracker::IsFanoutTarget(NodeId peer_id, const Wtxid& wtxid) const
+{
+    return m_impl->IsFanoutTarget(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::AddToSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->AddToSet(peer_id, wtxid);
+}
+
+bool TxReconciliationTracker::TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid)
+{
+    return m_impl->TryRemovingFromSet(peer_id, wtxid);
+}
+
+std::optional<std::pair<uint16_t, uint16_t>> TxReconciliationTracker::InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now)
+{
+    return m_impl->InitiateReconciliationRequest(peer_id, now);
+}
+
+std::optional<std::vector<uint8_t>> TxReconciliationTracker::HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q)
+{
+    return m_impl->HandleReconciliationRequest(peer_id, peer_recon_set_size, peer_q);
+}
+
+std::optional<ReconciliationOutcome> TxReconciliationTracker::HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata)
+{
+    return m_impl->HandleSketch(peer_id, skdata);
+}
+
+std::optional<std::vector<Wtxid>> TxReconciliationTracker::HandleReconciliationDifference(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids)
+{
+    return m_impl->HandleReconciliationDifference(peer_id, success, ask_shortids);
+}
@@ -6,13 +6,33 @@
 #define BITCOIN_NODE_TXRECONCILIATION_H
 
 #include <net.h>
+#include <primitives/transaction_identifier.h>
 #include <sync.h>
 
+#include <chrono>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <span>
 #include <tuple>
+#include <vector>
 
 /** Supported transaction reconciliation protocol version */
 static constexpr uint32_t TXRECONCILIATION_VERSION{1};
+/** Maximum number of transactions we keep in a peer's reconciliation set. Beyond this, transactions are flooded. */
+static constexpr size_t MAX_RECONSET_SIZE{3000};
+/** How often we request a reconciliation from each peer we initiate reconciliations with. */
+static constexpr std::chrono::microseconds RECON_REQUEST_INTERVAL{std::chrono::seconds{8}};
+/** Coefficient used to estimate the set difference from the set sizes, see BIP-330. */
+static constexpr double RECON_Q{0.25};
+/** Fixed-point precision of the q coefficient as sent in reqrecon messages, see BIP-330. */
+static constexpr uint16_t Q_PRECISION{(2 << 14) - 1};
+/** Maximum capacity of a sketch we are willing to send or decode. */
+static constexpr size_t MAX_SKETCH_CAPACITY{2 << 12};
+/** Sketches use 32-bit elements, so each unit of capacity takes 4 bytes. */
+static constexpr size_t BYTES_PER_SKETCH_CAPACITY{4};
+/** Number of outbound peers we reconcile with that still get each transaction flooded to them, see BIP-330. */
+static constexpr size_t OUTBOUND_FANOUT_DESTINATIONS{1};
 
 enum class ReconciliationRegisterResult {
     NOT_FOUND,
@@ -21,6 +41,16 @@ enum class ReconciliationRegisterResult {
     PROTOCOL_VIOLATION,
 };
 
+/** What the initiator learnt from a peer's sketch, see TxReconciliationTracker::HandleSketch. */
+struct ReconciliationOutcome {
+    //! Whether the set difference could be decoded from the sketches
+    bool success;
+    //! Short IDs of transactions the peer has and we are missing (sent back in reconcildiff)
+    std::vector<uint32_t> ask_shortids;
+    //! Transactions from our set that the peer is missing and should be announced to it
+    std::vector<Wtxid> announce;
+};
+
 /**
  * Transaction reconciliation is a way for nodes to efficiently announce transactions.
  * This object keeps track of all txreconciliation-related communications with the peers.
@@ -47,6 +77,9 @@ enum class ReconciliationRegisterResult {
  * This is a modification of the Erlay protocol (https://arxiv.org/abs/1905.10518) with two
  * changes (sketch extensions instead of bisections, and an extra INV exchange round), both
  * are motivated in BIP-330.
+ *
+ * Sketch extensions are not implemented yet: a failed initial reconciliation is treated as a
+ * FAILURE straight away.
  */
 class TxReconciliationTracker
 {
@@ -84,6 +117,54 @@ public:
      * Check if a peer is registered to reconcile transactions with us.
      */
     bool IsPeerRegistered(NodeId peer_id) const;
+
+    /**
+     * Step 1. Whether a transaction should be flooded to a peer we reconcile with instead of being
+     * added to its set. Each transaction is flooded to OUTBOUND_FANOUT_DESTINATIONS of the outbound
+     * peers we reconcile with, chosen by a salted hash of the transaction and the peer, so that it
+     * keeps propagating quickly while reconciliation reaches everybody else.
+     */
+    bool IsFanoutTarget(NodeId peer_id, const Wtxid& wtxid) const;
+
+    /**
+     * Step 1. Add a transaction to the peer's reconciliation set instead of announcing it.
+     * Returns false if the peer is not registered or its set is full, in which case the
+     * transaction should be flooded instead.
+     */
+    bool AddToSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Remove a transaction from the peer's reconciliation set, e.g. because the peer announced it
+     * to us. Returns whether the transaction was in the set.
+     */
+    bool TryRemovingFromSet(NodeId peer_id, const Wtxid& wtxid);
+
+    /**
+     * Step 2. If we are the initiator for this peer and it is time to reconcile, returns the
+     * (set size, q) pair to send in a reqrecon message and starts waiting for the peer's sketch.
+     */
+    std::optional<std::pair<uint16_t, uint16_t>> InitiateReconciliationRequest(NodeId peer_id, std::chrono::microseconds now);
+
+    /**
+     * Step 2 (responder). Handle a reqrecon message: snapshot our reconciliation set for the peer
+     * and return the serialized sketch to send back. Returns std::nullopt if the peer is not
+     * allowed to request a reconciliation right now (a protocol violation).
+     */
+    std::optional<std::vector<uint8_t>> HandleReconciliationRequest(NodeId peer_id, uint16_t peer_recon_set_size, uint16_t peer_q);
+
+    /**
+     * Step 3. Handle a sketch message by combining it with a sketch of our own set. On return,
+     * our set for the peer is cleared. Returns std::nullopt if we did not request the sketch or
+     * it is malformed (a protocol violation).
+     */
+    std::optional<ReconciliationOutcome> HandleSketch(NodeId peer_id, std::span<const uint8_t> skdata);
+
+    /**
+     * Step 4 (responder). Handle a reconcildiff message, returning the transactions from the
+     * snapshot taken in HandleReconciliationRequest that should be announced to the peer.
+     * Returns std::nullopt if we are not expecting a reconcildiff (a protocol violation).
+     */
+    std::optional<std::vector<Wtxid>> HandleReconciliationDifference(NodeId peer_id, bool success, std::span<const uint32_t> ask_shortids);
 };
 
 #endif // BITCOIN_NODE_TXRECONCILIATION_H
@@ -530,6 +530,8 @@ bool CBlockPolicyEstimator::_removeTx(const Txid& hash, bool inBlock)
     AssertLockHeld(m_cs_fee_estimator);
     std::map<Txid, TxStatsInfo>::iterator pos = mapMemPoolTxs.find(hash);
     if (pos != mapMemPoolTxs.end()) {
+        // Transactions from the current height are not counted by any estimate yet.
+        if (pos->second.blockHeight < nBestSeenHeight) ClearCachedEstimates();
         feeStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         shortStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
         longStats->removeTx(pos->second.blockHeight, nBestSeenHeight, pos->second.bucketIndex, inBlock);
@@ -713,6 +715,14 @@ void CBlockPolicyEstimator::processBlock(const std::vector<RemovedMempoolTransac
 
     trackedTxs = 0;
     untrackedTxs = 0;
+    ClearCachedEstimates();
+}
+
+void CBlockPolicyEstimator::ClearCachedEstimates()
+{
+    AssertLockHeld(m_cs_fee_estimator);
+    LOCK(m_cs_cached_estimates);
+    m_cached_estimates.clear();
 }
 
 CFeeRate CBlockPolicyEstimator::estimateFee(int confTarget) const
@@ -870,7 +880,29 @@ double CBlockPolicyEstimator::estimateConservativeFee(unsigned int doubleTarget,
  */
 CFeeRate CBlockPolicyEstimator::estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
 {
+    {
+        LOCK(m_cs_cached_estimates);
+        const auto it{m_cached_estimates.find({confTarget, conservative})};
+        if (it != m_cached_estimates.end()) {
+            if (feeCalc) *feeCalc = it->second.calc;
+            return it->second.feerate;
+        }
+    }
+
     LOCK(m_cs_fee_estimator);
+    FeeCalculation calc;
+    const CFeeRate feerate{CalculateSmartFee(confTarget, &calc, conservative)};
+    if (confTarget > 0 && (unsigned int)confTarget <= longStats->GetMaxConfirms()) {
+        LOCK(m_cs_cached_estimates);
+        m_cached_estimates.try_emplace({confTarget, conservative}, CachedSmartFee{feerate, calc});
+    }
+    if (feeCalc) *feeCalc = calc;
+    return feerate;
+}
+
+CFeeRate CBlockPolicyEstimator::CalculateSmartFee(int confTarget, FeeCalculation* feeCalc, bool conservative) const
+{
+    AssertLockHeld(m_cs_fee_estimator);
 
     if (feeCalc) {
         feeCalc->desiredTarget = confTarget;
@@ -1052,6 +1084,7 @@ bool CBlockPolicyEstimator::Read(AutoFile& filein)
             nBestSeenHeight = nFileBestSeenHeight;
             historicalFirst = nFileHistoricalFirst;
             historicalBest = nFileHistoricalBest;
+            ClearCachedEstimates();
         }
     }
     catch (const std::exception& e) {
@@ -20,6 +20,7 @@
 #include <memory>
 #include <set>
 #include <string>
+#include <utility>
 #include <vector>
 
 
@@ -205,7 +206,7 @@ public:
     /** Process all the transactions that have been included in a block */
     void processBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block,
                       unsigned int nBlockHeight)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_cached_estimates);
 
     /** Process a transaction accepted to the mempool*/
     void processTransaction(const NewMempoolTransactionInfo& tx)
@@ -213,7 +214,7 @@ public:
 
     /** Remove a transaction from the mempool tracking stats for non BLOCK removal reasons*/
     bool removeTx(Txid hash)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_cached_estimates);
 
     /** DEPRECATED. Return a feerate estimate */
     CFeeRate estimateFee(int confTarget) const
@@ -225,7 +226,7 @@ public:
      *  valid over longer time horizons also.
      */
     CFeeRate estimateSmartFee(int confTarget, FeeCalculation *feeCalc, bool conservative) const
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_cached_estimates);
 
     /** Return a specific fee estimate calculation with a given success
      * threshold and time horizon, and optionally return detailed data about
@@ -241,11 +242,11 @@ public:
 
     /** Read estimation data from a file */
     bool Read(AutoFile& filein)
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_cached_estimates);
 
     /** Empty mempool transactions on shutdown to record failure to confirm for txs still in mempool */
     void FlushUnconfirmed()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_cached_estimates);
 
     /** Calculation of highest target that estimates are tracked for */
     unsigned int HighestTargetTracked(FeeEstimateHorizon horizon) const
@@ -253,7 +254,7 @@ public:
 
     /** Drop still unconfirmed transactions and record current estimations, if the fee estimation file is present. */
     void Flush()
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_cached_estimates);
 
     /** Record current fee estimations. */
     void FlushFeeEstimates()
@@ -267,9 +268,9 @@ protected:
     void TransactionAddedToMempool(const NewMempoolTransactionInfo& tx, uint64_t /*unused*/) override
         EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
     void TransactionRemovedFromMempool(const CTransactionRef& tx, MemPoolRemovalReason /*unused*/, uint64_t /*unused*/) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_cached_estimates);
     void MempoolTransactionsRemovedForBlock(const std::vector<RemovedMempoolTransactionInfo>& txs_removed_for_block, unsigned int nBlockHeight) override
-        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(!m_cs_fee_estimator, !m_cs_cached_estimates);
 
 private:
     mutable Mutex m_cs_fee_estimator;
@@ -300,9 +301,27 @@ private:
     std::vector<double> buckets GUARDED_BY(m_cs_fee_estimator); // The upper-bound of the range for the bucket (inclusive)
     std::map<double, unsigned int> bucketMap GUARDED_BY(m_cs_fee_estimator); // Map of bucket upper-bound to index into all vectors by bucket
 
+    /**
+     * Results of estimateSmartFee() by target and conservative flag, so that repeated queries do not
+     * take m_cs_fee_estimator and rescan the buckets. Entries are only added while holding
+     * m_cs_fee_estimator, and everything is dropped whenever the stats change in a way that affects
+     * estimates: on a new block, on reading estimates from file and on removing a transaction that
+     * has been unconfirmed for at least a block. Transactions entering the mempool (or leaving it
+     * again) at the current height do not affect any estimate until the next block.
+     */
+    struct CachedSmartFee {
+        CFeeRate feerate;
+        FeeCalculation calc;
+    };
+    mutable Mutex m_cs_cached_estimates;
+    mutable std::map<std::pair<int, bool>, CachedSmartFee> m_cached_estimates GUARDED_BY(m_cs_cached_estimates);
+    void ClearCachedEstimates() EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_cs_cached_estimates);
+
     /** Process a transaction confirmed in a block*/
     bool processBlockTx(unsigned int nBlockHeight, const RemovedMempoolTransactionInfo& tx) EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
 
+    /** Calculate the estimateSmartFee() result, bypassing the cache */
+    CFeeRate CalculateSmartFee(int confTarget, FeeCalculation* feeCalc, bool conservative) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
     /** Helper for estimateSmartFee */
     double estimateCombinedFee(unsigned int confTarget, double successThreshold, bool checkShorterHorizon, EstimationResult *result) const EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
     /** Helper for estimateSmartFee */
@@ -316,7 +335,7 @@ private:
 
     /** A non-thread-safe helper for the removeTx function */
     bool _removeTx(const Txid& hash, bool inBlock)
-        EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator);
+        EXCLUSIVE_LOCKS_REQUIRED(m_cs_fee_estimator, !m_cs_cached_estimates);
 };
 
 class FeeFilterRounder
@@ -264,6 +264,22 @@ inline constexpr const char* WTXIDRELAY{"wtxidrelay"};
  * txreconciliation, as described by BIP 330.
  */
 inline constexpr const char* SENDTXRCNCL{"sendtxrcncl"};
+/**
+ * Contains a 2-byte reconciliation set size and a 2-byte q coefficient, and
+ * requests a sketch of the receiver's reconciliation set, as described by
+ * BIP 330.
+ */
+inline constexpr const char* REQRECON{"reqrecon"};
+/**
+ * Contains a sketch of the sender's reconciliation set, sent in response to
+ * reqrecon, as described by BIP 330.
+ */
+inline constexpr const char* SKETCH{"sketch"};
+/**
+ * Contains whether a reconciliation succeeded and the short IDs of the
+ * transactions the sender is missing, as described by BIP 330.
+ */
+inline constexpr const char* RECONCILDIFF{"reconcildiff"};
 }; // namespace NetMsgType
 
 /** All known message types (see above). Keep this in the same order as the list of messages above. */
@@ -303,6 +319,9 @@ inline const std::array ALL_NET_MESSAGE_TYPES{std::to_array<std::string>({
     NetMsgType::CFCHECKPT,
     NetMsgType::WTXIDRELAY,
     NetMsgType::SENDTXRCNCL,
+    NetMsgType::REQRECON,
+    NetMsgType::SKETCH,
+    NetMsgType::RECONCILDIFF,
 })};
 
 /** nServices flags */
@@ -17,6 +17,7 @@
 #include <index/txindex.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
+#include <node/response_cache.h>
 #include <primitives/block.h>
 #include <primitives/transaction.h>
 #include <rpc/blockchain.h>
@@ -33,7 +34,12 @@
 #include <util/strencodings.h>
 #include <validation.h>
 
+#include <algorithm>
 #include <any>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
 #include <vector>
 
 #include <univalue.h>
@@ -44,6 +50,12 @@ using util::SplitString;
 
 static const size_t MAX_GETUTXOS_OUTPOINTS = 15; //allow a max of 15 outpoints to be queried at once
 static constexpr unsigned int MAX_REST_HEADERS_RESULTS = 2000;
+static constexpr unsigned int MAX_REST_BLOCKRANGE_RESULTS = 1000;
+//! Reply data a block range may have queued for a slow client before reading further blocks
+static constexpr size_t MAX_REST_BLOCKRANGE_UNSENT = 16 << 20;
+//! Block range replies streamed at once, so that slow clients cannot occupy all HTTP worker threads
+static constexpr unsigned int MAX_REST_BLOCKRANGE_STREAMS = 4;
+static std::atomic<unsigned int> g_rest_blockrange_streams{0};
 
 static const struct {
     RESTResponseFormat rf;
@@ -97,6 +109,17 @@ static NodeContext* GetNodeContext(const std::any& context, HTTPRequest* req)
     return node_context;
 }
 
+/**
+ * Get the node context response cache.
+ *
+ * @returns        Pointer to the response cache or nullptr if it is disabled.
+ */
+static node::ResponseCache* GetResponseCache(const std::any& context)
+{
+    auto node_context = util::AnyPtr<NodeContext>(context);
+    return node_context ? node_context->response_cache.get() : nullptr;
+}
+
 /**
  * Get the node context mempool.
  *
@@ -271,9 +294,8 @@ static bool rest_headers(const std::any& context,
         for (const CBlockIndex *pindex : headers) {
             jsonHeaders.push_back(blockheaderToJSON(*tip, *pindex, chainman.GetConsensus().powLimit));
         }
-        std::string strJSON = jsonHeaders.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        req->WriteJSONReply(HTTP_OK, jsonHeaders);
         return true;
     }
     default: {
@@ -410,6 +432,11 @@ static bool rest_block(const std::any& context,
     ChainstateManager* maybe_chainman = GetChainman(context, req);
     if (!maybe_chainman) return false;
     ChainstateManager& chainman = *maybe_chainman;
+    // Only the JSON object is cached, the binary formats are cheap to read from disk
+    node::ResponseCache* const cache{rf == RESTResponseFormat::JSON ? GetResponseCache(context) : nullptr};
+    const std::string cache_key{strprintf("rest/block/%s/%d.json", hash->GetHex(), static_cast<int>(tx_verbosity))};
+    const CBlockIndex* cache_dependency{nullptr};
+    std::shared_ptr<const node::ResponseCache::Response> cached;
     {
         LOCK(cs_main);
         tip = chainman.ActiveChain().Tip();
@@ -424,6 +451,19 @@ static bool rest_block(const std::any& context,
             return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not available (not fully downloaded)");
         }
         pos = pblockindex->GetBlockPos();
+        if (cache) {
+            // The JSON object also depends on the next block, see getblock
+            cache_dependency = chainman.ActiveChain().Next(pblockindex);
+            cached = cache->Get(chainman.ActiveChain(), cache_key);
+        }
+    }
+
+    if (cached) {
+        UniValue objBlock{std::get<UniValue>(*cached)};
+        UpdateBlockHeaderJSON(objBlock, *tip, *pblockindex, chainman.GetConsensus().powLimit);
+        req->WriteHeader("Content-Type", "application/json");
+        req->WriteJSONReply(HTTP_OK, objBlock);
+        return true;
     }
 
     std::vector<std::byte> block_data{};
@@ -450,9 +490,9 @@ static bool rest_block(const std::any& context,
         DataStream block_stream{block_data};
         block_stream >> TX_WITH_WITNESS(block);
         UniValue objBlock = blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
-        std::string strJSON = objBlock.write() + "\n";
+        if (cache && cache_dependency) cache->Put(*cache_dependency, cache_key, objBlock);
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        req->WriteJSONReply(HTTP_OK, objBlock);
         return true;
     }
 
@@ -472,6 +512,108 @@ static bool rest_block_notxdetails(const std::any& context, HTTPRequest* req, co
     return rest_block(context, req, uri_part, TxVerbosity::SHOW_TXID);
 }
 
+/**
+ * Stream consecutive blocks of the active chain, serialized back-to-back, optionally each followed
+ * by its spent outputs as served by /rest/spenttxouts/. The next block is read from disk while the
+ * previous one is being sent, as long as the client keeps up.
+ */
+static bool rest_blockrange(const std::any& context, HTTPRequest* req, const std::string& uri_part)
+{
+    if (!CheckWarmup(req)) return false;
+    std::string param;
+    const RESTResponseFormat rf = ParseDataFormat(param, uri_part);
+    if (rf != RESTResponseFormat::BINARY) {
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: bin)");
+    }
+
+    const std::vector<std::string> path = SplitString(param, '/');
+    if (path.size() != 2) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/blockrange/<start>/<count>.bin");
+    }
+    const auto start{ToIntegral<int32_t>(path[0])};
+    if (!start || *start < 0) {
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid height: " + SanitizeString(path[0], SAFE_CHARS_URI));
+    }
+    const auto count{ToIntegral<int32_t>(path[1])};
+    if (!count || *count < 1 || *count > int32_t{MAX_REST_BLOCKRANGE_RESULTS}) {
+        return RESTERR(req, HTTP_BAD_REQUEST, strprintf("Block count is invalid or out of acceptable range (1-%u): %s",
+                                                        MAX_REST_BLOCKRANGE_RESULTS, SanitizeString(path[1], SAFE_CHARS_URI)));
+    }
+
+    bool with_spent_txouts{false};
+    try {
+        const auto spent_txouts{req->GetQueryParameter("spenttxouts").value_or("0")};
+        if (spent_txouts != "0" && spent_txouts != "1") {
+            return RESTERR(req, HTTP_BAD_REQUEST, "Invalid spenttxouts value, expected 0 or 1: " + SanitizeString(spent_txouts, SAFE_CHARS_URI));
+        }
+        with_spent_txouts = spent_txouts == "1";
+    } catch (const std::runtime_error& e) {
+        return RESTERR(req, HTTP_BAD_REQUEST, e.what());
+    }
+
+    ChainstateManager* maybe_chainman = GetChainman(context, req);
+    if (!maybe_chainman) return false;
+    ChainstateManager& chainman = *maybe_chainman;
+
+    if (++g_rest_blockrange_streams > MAX_REST_BLOCKRANGE_STREAMS) {
+        --g_rest_blockrange_streams;
+        return RESTERR(req, HTTP_SERVICE_UNAVAILABLE, strprintf("Too many block range requests in progress (maximum %u)", MAX_REST_BLOCKRANGE_STREAMS));
+    }
+    const struct StreamSlot {
+        ~StreamSlot() { --g_rest_blockrange_streams; }
+    } stream_slot;
+
+    // Collect the blocks first, so that unavailable data is reported before the reply starts.
+    std::vector<std::pair<const CBlockIndex*, FlatFilePos>> blocks;
+    {
+        LOCK(cs_main);
+        const CChain& active_chain = chainman.ActiveChain();
+        if (*start > active_chain.Height()) {
+            return RESTERR(req, HTTP_NOT_FOUND, "Block height out of range");
+        }
+        const int32_t end{std::min(*start + *count, active_chain.Height() + 1)};
+        blocks.reserve(end - *start);
+        for (int32_t height{*start}; height < end; ++height) {
+            const CBlockIndex* pindex{active_chain[height]};
+            if (!(pindex->nStatus & BLOCK_HAVE_DATA) || (with_spent_txouts && height > 0 && !(pindex->nStatus & BLOCK_HAVE_UNDO))) {
+                return RESTERR(req, HTTP_NOT_FOUND, strprintf("Block at height %d not available (pruned data)", height));
+            }
+            blocks.emplace_back(pindex, pindex->GetBlockPos());
+        }
+    }
+
+    bool started{false};
+    for (const auto& [pindex, pos] : blocks) {
+        std::vector<std::byte> block_data;
+        CBlockUndo block_undo;
+        if (!chainman.m_blockman.ReadRawBlock(block_data, pos) ||
+            (with_spent_txouts && pindex->nHeight > 0 && !chainman.m_blockman.ReadBlockUndo(block_undo, *pindex))) {
+            if (!started) {
+                return RESTERR(req, HTTP_NOT_FOUND, strprintf("Block at height %d not available", pindex->nHeight));
+            }
+            // The status was sent already, so cut the reply short. Clients notice the missing blocks.
+            LogDebug(BCLog::HTTP, "Block range reply cut short, block at height %d not available\n", pindex->nHeight);
+            break;
+        }
+
+        if (!started) {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->StartChunkedReply(HTTP_OK);
+            started = true;
+        } else if (!req->WaitForReplyChunksSent(MAX_REST_BLOCKRANGE_UNSENT)) {
+            break;
+        }
+        req->WriteReplyChunk(block_data);
+        if (with_spent_txouts) {
+            DataStream spent_txouts{};
+            SerializeBlockUndo(spent_txouts, block_undo);
+            req->WriteReplyChunk(spent_txouts);
+        }
+    }
+    req->EndChunkedReply();
+    return true;
+}
+
 static bool rest_filter_header(const std::any& context, HTTPRequest* req, const std::string& uri_part)
 {
     if (!CheckWarmup(req)) return false;
@@ -583,9 +725,8 @@ static bool rest_filter_header(const std::any& context, HTTPRequest* req, const
             jsonHeaders.push_back(header.GetHex());
         }
 
-        std::string strJSON = jsonHeaders.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        req->WriteJSONReply(HTTP_OK, jsonHeaders);
         return true;
     }
     default: {
@@ -762,7 +903,7 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
     std::string param;
     const RESTResponseFormat rf = ParseDataFormat(param, str_uri_part);
     if (param != "contents" && param != "info") {
-        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/mempool/<info|contents>.json");
+        return RESTERR(req, HTTP_BAD_REQUEST, "Invalid URI format. Expected /rest/mempool/<info|contents>.json or /rest/mempool/contents.<bin|hex>");
     }
 
     const CTxMemPool* mempool = GetMemPool(context, req);
@@ -770,7 +911,7 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
 
     switch (rf) {
     case RESTResponseFormat::JSON: {
-        std::string str_json;
+        UniValue json;
         if (param == "contents") {
             std::string raw_verbose;
             try {
@@ -795,17 +936,41 @@ static bool rest_mempool(const std::any& context, HTTPRequest* req, const std::s
             if (verbose && mempool_sequence) {
                 return RESTERR(req, HTTP_BAD_REQUEST, "Verbose results cannot contain mempool sequence values. (hint: set \"verbose=false\")");
             }
-            str_json = MempoolToJSON(*mempool, verbose, mempool_sequence).write() + "\n";
+            json = MempoolToJSON(*mempool, verbose, mempool_sequence);
         } else {
-            str_json = MempoolInfoToJSON(*mempool).write() + "\n";
+            json = MempoolInfoToJSON(*mempool);
         }
 
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, str_json);
+        req->WriteJSONReply(HTTP_OK, json);
+        return true;
+    }
+    case RESTResponseFormat::BINARY:
+    case RESTResponseFormat::HEX: {
+        if (param != "contents") {
+            return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+        }
+        // Only the snapshot is taken under the mempool lock, serializing it is not.
+        const MempoolSnapshot snapshot{SnapshotMempool(*mempool)};
+        DataStream ssMempool;
+        ssMempool << snapshot.mempool_sequence;
+        WriteCompactSize(ssMempool, snapshot.entries.size());
+        for (const MempoolEntrySnapshot& e : snapshot.entries) {
+            ssMempool << e.tx->GetHash() << e.fee << e.modified_fee << e.vsize << int64_t{count_seconds(e.time)};
+        }
+
+        if (rf == RESTResponseFormat::BINARY) {
+            req->WriteHeader("Content-Type", "application/octet-stream");
+            req->WriteReply(HTTP_OK, ssMempool);
+        } else {
+            std::string strHex = HexStr(ssMempool) + "\n";
+            req->WriteHeader("Content-Type", "text/plain");
+            req->WriteReply(HTTP_OK, strHex);
+        }
         return true;
     }
     default: {
-        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: json)");
+        return RESTERR(req, HTTP_NOT_FOUND, "output format not found (available: " + AvailableDataFormatsString() + ")");
     }
     }
 }
@@ -822,23 +987,37 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
         return RESTERR(req, HTTP_BAD_REQUEST, "Invalid hash: " + hashStr);
     }
 
+    const NodeContext* const node = GetNodeContext(context, req);
+    if (!node) return false;
+    // Replies for confirmed transactions stay the same as long as their block is in the active chain
+    node::ResponseCache* const cache{node->response_cache.get()};
+    const std::string cache_key{strprintf("rest/tx/%s/%d", hash->GetHex(), static_cast<int>(rf))};
+    if (cache) {
+        const auto cached{WITH_LOCK(cs_main, return cache->Get(node->chainman->ActiveChain(), cache_key))};
+        if (cached) {
+            req->WriteHeader("Content-Type", rf == RESTResponseFormat::BINARY ? "application/octet-stream" : rf == RESTResponseFormat::HEX ? "text/plain" : "application/json");
+            req->WriteReply(HTTP_OK, std::get<std::string>(*cached));
+            return true;
+        }
+    }
+
     if (g_txindex) {
         g_txindex->BlockUntilSyncedToCurrentChain();
     }
 
-    const NodeContext* const node = GetNodeContext(context, req);
-    if (!node) return false;
     uint256 hashBlock = uint256();
     const CTransactionRef tx{GetTransaction(/*block_index=*/nullptr, node->mempool.get(), *hash, hashBlock, node->chainman->m_blockman)};
     if (!tx) {
         return RESTERR(req, HTTP_NOT_FOUND, hashStr + " not found");
     }
+    const CBlockIndex* const block_index{cache && !hashBlock.IsNull() ? WITH_LOCK(cs_main, return node->chainman->m_blockman.LookupBlockIndex(hashBlock)) : nullptr};
 
     switch (rf) {
     case RESTResponseFormat::BINARY: {
         DataStream ssTx;
         ssTx << TX_WITH_WITNESS(tx);
 
+        if (block_index) cache->Put(*block_index, cache_key, ssTx.str());
         req->WriteHeader("Content-Type", "application/octet-stream");
         req->WriteReply(HTTP_OK, ssTx);
         return true;
@@ -849,6 +1028,7 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
         ssTx << TX_WITH_WITNESS(tx);
 
         std::string strHex = HexStr(ssTx) + "\n";
+        if (block_index) cache->Put(*block_index, cache_key, strHex);
         req->WriteHeader("Content-Type", "text/plain");
         req->WriteReply(HTTP_OK, strHex);
         return true;
@@ -857,9 +1037,14 @@ static bool rest_tx(const std::any& context, HTTPRequest* req, const std::string
     case RESTResponseFormat::JSON: {
         UniValue objTx(UniValue::VOBJ);
         TxToUniv(*tx, /*block_hash=*/hashBlock, /*entry=*/ objTx);
-        std::string strJSON = objTx.write() + "\n";
         req->WriteHeader("Content-Type", "application/json");
-        req->WriteReply(HTTP_OK, strJSON);
+        if (block_index) {
+            std::string strJSON{objTx.write() + "\n"};
+            cache->Put(*block_index, cache_key, strJSON);
+            req->WriteReply(HTTP_OK, strJSON);
+            return true;
+        }
+        req->WriteJSONReply(HTTP_OK, objTx);
         return true;
     }
 
@@ -1116,27 +1301,29 @@ static bool rest_blockhash_by_height(const std::any& context, HTTPRequest* req,
 static const struct {
     const char* prefix;
     bool (*handler)(const std::any& context, HTTPRequest* req, const std::string& strReq);
+    HTTPPriority priority;
 } uri_prefixes[] = {
-      {"/rest/tx/", rest_tx},
-      {"/rest/block/notxdetails/", rest_block_notxdetails},
-      {"/rest/block/", rest_block_extended},
-      {"/rest/blockfilter/", rest_block_filter},
-      {"/rest/blockfilterheaders/", rest_filter_header},
-      {"/rest/chaininfo", rest_chaininfo},
-      {"/rest/mempool/", rest_mempool},
-      {"/rest/headers/", rest_headers},
-      {"/rest/getutxos", rest_getutxos},
-      {"/rest/deploymentinfo/", rest_deploymentinfo},
-      {"/rest/deploymentinfo", rest_deploymentinfo},
-      {"/rest/blockhashbyheight/", rest_blockhash_by_height},
-      {"/rest/spenttxouts/", rest_spent_txouts},
+      {"/rest/tx/", rest_tx, HTTPPriority::NORMAL},
+      {"/rest/block/notxdetails/", rest_block_notxdetails, HTTPPriority::NORMAL},
+      {"/rest/block/", rest_block_extended, HTTPPriority::NORMAL},
+      {"/rest/blockrange/", rest_blockrange, HTTPPriority::NORMAL},
+      {"/rest/blockfilter/", rest_block_filter, HTTPPriority::NORMAL},
+      {"/rest/blockfilterheaders/", rest_filter_header, HTTPPriority::NORMAL},
+      {"/rest/chaininfo", rest_chaininfo, HTTPPriority::HIGH},
+      {"/rest/mempool/", rest_mempool, HTTPPriority::NORMAL},
+      {"/rest/headers/", rest_headers, HTTPPriority::HIGH},
+      {"/rest/getutxos", rest_getutxos, HTTPPriority::NORMAL},
+      {"/rest/deploymentinfo/", rest_deploymentinfo, HTTPPriority::HIGH},
+      {"/rest/deploymentinfo", rest_deploymentinfo, HTTPPriority::HIGH},
+      {"/rest/blockhashbyheight/", rest_blockhash_by_height, HTTPPriority::HIGH},
+      {"/rest/spenttxouts/", rest_spent_txouts, HTTPPriority::NORMAL},
 };
 
 void StartREST(const std::any& context)
 {
     for (const auto& up : uri_prefixes) {
         auto handler = [context, up](HTTPRequest* req, const std::string& prefix) { return up.handler(context, req, prefix); };
-        RegisterHTTPHandler(up.prefix, false, handler);
+        RegisterHTTPHandler(up.prefix, false, handler, up.priority);
     }
 }
 
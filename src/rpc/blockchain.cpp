@@ -12,6 +12,7 @@
 #include <clientversion.h>
 #include <coins.h>
 #include <common/args.h>
+#include <common/system.h>
 #include <consensus/amount.h>
 #include <consensus/params.h>
 #include <consensus/validation.h>
@@ -22,13 +23,16 @@
 #include <hash.h>
 #include <index/blockfilterindex.h>
 #include <index/coinstatsindex.h>
+#include <index/scriptpubkeyindex.h>
 #include <interfaces/mining.h>
 #include <kernel/coinstats.h>
+#include <key_io.h>
 #include <logging/timer.h>
 #include <net.h>
 #include <net_processing.h>
 #include <node/blockstorage.h>
 #include <node/context.h>
+#include <node/response_cache.h>
 #include <node/transaction.h>
 #include <node/utxo_snapshot.h>
 #include <node/warnings.h>
@@ -46,6 +50,7 @@
 #include <univalue.h>
 #include <util/check.h>
 #include <util/fs.h>
+#include <util/hasher.h>
 #include <util/strencodings.h>
 #include <util/syserror.h>
 #include <util/translation.h>
@@ -53,13 +58,16 @@
 #include <validationinterface.h>
 #include <versionbits.h>
 
+#include <algorithm>
 #include <cstdint>
 
 #include <condition_variable>
+#include <future>
 #include <iterator>
 #include <memory>
 #include <mutex>
 #include <optional>
+#include <unordered_set>
 #include <vector>
 
 using kernel::CCoinsStats;
@@ -178,6 +186,13 @@ UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex
     return result;
 }
 
+void UpdateBlockHeaderJSON(UniValue& result, const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit)
+{
+    const CBlockIndex* pnext;
+    result.pushKV("confirmations", ComputeNextBlockAndDepth(tip, blockindex, pnext));
+    result.pushKV("target", GetTarget(tip, pow_limit).GetHex());
+}
+
 UniValue blockToJSON(BlockManager& blockman, const CBlock& block, const CBlockIndex& tip, const CBlockIndex& blockindex, TxVerbosity verbosity, const uint256 pow_limit)
 {
     UniValue result = blockheaderToJSON(tip, blockindex, pow_limit);
@@ -238,6 +253,7 @@ static RPCHelpMan getblockcount()
     LOCK(cs_main);
     return chainman.ActiveChain().Height();
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -259,6 +275,7 @@ static RPCHelpMan getbestblockhash()
     LOCK(cs_main);
     return chainman.ActiveChain().Tip()->GetBlockHash().GetHex();
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -483,6 +500,7 @@ static RPCHelpMan getdifficulty()
     LOCK(cs_main);
     return GetDifficulty(*CHECK_NONFATAL(chainman.ActiveChain().Tip()));
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -568,6 +586,7 @@ static RPCHelpMan getblockhash()
     const CBlockIndex* pblockindex = active_chain[nHeight];
     return pblockindex->GetBlockHash().GetHex();
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -640,6 +659,7 @@ static RPCHelpMan getblockheader()
 
     return blockheaderToJSON(*tip, *pblockindex, chainman.GetConsensus().powLimit);
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -817,6 +837,11 @@ static RPCHelpMan getblock()
     const CBlockIndex* pblockindex;
     const CBlockIndex* tip;
     ChainstateManager& chainman = EnsureAnyChainman(request.context);
+    node::ResponseCache* const cache{EnsureAnyNodeContext(request.context).response_cache.get()};
+    // The hex data only depends on the block, the JSON object also on the next block
+    const std::string cache_key{strprintf("getblock/%s/%d", hash.GetHex(), std::clamp(verbosity, 0, 3))};
+    const CBlockIndex* cache_dependency{nullptr};
+    std::shared_ptr<const node::ResponseCache::Response> cached;
     {
         LOCK(cs_main);
         pblockindex = chainman.m_blockman.LookupBlockIndex(hash);
@@ -825,12 +850,24 @@ static RPCHelpMan getblock()
         if (!pblockindex) {
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
         }
+        if (cache) {
+            cache_dependency = verbosity <= 0 ? pblockindex : chainman.ActiveChain().Next(pblockindex);
+            cached = cache->Get(chainman.ActiveChain(), cache_key);
+        }
+    }
+
+    if (cached) {
+        UniValue result{std::get<UniValue>(*cached)};
+        if (verbosity > 0) UpdateBlockHeaderJSON(result, *tip, *pblockindex, chainman.GetConsensus().powLimit);
+        return result;
     }
 
     const std::vector<std::byte> block_data{GetRawBlockChecked(chainman.m_blockman, *pblockindex)};
 
     if (verbosity <= 0) {
-        return HexStr(block_data);
+        UniValue result{HexStr(block_data)};
+        if (cache && cache_dependency) cache->Put(*cache_dependency, cache_key, result);
+        return result;
     }
 
     DataStream block_stream{block_data};
@@ -846,8 +883,11 @@ static RPCHelpMan getblock()
         tx_verbosity = TxVerbosity::SHOW_DETAILS_AND_PREVOUT;
     }
 
-    return blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit);
+    UniValue result{blockToJSON(chainman.m_blockman, block, *tip, *pblockindex, tx_verbosity, chainman.GetConsensus().powLimit)};
+    if (cache && cache_dependency) cache->Put(*cache_dependency, cache_key, result);
+    return result;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -1228,6 +1268,7 @@ static RPCHelpMan gettxout()
 
     return ret;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -1415,6 +1456,7 @@ RPCHelpMan getblockchaininfo()
     obj.pushKV("warnings", node::GetWarningsForRpc(*CHECK_NONFATAL(node.warnings), IsDeprecatedRPCEnabled("warnings")));
     return obj;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -1611,6 +1653,7 @@ static RPCHelpMan getchaintips()
 
     return res;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -2152,40 +2195,135 @@ static RPCHelpMan getblockstats()
     }
     return ret;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
 namespace {
-//! Search for a given set of pubkey scripts
-bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, CCoinsViewCursor* cursor, const std::set<CScript>& needles, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+//! Maximum number of threads used to scan the UTXO set in scantxoutset
+constexpr int SCAN_MAX_THREADS{16};
+//! The UTXO set is split into ranges of the first two bytes of the txids
+constexpr uint32_t SCAN_POSITIONS{0x10000};
+
+//! Position of an outpoint in the UTXO set, by the first two bytes of its txid
+uint32_t ScanPosition(const COutPoint& outpoint)
+{
+    return 0x100 * *UCharCast(outpoint.hash.begin()) + *(UCharCast(outpoint.hash.begin()) + 1);
+}
+
+//! First position of range i when splitting the UTXO set into n_ranges ranges
+uint32_t ScanRangeBegin(size_t i, size_t n_ranges)
+{
+    return i * SCAN_POSITIONS / n_ranges;
+}
+
+} // namespace
+
+COutPoint ScanRangeStart(size_t i, size_t n_ranges)
 {
+    const uint32_t position{ScanRangeBegin(i, n_ranges)};
+    uint256 txid;
+    txid.data()[0] = position >> 8;
+    txid.data()[1] = position & 0xff;
+    return COutPoint{Txid::FromUint256(txid), 0};
+}
+
+bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, const std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, const std::set<CScript>& scripts, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point)
+{
+    struct RangeResult {
+        bool success{false};
+        int64_t count{0};
+        std::map<COutPoint, Coin> coins;
+    };
+
+    // Most coins do not match, so look the scripts up in a hash set
+    const std::unordered_set<CScript, SaltedSipHasher> needles{scripts.begin(), scripts.end()};
+    std::atomic<uint32_t> scanned{0};
+    std::atomic<bool> stop{false};
     scan_progress = 0;
-    count = 0;
-    while (cursor->Valid()) {
-        COutPoint key;
-        Coin coin;
-        if (!cursor->GetKey(key) || !cursor->GetValue(coin)) return false;
-        if (++count % 8192 == 0) {
-            interruption_point();
-            if (should_abort) {
-                // allow to abort the scan via the abort reference
-                return false;
+    auto scan_range = [&](size_t i) {
+        RangeResult result;
+        CCoinsViewCursor& cursor{*cursors[i]};
+        uint32_t position{ScanRangeBegin(i, cursors.size())};
+        const uint32_t end{ScanRangeBegin(i + 1, cursors.size())};
+        try {
+            for (; cursor.Valid(); cursor.Next()) {
+                COutPoint key;
+                Coin coin;
+                if (!cursor.GetKey(key) || !cursor.GetValue(coin)) return result;
+                const uint32_t key_position{ScanPosition(key)};
+                if (key_position >= end) break;
+                if (++result.count % 8192 == 0) {
+                    interruption_point();
+                    if (should_abort || stop) {
+                        // allow to abort the scan via the abort reference
+                        return result;
+                    }
+                }
+                if (result.count % 256 == 0) {
+                    // update progress reference every 256 item
+                    scanned += key_position - position;
+                    position = key_position;
+                    scan_progress = (int)(scanned * 100.0 / SCAN_POSITIONS + 0.5);
+                }
+                if (needles.contains(coin.out.scriptPubKey)) {
+                    result.coins.emplace(key, std::move(coin));
+                }
             }
+        } catch (...) {
+            // Let the other ranges stop early, the exception is rethrown below
+            stop = true;
+            throw;
         }
-        if (count % 256 == 0) {
-            // update progress reference every 256 item
-            uint32_t high = 0x100 * *UCharCast(key.hash.begin()) + *(UCharCast(key.hash.begin()) + 1);
-            scan_progress = (int)(high * 100.0 / 65536.0 + 0.5);
-        }
-        if (needles.count(coin.out.scriptPubKey)) {
-            out_results.emplace(key, coin);
-        }
-        cursor->Next();
+        scanned += end - position;
+        result.success = true;
+        return result;
+    };
+
+    std::vector<std::future<RangeResult>> workers;
+    workers.reserve(cursors.size() - 1);
+    for (size_t i = 1; i < cursors.size(); ++i) {
+        workers.push_back(std::async(std::launch::async, scan_range, i));
+    }
+    // Scan the first range on this thread while the workers handle the rest.
+    std::vector<RangeResult> results;
+    results.reserve(cursors.size());
+    try {
+        results.push_back(scan_range(0));
+    } catch (...) {
+        stop = true;
+        throw;
+    }
+    for (auto& worker : workers) {
+        results.push_back(worker.get());
     }
-    scan_progress = 100;
-    return true;
+
+    bool success{true};
+    count = 0;
+    for (RangeResult& result : results) {
+        success &= result.success;
+        count += result.count;
+        out_results.merge(result.coins);
+    }
+    if (success) scan_progress = 100;
+    return success;
+}
+
+/**
+ * Look up the unspent outputs paying to scripts in the scriptpubkeyindex.
+ * @return the block as of which the outputs are unspent, or nullptr if the index
+ *         is not enabled or not in sync with the active chain
+ */
+static const CBlockIndex* FindUnspentOutputsInIndex(ChainstateManager& chainman, const std::set<CScript>& scripts, std::map<COutPoint, Coin>& coins)
+{
+    if (!g_scriptpubkeyindex || !g_scriptpubkeyindex->BlockUntilSyncedToCurrentChain()) return nullptr;
+    interfaces::BlockRef best_block;
+    if (!g_scriptpubkeyindex->FindUnspentOutputs(scripts, coins, best_block)) return nullptr;
+    LOCK(cs_main);
+    // After invalidateblock, the index only rewinds once a new block is connected
+    const CBlockIndex* block{chainman.ActiveChain()[best_block.height]};
+    return block && block->GetBlockHash() == best_block.hash ? block : nullptr;
 }
-} // namespace
 
 /** RAII object to prevent concurrency issue when scanning the txout set */
 static std::atomic<int> g_scan_progress;
@@ -2276,7 +2414,8 @@ static RPCHelpMan scantxoutset()
         "or more path elements separated by \"/\", and optionally ending in \"/*\" (unhardened), or \"/*'\" or \"/*h\" (hardened) to specify all\n"
         "unhardened or hardened child keys.\n"
         "In the latter case, a range needs to be specified by below if different from 1000.\n"
-        "For more information on output descriptors, see the documentation in the doc/descriptors.md file.\n",
+        "For more information on output descriptors, see the documentation in the doc/descriptors.md file.\n"
+        "\nWhen -scriptpubkeyindex is enabled and synced, the outputs are looked up in the index instead of scanning the whole UTXO set.\n",
         {
             scan_action_arg_desc,
             scan_objects_arg_desc,
@@ -2284,7 +2423,7 @@ static RPCHelpMan scantxoutset()
         {
             RPCResult{"when action=='start'; only returns after scan completes", RPCResult::Type::OBJ, "", "", {
                 {RPCResult::Type::BOOL, "success", "Whether the scan was completed"},
-                {RPCResult::Type::NUM, "txouts", "The number of unspent transaction outputs scanned"},
+                {RPCResult::Type::NUM, "txouts", "The number of unspent transaction outputs scanned, only the matching ones when the scriptpubkeyindex is used"},
                 {RPCResult::Type::NUM, "height", "The block height at which the scan was done"},
                 {RPCResult::Type::STR_HEX, "bestblock", "The hash of the block at the tip of the chain"},
                 {RPCResult::Type::ARR, "unspents", "",
@@ -2368,18 +2507,31 @@ static RPCHelpMan scantxoutset()
         std::map<COutPoint, Coin> coins;
         g_should_abort_scan = false;
         int64_t count = 0;
-        std::unique_ptr<CCoinsViewCursor> pcursor;
+        bool res;
         const CBlockIndex* tip;
         NodeContext& node = EnsureAnyNodeContext(request.context);
-        {
-            ChainstateManager& chainman = EnsureChainman(node);
-            LOCK(cs_main);
-            Chainstate& active_chainstate = chainman.ActiveChainstate();
-            active_chainstate.ForceFlushStateToDisk();
-            pcursor = CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor());
-            tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
+        ChainstateManager& chainman = EnsureChainman(node);
+        if ((tip = FindUnspentOutputsInIndex(chainman, needles, coins))) {
+            // Only the matching outputs are read from the index
+            res = true;
+            count = coins.size();
+        } else {
+            coins.clear();
+            const size_t n_ranges{size_t(std::clamp(GetNumCores(), 1, SCAN_MAX_THREADS))};
+            std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+            {
+                LOCK(cs_main);
+                Chainstate& active_chainstate = chainman.ActiveChainstate();
+                active_chainstate.ForceFlushStateToDisk();
+                // The coins database is only written to under cs_main, so all
+                // cursors created here read the same UTXO set
+                for (size_t i = 0; i < n_ranges; ++i) {
+                    cursors.push_back(CHECK_NONFATAL(active_chainstate.CoinsDB().Cursor(ScanRangeStart(i, n_ranges))));
+                }
+                tip = CHECK_NONFATAL(active_chainstate.m_chain.Tip());
+            }
+            res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, cursors, needles, coins, node.rpc_interruption_point);
         }
-        bool res = FindScriptPubKey(g_scan_progress, g_should_abort_scan, count, pcursor.get(), needles, coins, node.rpc_interruption_point);
         result.pushKV("success", res);
         result.pushKV("txouts", count);
         result.pushKV("height", tip->nHeight);
@@ -2416,6 +2568,98 @@ static RPCHelpMan scantxoutset()
     };
 }
 
+static RPCHelpMan getaddressutxos()
+{
+    return RPCHelpMan{
+        "getaddressutxos",
+        "Returns the unspent transaction outputs paying to the given addresses.\n"
+        "Requires -scriptpubkeyindex, see scantxoutset for a slower alternative that does not.\n",
+        {
+            {"addresses", RPCArg::Type::ARR, RPCArg::Optional::NO, "The addresses to look up",
+                {
+                    {"address", RPCArg::Type::STR, RPCArg::Optional::OMITTED, "An address"},
+                },
+            },
+        },
+        RPCResult{
+            RPCResult::Type::OBJ, "", "",
+            {
+                {RPCResult::Type::NUM, "height", "The block height as of which the outputs are unspent"},
+                {RPCResult::Type::STR_HEX, "bestblock", "The hash of the block as of which the outputs are unspent"},
+                {RPCResult::Type::ARR, "unspents", "",
+                {
+                    {RPCResult::Type::OBJ, "", "",
+                    {
+                        {RPCResult::Type::STR_HEX, "txid", "The transaction id"},
+                        {RPCResult::Type::NUM, "vout", "The vout value"},
+                        {RPCResult::Type::STR, "address", "The address the output pays to"},
+                        {RPCResult::Type::STR_HEX, "scriptPubKey", "The output script"},
+                        {RPCResult::Type::STR_AMOUNT, "amount", "The amount in " + CURRENCY_UNIT + " of the unspent output"},
+                        {RPCResult::Type::BOOL, "coinbase", "Whether this is a coinbase output"},
+                        {RPCResult::Type::NUM, "height", "Height of the unspent transaction output"},
+                        {RPCResult::Type::STR_HEX, "blockhash", "Blockhash of the unspent transaction output"},
+                        {RPCResult::Type::NUM, "confirmations", "Number of confirmations of the unspent transaction output"},
+                    }},
+                }},
+                {RPCResult::Type::STR_AMOUNT, "total_amount", "The total amount of all found unspent outputs in " + CURRENCY_UNIT},
+            }},
+        RPCExamples{
+            HelpExampleCli("getaddressutxos", "'[\"" + EXAMPLE_ADDRESS[0] + "\"]'") +
+            HelpExampleRpc("getaddressutxos", "[\"" + EXAMPLE_ADDRESS[0] + "\"]")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    if (!g_scriptpubkeyindex) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Looking up outputs by address requires -scriptpubkeyindex");
+    }
+
+    std::set<CScript> scripts;
+    for (const UniValue& address : request.params[0].get_array().getValues()) {
+        const CTxDestination dest{DecodeDestination(address.get_str())};
+        if (!IsValidDestination(dest)) {
+            throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, strprintf("Invalid address: %s", address.get_str()));
+        }
+        scripts.insert(GetScriptForDestination(dest));
+    }
+
+    std::map<COutPoint, Coin> coins;
+    const CBlockIndex* const pindex{FindUnspentOutputsInIndex(EnsureAnyChainman(request.context), scripts, coins)};
+    if (!pindex) {
+        const IndexSummary summary{g_scriptpubkeyindex->GetSummary()};
+        throw JSONRPCError(RPC_INTERNAL_ERROR, strprintf("Unable to get data because scriptpubkeyindex is still syncing. Current height: %d", summary.best_block_height));
+    }
+    const CBlockIndex& tip{*pindex};
+
+    UniValue unspents(UniValue::VARR);
+    CAmount total_amount{0};
+    for (const auto& [outpoint, coin] : coins) {
+        CTxDestination dest;
+        ExtractDestination(coin.out.scriptPubKey, dest);
+
+        UniValue unspent(UniValue::VOBJ);
+        unspent.pushKV("txid", outpoint.hash.GetHex());
+        unspent.pushKV("vout", outpoint.n);
+        unspent.pushKV("address", EncodeDestination(dest));
+        unspent.pushKV("scriptPubKey", HexStr(coin.out.scriptPubKey));
+        unspent.pushKV("amount", ValueFromAmount(coin.out.nValue));
+        unspent.pushKV("coinbase", coin.IsCoinBase());
+        unspent.pushKV("height", coin.nHeight);
+        unspent.pushKV("blockhash", CHECK_NONFATAL(tip.GetAncestor(coin.nHeight))->GetBlockHash().GetHex());
+        unspent.pushKV("confirmations", tip.nHeight - coin.nHeight + 1);
+        unspents.push_back(std::move(unspent));
+        total_amount += coin.out.nValue;
+    }
+
+    UniValue result(UniValue::VOBJ);
+    result.pushKV("height", tip.nHeight);
+    result.pushKV("bestblock", tip.GetBlockHash().GetHex());
+    result.pushKV("unspents", std::move(unspents));
+    result.pushKV("total_amount", ValueFromAmount(total_amount));
+    return result;
+},
+    };
+}
+
 /** RAII object to prevent concurrency issue when scanning blockfilters */
 static std::atomic<int> g_scanfilter_progress;
 static std::atomic<int> g_scanfilter_progress_height;
@@ -2933,6 +3177,8 @@ static RPCHelpMan getblockfilter()
 
     const CBlockIndex* block_index;
     bool block_was_connected;
+    node::ResponseCache* const cache{EnsureAnyNodeContext(request.context).response_cache.get()};
+    const std::string cache_key{strprintf("getblockfilter/%s/%s", block_hash.GetHex(), filtertype_name)};
     {
         ChainstateManager& chainman = EnsureAnyChainman(request.context);
         LOCK(cs_main);
@@ -2941,6 +3187,9 @@ static RPCHelpMan getblockfilter()
             throw JSONRPCError(RPC_INVALID_ADDRESS_OR_KEY, "Block not found");
         }
         block_was_connected = block_index->IsValid(BLOCK_VALID_SCRIPTS);
+        if (cache) {
+            if (const auto cached{cache->Get(chainman.ActiveChain(), cache_key)}) return std::get<UniValue>(*cached);
+        }
     }
 
     bool index_ready = index->BlockUntilSyncedToCurrentChain();
@@ -2969,8 +3218,10 @@ static RPCHelpMan getblockfilter()
     UniValue ret(UniValue::VOBJ);
     ret.pushKV("filter", HexStr(filter.GetEncodedFilter()));
     ret.pushKV("header", filter_header.GetHex());
+    if (cache) cache->Put(*block_index, cache_key, ret);
     return ret;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -3482,6 +3733,7 @@ void RegisterBlockchainRPCCommands(CRPCTable& t)
         {"blockchain", &verifychain},
         {"blockchain", &preciousblock},
         {"blockchain", &scantxoutset},
+        {"blockchain", &getaddressutxos},
         {"blockchain", &scanblocks},
         {"blockchain", &getdescriptoractivity},
         {"blockchain", &getblockfilter},
@@ -13,7 +13,12 @@
 #include <validation.h>
 
 #include <any>
+#include <atomic>
 #include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
 #include <vector>
 
 class CBlock;
@@ -41,6 +46,10 @@ UniValue blockToJSON(node::BlockManager& blockman, const CBlock& block, const CB
 /** Block header to JSON */
 UniValue blockheaderToJSON(const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit) LOCKS_EXCLUDED(cs_main);
 
+/** Refresh the fields of a blockheaderToJSON() or blockToJSON() result that depend on the tip, for
+ *  a result built for an earlier tip. The next block must not have changed since. */
+void UpdateBlockHeaderJSON(UniValue& result, const CBlockIndex& tip, const CBlockIndex& blockindex, const uint256 pow_limit);
+
 /** Used by getblockstats to get feerates at different percentiles by weight  */
 void CalculatePercentilesByWeight(CAmount result[NUM_GETBLOCKSTATS_PERCENTILES], std::vector<std::pair<CAmount, int64_t>>& scores, int64_t total_weight);
 
@@ -55,6 +64,18 @@ UniValue CreateUTXOSnapshot(
     const fs::path& path,
     const fs::path& tmppath);
 
+//! First outpoint of range i when splitting the UTXO set into n_ranges ranges for FindScriptPubKey()
+COutPoint ScanRangeStart(size_t i, size_t n_ranges);
+
+/**
+ * Search for a given set of pubkey scripts.
+ *
+ * The UTXO set is split into as many ranges of txids as there are cursors, which
+ * are scanned in parallel. Each cursor must be positioned at the start of its
+ * range (see ScanRangeStart) and all of them must read the same UTXO set.
+ */
+bool FindScriptPubKey(std::atomic<int>& scan_progress, const std::atomic<bool>& should_abort, int64_t& count, const std::vector<std::unique_ptr<CCoinsViewCursor>>& cursors, const std::set<CScript>& scripts, std::map<COutPoint, Coin>& out_results, std::function<void()>& interruption_point);
+
 //! Return height of highest block that has been pruned, or std::nullopt if no blocks have been pruned
 std::optional<int> GetPruneHeight(const node::BlockManager& blockman, const CChain& chain) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
 void CheckBlockDataAvailability(node::BlockManager& blockman, const CBlockIndex& blockindex, bool check_for_undo) EXCLUSIVE_LOCKS_REQUIRED(::cs_main);
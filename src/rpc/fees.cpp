@@ -21,6 +21,7 @@
 #include <array>
 #include <cmath>
 #include <string>
+#include <vector>
 
 using common::FeeModeFromString;
 using common::FeeModesDetail;
@@ -39,6 +40,9 @@ static RPCHelpMan estimatesmartfee()
             {"conf_target", RPCArg::Type::NUM, RPCArg::Optional::NO, "Confirmation target in blocks (1 - 1008)"},
             {"estimate_mode", RPCArg::Type::STR, RPCArg::Default{"economical"}, "The fee estimate mode.\n"
               + FeeModesDetail(std::string("default mode will be used"))},
+            {"use_mempool", RPCArg::Type::BOOL, RPCArg::Default{false}, "Also project the next blocks from the current mempool contents.\n"
+              "If the mempool fills the first conf_target projected blocks, the lowest feerate in the last of them is\n"
+              "returned in economical mode, and raises the estimate from confirmed blocks in conservative mode."},
         },
         RPCResult{
             RPCResult::Type::OBJ, "", "",
@@ -80,6 +84,17 @@ static RPCHelpMan estimatesmartfee()
             UniValue errors(UniValue::VARR);
             FeeCalculation feeCalc;
             CFeeRate feeRate{fee_estimator.estimateSmartFee(conf_target, &feeCalc, conservative)};
+            if (!request.params[2].isNull() && request.params[2].get_bool()) {
+                const std::vector<CFeeRate> projected{mempool.GetProjectedBlockFeerates()};
+                if (conf_target <= projected.size()) {
+                    // The mempool is full enough to compete for conf_target blocks right now, which
+                    // confirmed blocks only reflect with a delay. Conservative estimates are only
+                    // ever raised by it.
+                    const CFeeRate& projected_feerate{projected[conf_target - 1]};
+                    feeRate = conservative ? std::max(feeRate, projected_feerate) : projected_feerate;
+                    feeCalc.returnedTarget = conf_target;
+                }
+            }
             if (feeRate != CFeeRate(0)) {
                 CFeeRate min_mempool_feerate{mempool.GetMinFee()};
                 CFeeRate min_relay_feerate{mempool.m_opts.min_relay_feerate};
@@ -92,6 +107,7 @@ static RPCHelpMan estimatesmartfee()
             result.pushKV("blocks", feeCalc.returnedTarget);
             return result;
         },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -4,6 +4,7 @@
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
 #include <rpc/blockchain.h>
+#include <rpc/mempool.h>
 
 #include <node/mempool_persist.h>
 
@@ -286,33 +287,82 @@ static std::vector<RPCResult> MempoolEntryDescription()
     };
 }
 
-static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
+static MempoolEntrySnapshot SnapshotEntry(const CTxMemPool& pool, const CTxMemPoolEntry& e) EXCLUSIVE_LOCKS_REQUIRED(pool.cs)
 {
     AssertLockHeld(pool.cs);
 
-    info.pushKV("vsize", (int)e.GetTxSize());
-    info.pushKV("weight", (int)e.GetTxWeight());
-    info.pushKV("time", count_seconds(e.GetTime()));
-    info.pushKV("height", (int)e.GetHeight());
-    info.pushKV("descendantcount", e.GetCountWithDescendants());
-    info.pushKV("descendantsize", e.GetSizeWithDescendants());
-    info.pushKV("ancestorcount", e.GetCountWithAncestors());
-    info.pushKV("ancestorsize", e.GetSizeWithAncestors());
-    info.pushKV("wtxid", e.GetTx().GetWitnessHash().ToString());
+    MempoolEntrySnapshot snapshot{
+        .tx = e.GetSharedTx(),
+        .vsize = e.GetTxSize(),
+        .weight = e.GetTxWeight(),
+        .time = e.GetTime(),
+        .height = e.GetHeight(),
+        .descendant_count = e.GetCountWithDescendants(),
+        .descendant_size = e.GetSizeWithDescendants(),
+        .ancestor_count = e.GetCountWithAncestors(),
+        .ancestor_size = e.GetSizeWithAncestors(),
+        .fee = e.GetFee(),
+        .modified_fee = e.GetModifiedFee(),
+        .ancestor_fees = e.GetModFeesWithAncestors(),
+        .descendant_fees = e.GetModFeesWithDescendants(),
+        .depends = {},
+        .spent_by = {},
+        .bip125_replaceable = false,
+        .unbroadcast = pool.IsUnbroadcastTx(e.GetTx().GetHash()),
+    };
+
+    const CTransaction& tx = e.GetTx();
+    for (const CTxIn& txin : tx.vin) {
+        if (pool.exists(txin.prevout.hash)) snapshot.depends.push_back(txin.prevout.hash);
+    }
+    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
+        snapshot.spent_by.push_back(child.GetTx().GetHash());
+    }
+
+    // Add opt-in RBF status
+    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
+    if (rbfState == RBFTransactionState::UNKNOWN) {
+        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
+    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
+        snapshot.bip125_replaceable = true;
+    }
+    return snapshot;
+}
+
+MempoolSnapshot SnapshotMempool(const CTxMemPool& pool)
+{
+    MempoolSnapshot snapshot;
+    LOCK(pool.cs);
+    snapshot.entries.reserve(pool.size());
+    for (const CTxMemPoolEntry& e : pool.entryAll()) {
+        snapshot.entries.push_back(SnapshotEntry(pool, e));
+    }
+    snapshot.mempool_sequence = pool.GetSequence();
+    return snapshot;
+}
+
+static void entryToJSON(UniValue& info, const MempoolEntrySnapshot& e)
+{
+    info.pushKV("vsize", e.vsize);
+    info.pushKV("weight", e.weight);
+    info.pushKV("time", count_seconds(e.time));
+    info.pushKV("height", (int)e.height);
+    info.pushKV("descendantcount", e.descendant_count);
+    info.pushKV("descendantsize", e.descendant_size);
+    info.pushKV("ancestorcount", e.ancestor_count);
+    info.pushKV("ancestorsize", e.ancestor_size);
+    info.pushKV("wtxid", e.tx->GetWitnessHash().ToString());
 
     UniValue fees(UniValue::VOBJ);
-    fees.pushKV("base", ValueFromAmount(e.GetFee()));
-    fees.pushKV("modified", ValueFromAmount(e.GetModifiedFee()));
-    fees.pushKV("ancestor", ValueFromAmount(e.GetModFeesWithAncestors()));
-    fees.pushKV("descendant", ValueFromAmount(e.GetModFeesWithDescendants()));
+    fees.pushKV("base", ValueFromAmount(e.fee));
+    fees.pushKV("modified", ValueFromAmount(e.modified_fee));
+    fees.pushKV("ancestor", ValueFromAmount(e.ancestor_fees));
+    fees.pushKV("descendant", ValueFromAmount(e.descendant_fees));
     info.pushKV("fees", std::move(fees));
 
-    const CTransaction& tx = e.GetTx();
     std::set<std::string> setDepends;
-    for (const CTxIn& txin : tx.vin)
-    {
-        if (pool.exists(txin.prevout.hash))
-            setDepends.insert(txin.prevout.hash.ToString());
+    for (const Txid& parent : e.depends) {
+        setDepends.insert(parent.ToString());
     }
 
     UniValue depends(UniValue::VARR);
@@ -324,23 +374,14 @@ static void entryToJSON(const CTxMemPool& pool, UniValue& info, const CTxMemPool
     info.pushKV("depends", std::move(depends));
 
     UniValue spent(UniValue::VARR);
-    for (const CTxMemPoolEntry& child : e.GetMemPoolChildrenConst()) {
-        spent.push_back(child.GetTx().GetHash().ToString());
+    for (const Txid& child : e.spent_by) {
+        spent.push_back(child.ToString());
     }
 
     info.pushKV("spentby", std::move(spent));
 
-    // Add opt-in RBF status
-    bool rbfStatus = false;
-    RBFTransactionState rbfState = IsRBFOptIn(tx, pool);
-    if (rbfState == RBFTransactionState::UNKNOWN) {
-        throw JSONRPCError(RPC_MISC_ERROR, "Transaction is not in mempool");
-    } else if (rbfState == RBFTransactionState::REPLACEABLE_BIP125) {
-        rbfStatus = true;
-    }
-
-    info.pushKV("bip125-replaceable", rbfStatus);
-    info.pushKV("unbroadcast", pool.IsUnbroadcastTx(tx.GetHash()));
+    info.pushKV("bip125-replaceable", e.bip125_replaceable);
+    info.pushKV("unbroadcast", e.unbroadcast);
 }
 
 UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempool_sequence)
@@ -349,27 +390,33 @@ UniValue MempoolToJSON(const CTxMemPool& pool, bool verbose, bool include_mempoo
         if (include_mempool_sequence) {
             throw JSONRPCError(RPC_INVALID_PARAMETER, "Verbose results cannot contain mempool sequence values.");
         }
-        LOCK(pool.cs);
+        // Only copy the entries under the mempool lock, as formatting a large mempool takes a while.
+        const MempoolSnapshot snapshot{SnapshotMempool(pool)};
         UniValue o(UniValue::VOBJ);
-        for (const CTxMemPoolEntry& e : pool.entryAll()) {
+        for (const MempoolEntrySnapshot& e : snapshot.entries) {
             UniValue info(UniValue::VOBJ);
-            entryToJSON(pool, info, e);
+            entryToJSON(info, e);
             // Mempool has unique entries so there is no advantage in using
             // UniValue::pushKV, which checks if the key already exists in O(N).
             // UniValue::pushKVEnd is used instead which currently is O(1).
-            o.pushKVEnd(e.GetTx().GetHash().ToString(), std::move(info));
+            o.pushKVEnd(e.tx->GetHash().ToString(), std::move(info));
         }
         return o;
     } else {
-        UniValue a(UniValue::VARR);
+        std::vector<Txid> txids;
         uint64_t mempool_sequence;
         {
             LOCK(pool.cs);
+            txids.reserve(pool.size());
             for (const CTxMemPoolEntry& e : pool.entryAll()) {
-                a.push_back(e.GetTx().GetHash().ToString());
+                txids.push_back(e.GetTx().GetHash());
             }
             mempool_sequence = pool.GetSequence();
         }
+        UniValue a(UniValue::VARR);
+        for (const Txid& txid : txids) {
+            a.push_back(txid.ToString());
+        }
         if (!include_mempool_sequence) {
             return a;
         } else {
@@ -429,6 +476,7 @@ static RPCHelpMan getrawmempool()
 
     return MempoolToJSON(EnsureAnyMemPool(request.context), fVerbose, include_mempool_sequence);
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -484,12 +532,13 @@ static RPCHelpMan getmempoolancestors()
         for (CTxMemPool::txiter ancestorIt : ancestors) {
             const CTxMemPoolEntry &e = *ancestorIt;
             UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
+            entryToJSON(info, SnapshotEntry(mempool, e));
             o.pushKV(e.GetTx().GetHash().ToString(), std::move(info));
         }
         return o;
     }
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -549,12 +598,13 @@ static RPCHelpMan getmempooldescendants()
         for (CTxMemPool::txiter descendantIt : setDescendants) {
             const CTxMemPoolEntry &e = *descendantIt;
             UniValue info(UniValue::VOBJ);
-            entryToJSON(mempool, info, e);
+            entryToJSON(info, SnapshotEntry(mempool, e));
             o.pushKV(e.GetTx().GetHash().ToString(), std::move(info));
         }
         return o;
     }
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -585,9 +635,10 @@ static RPCHelpMan getmempoolentry()
     }
 
     UniValue info(UniValue::VOBJ);
-    entryToJSON(mempool, info, *entry);
+    entryToJSON(info, SnapshotEntry(mempool, *entry));
     return info;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -724,6 +775,7 @@ static RPCHelpMan getmempoolinfo()
 {
     return MempoolInfoToJSON(EnsureAnyMemPool(request.context));
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -807,6 +859,7 @@ static RPCHelpMan savemempool()
 {
     const ArgsManager& args{EnsureAnyArgsman(request.context)};
     const CTxMemPool& mempool = EnsureAnyMemPool(request.context);
+    ChainstateManager& chainman = EnsureAnyChainman(request.context);
 
     if (!mempool.GetLoadTried()) {
         throw JSONRPCError(RPC_MISC_ERROR, "The mempool was not loaded yet");
@@ -814,7 +867,10 @@ static RPCHelpMan savemempool()
 
     const fs::path& dump_path = MempoolPath(args);
 
-    if (!DumpMempool(mempool, dump_path)) {
+    // Read the tip before copying the mempool, so a block connected in between makes the
+    // dump look outdated rather than the other way around.
+    const uint256 tip_hash{WITH_LOCK(::cs_main, return chainman.ActiveTip()->GetBlockHash())};
+    if (!DumpMempool(mempool, dump_path, tip_hash)) {
         throw JSONRPCError(RPC_MISC_ERROR, "Unable to dump mempool to disk");
     }
 
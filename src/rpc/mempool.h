@@ -5,9 +5,51 @@
 #ifndef BITCOIN_RPC_MEMPOOL_H
 #define BITCOIN_RPC_MEMPOOL_H
 
+#include <consensus/amount.h>
+#include <primitives/transaction.h>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
 class CTxMemPool;
+class CTxMemPoolEntry;
 class UniValue;
 
+/**
+ * Copy of the data of a mempool entry which is returned by RPC and REST. It is taken while
+ * holding the mempool lock, so that formatting it does not block the mempool.
+ */
+struct MempoolEntrySnapshot {
+    CTransactionRef tx;
+    int32_t vsize;
+    int32_t weight;
+    std::chrono::seconds time;
+    unsigned int height;
+    uint64_t descendant_count;
+    int64_t descendant_size;
+    uint64_t ancestor_count;
+    int64_t ancestor_size;
+    CAmount fee;
+    CAmount modified_fee;
+    CAmount ancestor_fees;
+    CAmount descendant_fees;
+    //! In-mempool parents, possibly repeated once per input spending them
+    std::vector<Txid> depends;
+    std::vector<Txid> spent_by;
+    bool bip125_replaceable;
+    bool unbroadcast;
+};
+
+/** Snapshot of all mempool entries, consistent with the mempool sequence number it was taken at. */
+struct MempoolSnapshot {
+    std::vector<MempoolEntrySnapshot> entries;
+    uint64_t mempool_sequence;
+};
+
+/** Copy the data of all mempool entries, only holding the mempool lock while doing so. */
+MempoolSnapshot SnapshotMempool(const CTxMemPool& pool);
+
 /** Mempool information to JSON */
 UniValue MempoolInfoToJSON(const CTxMemPool& pool);
 
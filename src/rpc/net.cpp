@@ -605,6 +605,64 @@ static RPCHelpMan getnettotals()
     };
 }
 
+static RPCHelpMan getnetmsgstats()
+{
+    const auto histogram_doc{strprintf("%u histogram buckets: bucket 0 counts durations below 1 microsecond, bucket i counts durations from 2^(i-1) to 2^i microseconds, the last bucket also counts anything longer", MsgTypeProcessingStats::HISTOGRAM_BUCKETS)};
+    return RPCHelpMan{"getnetmsgstats",
+        "Returns statistics about the time spent processing received P2P messages, by message type.\n"
+        "Only message types that have been processed at least once are included. Unknown message types are counted as \"" + NET_MESSAGE_TYPE_OTHER + "\".",
+        {},
+        RPCResult{
+            RPCResult::Type::OBJ_DYN, "", "json object with message type as keys",
+            {
+                {RPCResult::Type::OBJ, "msg_type", "",
+                {
+                    {RPCResult::Type::NUM, "count", "Number of messages processed"},
+                    {RPCResult::Type::NUM, "processing_time", "Total time spent processing messages, in microseconds"},
+                    {RPCResult::Type::NUM, "max_processing_time", "Longest time spent processing a single message, in microseconds"},
+                    {RPCResult::Type::NUM, "queue_wait_time", "Total time messages waited between being received and being processed, in microseconds"},
+                    {RPCResult::Type::ARR_FIXED, "processing_time_histogram", "Processing time distribution, " + histogram_doc,
+                    {
+                        {RPCResult::Type::NUM, "", "Number of messages in this bucket"},
+                    }},
+                    {RPCResult::Type::ARR_FIXED, "queue_wait_histogram", "Queue wait time distribution, " + histogram_doc,
+                    {
+                        {RPCResult::Type::NUM, "", "Number of messages in this bucket"},
+                    }},
+                }},
+            }
+        },
+        RPCExamples{
+            HelpExampleCli("getnetmsgstats", "")
+            + HelpExampleRpc("getnetmsgstats", "")
+        },
+        [&](const RPCHelpMan& self, const JSONRPCRequest& request) -> UniValue
+{
+    NodeContext& node = EnsureAnyNodeContext(request.context);
+    const PeerManager& peerman = EnsurePeerman(node);
+
+    UniValue ret(UniValue::VOBJ);
+    for (const auto& [msg_type, stats] : peerman.GetMsgTypeProcessingStats()) {
+        if (stats.count == 0) continue;
+        UniValue processing_hist(UniValue::VARR);
+        for (const uint64_t n : stats.processing_time_histogram) processing_hist.push_back(n);
+        UniValue queue_wait_hist(UniValue::VARR);
+        for (const uint64_t n : stats.queue_wait_histogram) queue_wait_hist.push_back(n);
+
+        UniValue obj(UniValue::VOBJ);
+        obj.pushKV("count", stats.count);
+        obj.pushKV("processing_time", count_microseconds(stats.processing_time));
+        obj.pushKV("max_processing_time", count_microseconds(stats.max_processing_time));
+        obj.pushKV("queue_wait_time", count_microseconds(stats.queue_wait_time));
+        obj.pushKV("processing_time_histogram", std::move(processing_hist));
+        obj.pushKV("queue_wait_histogram", std::move(queue_wait_hist));
+        ret.pushKV(msg_type, std::move(obj));
+    }
+    return ret;
+},
+    };
+}
+
 static UniValue GetNetworksInfo()
 {
     UniValue networks(UniValue::VARR);
@@ -1202,6 +1260,7 @@ void RegisterNetRPCCommands(CRPCTable& t)
         {"network", &disconnectnode},
         {"network", &getaddednodeinfo},
         {"network", &getnettotals},
+        {"network", &getnetmsgstats},
         {"network", &getnetworkinfo},
         {"network", &setban},
         {"network", &listbanned},
@@ -82,6 +82,7 @@ static RPCHelpMan validateaddress()
 
             return ret;
         },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -220,6 +221,7 @@ static RPCHelpMan getdescriptorinfo()
             result.pushKV("hasprivatekeys", provider.keys.size() > 0);
             return result;
         },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -340,6 +342,7 @@ static RPCHelpMan deriveaddresses()
             }
             return ret;
         },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
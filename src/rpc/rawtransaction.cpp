@@ -412,6 +412,7 @@ static RPCHelpMan getrawtransaction()
     TxToJSON(*tx, hash_block, result, chainman.ActiveChainstate(), undoTX, TxVerbosity::SHOW_DETAILS_AND_PREVOUT);
     return result;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -485,6 +486,7 @@ static RPCHelpMan decoderawtransaction()
 
     return result;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -620,6 +622,7 @@ static RPCHelpMan decodescript()
 
     return r;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -1552,6 +1555,7 @@ static RPCHelpMan decodepsbt()
 
     return result;
 },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -9,6 +9,7 @@
 
 #include <common/args.h>
 #include <common/system.h>
+#include <httpserver.h>
 #include <logging.h>
 #include <node/context.h>
 #include <node/kernel_notifications.h>
@@ -22,12 +23,17 @@
 #include <validation.h>
 
 #include <algorithm>
+#include <array>
+#include <bit>
 #include <cassert>
 #include <chrono>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <string_view>
 #include <unordered_map>
 
+using namespace std::literals;
 using util::SplitString;
 
 static GlobalMutex g_rpc_warmup_mutex;
@@ -42,10 +48,47 @@ struct RPCCommandExecutionInfo
     SteadyClock::time_point start;
 };
 
+/** Time statistics for one phase of the requests for one method. */
+struct RPCPhaseStats
+{
+    /** Number of histogram buckets. Bucket 0 counts durations below 1 microsecond, bucket i
+     *  counts durations in [2^(i-1), 2^i) microseconds, and the last bucket also counts
+     *  anything longer. */
+    static constexpr size_t HISTOGRAM_BUCKETS{24};
+
+    uint64_t count{0};
+    std::chrono::microseconds total{0};
+    std::chrono::microseconds max{0};
+    std::array<uint64_t, HISTOGRAM_BUCKETS> histogram{};
+
+    void Update(std::chrono::microseconds duration)
+    {
+        duration = std::max(duration, 0us);
+        ++count;
+        total += duration;
+        max = std::max(max, duration);
+        ++histogram[std::min<size_t>(std::bit_width(uint64_t(duration.count())), HISTOGRAM_BUCKETS - 1)];
+    }
+};
+
+using RPCMethodStats = std::array<RPCPhaseStats, NUM_RPC_PHASES>;
+
+//! Method under which unknown methods and batch requests are counted
+static constexpr std::string_view RPC_METHOD_OTHER{"*other*"};
+
 struct RPCServerInfo
 {
     Mutex mutex;
     std::list<RPCCommandExecutionInfo> active_commands GUARDED_BY(mutex);
+    //! Phase timings by method. Contains an entry for every registered method.
+    std::map<std::string, RPCMethodStats, std::less<>> method_stats GUARDED_BY(mutex);
+
+    RPCMethodStats& GetMethodStats(std::string_view method) EXCLUSIVE_LOCKS_REQUIRED(mutex)
+    {
+        auto it{method_stats.find(method)};
+        if (it == method_stats.end()) it = method_stats.try_emplace(std::string{RPC_METHOD_OTHER}).first;
+        return it->second;
+    }
 };
 
 static RPCServerInfo g_rpc_server_info;
@@ -60,11 +103,19 @@ struct RPCCommandExecution
     }
     ~RPCCommandExecution()
     {
+        const auto duration{std::chrono::duration_cast<std::chrono::microseconds>(SteadyClock::now() - it->start)};
         LOCK(g_rpc_server_info.mutex);
+        g_rpc_server_info.GetMethodStats(it->method)[size_t(RPCPhase::EXECUTION)].Update(duration);
         g_rpc_server_info.active_commands.erase(it);
     }
 };
 
+void RecordRPCPhaseTime(std::string_view method, RPCPhase phase, std::chrono::microseconds duration)
+{
+    LOCK(g_rpc_server_info.mutex);
+    g_rpc_server_info.GetMethodStats(method)[size_t(phase)].Update(duration);
+}
+
 std::string CRPCTable::help(const std::string& strCommand, const JSONRPCRequest& helpreq) const
 {
     std::string strRet;
@@ -193,6 +244,18 @@ static RPCHelpMan uptime()
 
 static RPCHelpMan getrpcinfo()
 {
+    const auto phase_doc{[](const std::string& name, const std::string& description) -> RPCResult {
+        return {RPCResult::Type::OBJ, name, /*optional=*/true, description,
+        {
+            {RPCResult::Type::NUM, "count", "Number of requests timed"},
+            {RPCResult::Type::NUM, "total", "Total time, in microseconds"},
+            {RPCResult::Type::NUM, "max", "Longest time for a single request, in microseconds"},
+            {RPCResult::Type::ARR_FIXED, "histogram", strprintf("Time distribution, %u histogram buckets: bucket 0 counts durations below 1 microsecond, bucket i counts durations from 2^(i-1) to 2^i microseconds, the last bucket also counts anything longer", RPCPhaseStats::HISTOGRAM_BUCKETS),
+            {
+                {RPCResult::Type::NUM, "", "Number of requests in this bucket"},
+            }},
+        }};
+    }};
     return RPCHelpMan{
         "getrpcinfo",
         "Returns details of the RPC server.\n",
@@ -209,6 +272,29 @@ static RPCHelpMan getrpcinfo()
                             }},
                         }},
                         {RPCResult::Type::STR, "logpath", "The complete file path to the debug log"},
+                        {RPCResult::Type::ARR, "work_queue", /*optional=*/true, "Counters of the HTTP work queue for each priority, if the HTTP server is running",
+                        {
+                            {RPCResult::Type::OBJ, "", "",
+                            {
+                                {RPCResult::Type::STR, "priority", "\"high\" for cheap requests served first, or \"normal\""},
+                                {RPCResult::Type::NUM, "queued", "Requests waiting for a worker thread"},
+                                {RPCResult::Type::NUM, "processed", "Requests taken by a worker thread since startup"},
+                                {RPCResult::Type::NUM, "rejected", "Requests rejected since startup because -rpcworkqueue of them were already waiting"},
+                                {RPCResult::Type::NUM, "total_wait", "Total time processed requests waited for a worker thread, in microseconds"},
+                                {RPCResult::Type::NUM, "max_wait", "Longest time a processed request waited for a worker thread, in microseconds"},
+                            }},
+                        }},
+                        {RPCResult::Type::OBJ_DYN, "methods", "Timings of the phases of serving requests, for each method that was called. "
+                                                              "Batch requests as a whole and unknown methods are counted as \"" + std::string{RPC_METHOD_OTHER} + "\". Phases that were not timed for a method are omitted.",
+                        {
+                            {RPCResult::Type::OBJ, "method", "",
+                            {
+                                phase_doc("queue", "Time requests waited for an HTTP worker thread"),
+                                phase_doc("execution", "Time spent executing the method, for each call including those in batch requests"),
+                                phase_doc("serialization", "Time spent writing the reply as JSON and handing it over for sending. Large replies are sent in pieces while they are written, so part of their sending overlaps with this phase"),
+                                phase_doc("send", "Time from handing the reply over for sending until it was written to the connection. Like serialization, only timed for replies that were sent completely"),
+                            }},
+                        }},
                     }
                 },
                 RPCExamples{
@@ -232,6 +318,41 @@ static RPCHelpMan getrpcinfo()
     UniValue log_path(UniValue::VSTR, path);
     result.pushKV("logpath", std::move(log_path));
 
+    if (const auto queue_stats{GetHTTPWorkQueueStats()}; !queue_stats.empty()) {
+        UniValue work_queue(UniValue::VARR);
+        for (size_t p{0}; p < queue_stats.size(); ++p) {
+            const HTTPWorkQueueStats& stats{queue_stats[p]};
+            UniValue entry(UniValue::VOBJ);
+            entry.pushKV("priority", static_cast<HTTPPriority>(p) == HTTPPriority::HIGH ? "high" : "normal");
+            entry.pushKV("queued", uint64_t{stats.queued});
+            entry.pushKV("processed", stats.processed);
+            entry.pushKV("rejected", stats.rejected);
+            entry.pushKV("total_wait", int64_t{stats.total_wait.count()});
+            entry.pushKV("max_wait", int64_t{stats.max_wait.count()});
+            work_queue.push_back(std::move(entry));
+        }
+        result.pushKV("work_queue", std::move(work_queue));
+    }
+
+    static constexpr std::array<std::string_view, NUM_RPC_PHASES> PHASE_NAMES{"queue", "execution", "serialization", "send"};
+    UniValue methods(UniValue::VOBJ);
+    for (const auto& [method, stats] : g_rpc_server_info.method_stats) {
+        UniValue phases(UniValue::VOBJ);
+        for (size_t p{0}; p < NUM_RPC_PHASES; ++p) {
+            if (stats[p].count == 0) continue;
+            UniValue histogram(UniValue::VARR);
+            for (const uint64_t n : stats[p].histogram) histogram.push_back(n);
+            UniValue phase(UniValue::VOBJ);
+            phase.pushKV("count", stats[p].count);
+            phase.pushKV("total", int64_t{stats[p].total.count()});
+            phase.pushKV("max", int64_t{stats[p].max.count()});
+            phase.pushKV("histogram", std::move(histogram));
+            phases.pushKV(std::string{PHASE_NAMES[p]}, std::move(phase));
+        }
+        if (!phases.empty()) methods.pushKV(method, std::move(phases));
+    }
+    result.pushKV("methods", std::move(methods));
+
     return result;
 }
     };
@@ -257,6 +378,7 @@ void CRPCTable::appendCommand(const std::string& name, const CRPCCommand* pcmd)
     CHECK_NONFATAL(!IsRPCRunning()); // Only add commands before rpc is running
 
     mapCommands[name].push_back(pcmd);
+    WITH_LOCK(g_rpc_server_info.mutex, g_rpc_server_info.method_stats.try_emplace(name));
 }
 
 bool CRPCTable::removeCommand(const std::string& name, const CRPCCommand* pcmd)
@@ -272,6 +394,13 @@ bool CRPCTable::removeCommand(const std::string& name, const CRPCCommand* pcmd)
     return false;
 }
 
+bool CRPCTable::isParallelSafe(std::string_view name) const
+{
+    auto it = mapCommands.find(std::string{name});
+    if (it == mapCommands.end() || it->second.empty()) return false;
+    return std::ranges::all_of(it->second, [](const CRPCCommand* command) { return command->parallel_safe; });
+}
+
 void StartRPC()
 {
     LogDebug(BCLog::RPC, "Starting RPC\n");
@@ -345,6 +474,11 @@ bool IsDeprecatedRPCEnabled(const std::string& method)
     return find(enabled_methods.begin(), enabled_methods.end(), method) != enabled_methods.end();
 }
 
+bool IsRPCParallelSafe(std::string_view method)
+{
+    return tableRPC.isParallelSafe(method);
+}
+
 UniValue JSONRPCExec(const JSONRPCRequest& jreq, bool catch_errors)
 {
     UniValue result;
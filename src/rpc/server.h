@@ -9,10 +9,13 @@
 #include <rpc/request.h>
 #include <rpc/util.h>
 
+#include <chrono>
+#include <cstddef>
 #include <cstdint>
 #include <functional>
 #include <map>
 #include <string>
+#include <string_view>
 
 #include <univalue.h>
 
@@ -47,9 +50,9 @@ public:
     using Actor = std::function<bool(const JSONRPCRequest& request, UniValue& result, bool last_handler)>;
 
     //! Constructor taking Actor callback supporting multiple handlers.
-    CRPCCommand(std::string category, std::string name, Actor actor, std::vector<std::pair<std::string, bool>> args, intptr_t unique_id)
+    CRPCCommand(std::string category, std::string name, Actor actor, std::vector<std::pair<std::string, bool>> args, intptr_t unique_id, bool parallel_safe = false)
         : category(std::move(category)), name(std::move(name)), actor(std::move(actor)), argNames(std::move(args)),
-          unique_id(unique_id)
+          unique_id(unique_id), parallel_safe(parallel_safe)
     {
     }
 
@@ -60,7 +63,8 @@ public:
               fn().m_name,
               [fn](const JSONRPCRequest& request, UniValue& result, bool) { result = fn().HandleRequest(request); return true; },
               fn().GetArgNames(),
-              intptr_t(fn))
+              intptr_t(fn),
+              fn().m_opts.parallel_safe)
     {
     }
 
@@ -78,6 +82,8 @@ public:
     //! appended after other arguments, see transformNamedArguments for details.
     std::vector<std::pair<std::string, bool>> argNames;
     intptr_t unique_id;
+    //! Whether the handler only reads node state, see RPCMethodOptions::parallel_safe.
+    bool parallel_safe;
 };
 
 /**
@@ -124,10 +130,39 @@ public:
      */
     void appendCommand(const std::string& name, const CRPCCommand* pcmd);
     bool removeCommand(const std::string& name, const CRPCCommand* pcmd);
+
+    /**
+     * Whether every handler registered for a method is marked parallel_safe, see
+     * IsRPCParallelSafe(). Unknown methods are not.
+     */
+    bool isParallelSafe(std::string_view name) const;
 };
 
 bool IsDeprecatedRPCEnabled(const std::string& method);
 
+/**
+ * Whether a method only reads node state, so that the elements of a batch calling
+ * it can be executed concurrently and in any order relative to each other. Methods
+ * declare this with RPCMethodOptions::parallel_safe.
+ */
+bool IsRPCParallelSafe(std::string_view method);
+
+/** Phases of serving an RPC request that are timed per method, see getrpcinfo. */
+enum class RPCPhase : size_t {
+    QUEUE,         //!< Waiting for an HTTP worker thread
+    EXECUTION,     //!< Running the method
+    SERIALIZATION, //!< Writing the reply as JSON and handing it to the event loop thread
+    SEND,          //!< Writing the reply to the connection
+};
+static constexpr size_t NUM_RPC_PHASES{4};
+
+/**
+ * Record how long a phase of serving a request for a method took. Durations for
+ * unknown methods, and for batch requests as a whole, which are recorded with an
+ * empty method, are counted under "*other*".
+ */
+void RecordRPCPhaseTime(std::string_view method, RPCPhase phase, std::chrono::microseconds duration);
+
 extern CRPCTable tableRPC;
 
 void StartRPC();
@@ -123,6 +123,7 @@ static RPCHelpMan gettxoutproof()
             std::string strHex = HexStr(ssMB);
             return strHex;
         },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -172,6 +173,7 @@ static RPCHelpMan verifytxoutproof()
 
             return res;
         },
+        RPCMethodOptions{.parallel_safe = true},
     };
 }
 
@@ -415,12 +415,17 @@ struct RPCExamples {
     std::string ToDescriptionString() const;
 };
 
+struct RPCMethodOptions {
+    bool parallel_safe{false}; //!< Whether the method only reads node state, so that the elements of a batch calling it
+                               //!< can be executed concurrently and in any order relative to each other
+};
+
 class RPCHelpMan
 {
 public:
     RPCHelpMan(std::string name, std::string description, std::vector<RPCArg> args, RPCResults results, RPCExamples examples);
     using RPCMethodImpl = std::function<UniValue(const RPCHelpMan&, const JSONRPCRequest&)>;
-    RPCHelpMan(std::string name, std::string description, std::vector<RPCArg> args, RPCResults results, RPCExamples examples, RPCMethodImpl fun);
+    RPCHelpMan(std::string name, std::string description, std::vector<RPCArg> args, RPCResults results, RPCExamples examples, RPCMethodImpl fun, RPCMethodOptions opts = {});
 
     UniValue HandleRequest(const JSONRPCRequest& request) const;
     /**
@@ -494,6 +499,7 @@ public:
     std::vector<std::pair<std::string, bool>> GetArgNames() const;
 
     const std::string m_name;
+    const RPCMethodOptions m_opts;
 
 private:
     const RPCMethodImpl m_fun;
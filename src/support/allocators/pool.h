@@ -121,6 +121,12 @@ class PoolResource final
      */
     std::byte* m_available_memory_end = nullptr;
 
+    /**
+     * Bytes of all blocks currently handed out, rounded up to the alignment for those that came
+     * from the pool, and including those that were forwarded to ::operator new().
+     */
+    std::size_t m_used_bytes = 0;
+
     /**
      * How many multiple of ELEM_ALIGN_BYTES are necessary to fit bytes. We use that result directly as an index
      * into m_free_lists. Round up for the special case when bytes==0.
@@ -219,6 +225,7 @@ public:
     {
         if (IsFreeListUsable(bytes, alignment)) {
             const std::size_t num_alignments = NumElemAlignBytes(bytes);
+            m_used_bytes += num_alignments * ELEM_ALIGN_BYTES;
             if (nullptr != m_free_lists[num_alignments]) {
                 // we've already got data in the pool's freelist, unlink one element and return the pointer
                 // to the unlinked memory. Since FreeList is trivially destructible we can just treat it as
@@ -243,6 +250,7 @@ public:
         }
 
         // Can't use the pool => use operator new()
+        m_used_bytes += bytes;
         return ::operator new (bytes, std::align_val_t{alignment});
     }
 
@@ -253,6 +261,7 @@ public:
     {
         if (IsFreeListUsable(bytes, alignment)) {
             const std::size_t num_alignments = NumElemAlignBytes(bytes);
+            m_used_bytes -= num_alignments * ELEM_ALIGN_BYTES;
             // put the memory block into the linked list. We can placement construct the FreeList
             // into the memory since we can be sure the alignment is correct.
             ASAN_UNPOISON_MEMORY_REGION(p, sizeof(ListNode));
@@ -260,6 +269,7 @@ public:
             ASAN_POISON_MEMORY_REGION(p, std::max(bytes, sizeof(ListNode)));
         } else {
             // Can't use the pool => forward deallocation to ::operator delete().
+            m_used_bytes -= bytes;
             ::operator delete (p, std::align_val_t{alignment});
         }
     }
@@ -272,6 +282,15 @@ public:
         return m_allocated_chunks.size();
     }
 
+    /**
+     * Number of bytes currently allocated through this resource. Unlike the allocated chunks,
+     * this shrinks again when blocks are deallocated.
+     */
+    [[nodiscard]] std::size_t UsedBytes() const
+    {
+        return m_used_bytes;
+    }
+
     /**
      * Size in bytes to allocate per chunk, currently hardcoded to a fixed size.
      */
@@ -354,6 +354,37 @@ BOOST_AUTO_TEST_CASE(ReceiveWithExtraTransactions) {
     }
 }
 
+BOOST_AUTO_TEST_CASE(ReceiveWithLargeMempool) {
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    TestMemPoolEntryHelper entry;
+    auto rand_ctx(FastRandomContext(uint256{42}));
+
+    CBlock block(BuildBlockTestCase(rand_ctx));
+
+    LOCK2(cs_main, pool.cs);
+    // Fill the mempool past the threshold at which short IDs are computed in parallel
+    CMutableTransaction mtx = BuildTransactionTestCase();
+    for (size_t i = 0; i < SHORTID_PARALLEL_MIN_TXS * 2; ++i) {
+        mtx.vin[0].prevout.hash = Txid::FromUint256(rand_ctx.rand256());
+        AddToMempool(pool, entry.FromTx(mtx));
+    }
+    AddToMempool(pool, entry.FromTx(block.vtx[2]));
+    BOOST_CHECK_GE(pool.size(), SHORTID_PARALLEL_MIN_TXS);
+
+    {
+        const CBlockHeaderAndShortTxIDs cmpctblock{block, rand_ctx.rand64()};
+        PartiallyDownloadedBlock partial_block(&pool);
+        BOOST_CHECK(partial_block.InitData(cmpctblock, empty_extra_txn) == READ_STATUS_OK);
+        BOOST_CHECK( partial_block.IsTxAvailable(0));
+        BOOST_CHECK(!partial_block.IsTxAvailable(1));
+        BOOST_CHECK( partial_block.IsTxAvailable(2));
+
+        CBlock block2;
+        BOOST_CHECK(partial_block.FillBlock(block2, {block.vtx[1]}, /*segwit_active=*/true) == READ_STATUS_OK);
+        BOOST_CHECK_EQUAL(block.GetHash().ToString(), block2.GetHash().ToString());
+    }
+}
+
 BOOST_AUTO_TEST_CASE(TransactionsRequestSerializationTest) {
     BlockTransactionsRequest req1;
     req1.blockhash = m_rng.rand256();
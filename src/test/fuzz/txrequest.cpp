@@ -12,6 +12,7 @@
 #include <bitset>
 #include <cstdint>
 #include <queue>
+#include <utility>
 #include <vector>
 
 namespace {
@@ -186,10 +187,10 @@ public:
         m_tracker.ForgetTxHash(TXHASHES[txhash]);
     }
 
-    void ReceivedInv(int peer, int txhash, bool is_wtxid, bool preferred, std::chrono::microseconds reqtime)
+    //! Apply an announcement to the naive structure, and return its GenTxid.
+    GenTxid NaiveReceivedInv(int peer, int txhash, bool is_wtxid, bool preferred, std::chrono::microseconds reqtime)
     {
-        // Apply to naive structure: if no announcement for txidnum/peer combination
-        // already, create a new CANDIDATE; otherwise do nothing.
+        // If no announcement for txidnum/peer combination already, create a new CANDIDATE; otherwise do nothing.
         Announcement& ann = m_announcements[txhash][peer];
         if (ann.m_state == State::NOTHING) {
             ann.m_preferred = preferred;
@@ -202,12 +203,29 @@ public:
             // Add event so that AdvanceToEvent can quickly jump to the point where its reqtime passes.
             if (reqtime > m_now) m_events.push(reqtime);
         }
+        return is_wtxid ? GenTxid{Wtxid::FromUint256(TXHASHES[txhash])} : GenTxid{Txid::FromUint256(TXHASHES[txhash])};
+    }
+
+    void ReceivedInv(int peer, int txhash, bool is_wtxid, bool preferred, std::chrono::microseconds reqtime)
+    {
+        const auto gtxid{NaiveReceivedInv(peer, txhash, is_wtxid, preferred, reqtime)};
 
         // Call TxRequestTracker's implementation.
-        auto gtxid = is_wtxid ? GenTxid{Wtxid::FromUint256(TXHASHES[txhash])} : GenTxid{Txid::FromUint256(TXHASHES[txhash])};
         m_tracker.ReceivedInv(peer, gtxid, preferred, reqtime);
     }
 
+    void ReceivedInvs(int peer, const std::vector<std::pair<int, bool>>& txhashes, bool preferred, std::chrono::microseconds reqtime)
+    {
+        // Apply to naive structure: the same as individual announcements, in order.
+        std::vector<GenTxid> gtxids;
+        for (const auto& [txhash, is_wtxid] : txhashes) {
+            gtxids.push_back(NaiveReceivedInv(peer, txhash, is_wtxid, preferred, reqtime));
+        }
+
+        // Call TxRequestTracker's implementation.
+        m_tracker.ReceivedInvs(peer, gtxids, preferred, reqtime);
+    }
+
     void RequestedTx(int peer, int txhash, std::chrono::microseconds exptime)
     {
         // Apply to naive structure: if a CANDIDATE announcement exists for peer/txhash,
@@ -333,7 +351,7 @@ FUZZ_TARGET(txrequest)
     // Decode the input as a sequence of instructions with parameters
     auto it = buffer.begin();
     while (it != buffer.end()) {
-        int cmd = *(it++) % 11;
+        int cmd = *(it++) % 12;
         int peer, txidnum, delaynum;
         switch (cmd) {
         case 0: // Make time jump to the next event (m_time of CANDIDATE or REQUESTED)
@@ -381,6 +399,21 @@ FUZZ_TARGET(txrequest)
             txidnum = it == buffer.end() ? 0 : *(it++);
             tester.ReceivedResponse(peer, txidnum % MAX_TXHASHES);
             break;
+        case 11: // Received inv message with multiple announcements, delayed and preferred or not
+        {
+            peer = it == buffer.end() ? 0 : *(it++) % MAX_PEERS;
+            const int flags = it == buffer.end() ? 0 : *(it++);
+            delaynum = it == buffer.end() ? 0 : *(it++);
+            std::vector<std::pair<int, bool>> txhashes;
+            // Up to 2 * MAX_TXHASHES announcements, so that duplicates within one batch are exercised.
+            const int count = 1 + (flags >> 1) % (2 * MAX_TXHASHES);
+            for (int i = 0; i < count; ++i) {
+                txidnum = it == buffer.end() ? 0 : *(it++);
+                txhashes.emplace_back(txidnum % MAX_TXHASHES, (txidnum / MAX_TXHASHES) & 1);
+            }
+            tester.ReceivedInvs(peer, txhashes, flags & 1, tester.Now() + DELAYS[delaynum]);
+            break;
+        }
         default:
             assert(false);
         }
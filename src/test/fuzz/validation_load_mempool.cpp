@@ -13,6 +13,7 @@
 #include <test/util/setup_common.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
+#include <uint256.h>
 #include <util/check.h>
 #include <util/time.h>
 #include <util/translation.h>
@@ -56,7 +57,10 @@ FUZZ_TARGET(validation_load_mempool, .init = initialize_validation_load_mempool)
     (void)LoadMempool(pool, MempoolPath(g_setup->m_args), chainstate,
                       {
                           .mockable_fopen_function = fuzzed_fopen,
+                          .use_current_time = fuzzed_data_provider.ConsumeBool(),
+                          .trust_unchanged_tip = fuzzed_data_provider.ConsumeBool(),
                       });
     pool.SetLoadTried(true);
-    (void)DumpMempool(pool, MempoolPath(g_setup->m_args), fuzzed_fopen, true);
+    const uint256 tip_hash{WITH_LOCK(::cs_main, return chainstate.m_chain.Tip()->GetBlockHash())};
+    (void)DumpMempool(pool, MempoolPath(g_setup->m_args), tip_hash, fuzzed_fopen, true);
 }
@@ -537,23 +537,26 @@ BOOST_AUTO_TEST_CASE(MempoolSizeLimitTest)
     AddToMempool(pool, entry.Fee(110LL).FromTx(tx6));
     AddToMempool(pool, entry.Fee(900LL).FromTx(tx7));
 
-    // we only require this to remove, at max, 2 txn, because it's not clear what we're really optimizing for aside from that
+    // tx7 only pays for tx5 and tx6 as a chunk, whose feerate is below tx4's, so the whole
+    // chunk is evicted even though removing a single transaction would have been enough
     pool.TrimToSize(pool.DynamicMemoryUsage() - 1);
     BOOST_CHECK(pool.exists(tx4.GetHash()));
-    BOOST_CHECK(pool.exists(tx6.GetHash()));
+    BOOST_CHECK(!pool.exists(tx5.GetHash()));
+    BOOST_CHECK(!pool.exists(tx6.GetHash()));
     BOOST_CHECK(!pool.exists(tx7.GetHash()));
 
-    if (!pool.exists(tx5.GetHash()))
-        AddToMempool(pool, entry.Fee(100LL).FromTx(tx5));
+    AddToMempool(pool, entry.Fee(100LL).FromTx(tx5));
+    AddToMempool(pool, entry.Fee(110LL).FromTx(tx6));
     AddToMempool(pool, entry.Fee(900LL).FromTx(tx7));
 
-    pool.TrimToSize(pool.DynamicMemoryUsage() / 2); // should maximize mempool size by only removing 5/7
+    pool.TrimToSize(pool.DynamicMemoryUsage() / 2); // the 5/6/7 chunk is still the worst one, so only tx4 is left
     BOOST_CHECK(pool.exists(tx4.GetHash()));
     BOOST_CHECK(!pool.exists(tx5.GetHash()));
-    BOOST_CHECK(pool.exists(tx6.GetHash()));
+    BOOST_CHECK(!pool.exists(tx6.GetHash()));
     BOOST_CHECK(!pool.exists(tx7.GetHash()));
 
     AddToMempool(pool, entry.Fee(100LL).FromTx(tx5));
+    AddToMempool(pool, entry.Fee(110LL).FromTx(tx6));
     AddToMempool(pool, entry.Fee(900LL).FromTx(tx7));
 
     std::vector<CTransactionRef> vtx;
@@ -804,4 +807,112 @@ BOOST_AUTO_TEST_CASE(MempoolAncestryTestsDiamond)
     BOOST_CHECK_EQUAL(descendants, 4ULL);
 }
 
+BOOST_AUTO_TEST_CASE(MempoolClusterLinearizationTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+    BOOST_CHECK(pool.HaveClusterLinearizations());
+
+    // A low-fee parent with a high-fee child forms a single chunk, which beats an unrelated
+    // transaction whose feerate lies between the parent's and the chunk's.
+    CTransactionRef parent = make_tx(/*output_values=*/{10 * COIN});
+    CTransactionRef child = make_tx(/*output_values=*/{9 * COIN}, /*inputs=*/{parent});
+    CTransactionRef other = make_tx(/*output_values=*/{8 * COIN});
+    AddToMempool(pool, entry.Fee(100LL).FromTx(parent));
+    AddToMempool(pool, entry.Fee(10000LL).FromTx(child));
+    AddToMempool(pool, entry.Fee(1000LL).FromTx(other));
+    BOOST_CHECK(pool.HaveClusterLinearizations());
+    {
+        const auto builder{pool.GetBlockBuilder()};
+        const auto first{builder->GetCurrentChunk()};
+        BOOST_REQUIRE(first.has_value());
+        BOOST_REQUIRE_EQUAL(first->first.size(), 2U);
+        BOOST_CHECK(pool.GetIter(*first->first[0])->GetTx().GetHash() == parent->GetHash());
+        BOOST_CHECK(pool.GetIter(*first->first[1])->GetTx().GetHash() == child->GetHash());
+        BOOST_CHECK_EQUAL(first->second.fee, 10100);
+        builder->Include();
+        const auto second{builder->GetCurrentChunk()};
+        BOOST_REQUIRE(second.has_value());
+        BOOST_REQUIRE_EQUAL(second->first.size(), 1U);
+        BOOST_CHECK(pool.GetIter(*second->first[0])->GetTx().GetHash() == other->GetHash());
+        builder->Include();
+        BOOST_CHECK(!builder->GetCurrentChunk().has_value());
+    }
+
+    // Eviction removes the worst chunk.
+    pool.TrimToSize(pool.DynamicMemoryUsage() - 1);
+    BOOST_CHECK(pool.exists(parent->GetHash()));
+    BOOST_CHECK(pool.exists(child->GetHash()));
+    BOOST_CHECK(!pool.exists(other->GetHash()));
+
+    // Prioritisation is reflected in the chunking.
+    pool.PrioritiseTransaction(child->GetHash(), -10000);
+    {
+        const auto builder{pool.GetBlockBuilder()};
+        const auto first{builder->GetCurrentChunk()};
+        BOOST_REQUIRE(first.has_value());
+        BOOST_REQUIRE_EQUAL(first->first.size(), 1U);
+        BOOST_CHECK(pool.GetIter(*first->first[0])->GetTx().GetHash() == parent->GetHash());
+    }
+    pool.PrioritiseTransaction(child->GetHash(), 10000);
+
+    // A cluster with more than MEMPOOL_MAX_CLUSTER_COUNT transactions cannot be linearized.
+    std::vector<CTransactionRef> chain{child};
+    while (chain.size() < MEMPOOL_MAX_CLUSTER_COUNT) {
+        chain.push_back(make_tx(/*output_values=*/{chain.back()->vout[0].nValue - 1000}, /*inputs=*/{chain.back()}));
+        AddToMempool(pool, entry.Fee(2000LL).FromTx(chain.back()));
+    }
+    BOOST_CHECK_EQUAL(pool.size(), MEMPOOL_MAX_CLUSTER_COUNT + 1);
+    BOOST_CHECK(!pool.HaveClusterLinearizations());
+
+    // Trimming first removes enough of the oversized cluster to linearize it again, and the
+    // removed transactions bump the minimum fee above their own feerate.
+    pool.TrimToSize(pool.DynamicMemoryUsage() - 1);
+    BOOST_CHECK(pool.size() <= MEMPOOL_MAX_CLUSTER_COUNT);
+    BOOST_CHECK(pool.HaveClusterLinearizations());
+    CFeeRate trimmed_feerate(2000LL, GetVirtualTransactionSize(*chain.back()));
+    trimmed_feerate += CFeeRate(DEFAULT_INCREMENTAL_RELAY_FEE);
+    BOOST_CHECK(pool.GetMinFee() >= trimmed_feerate);
+}
+
+BOOST_AUTO_TEST_CASE(MempoolProjectedBlocksTest)
+{
+    CTxMemPool& pool = *Assert(m_node.mempool);
+    LOCK2(cs_main, pool.cs);
+    TestMemPoolEntryHelper entry;
+    BOOST_CHECK(pool.GetProjectedBlockFeerates().empty());
+
+    // Transactions of about 99kvB, of which 10 fit in a block, with decreasing feerates.
+    std::vector<CTransactionRef> txs;
+    for (int i = 0; i < 25; ++i) {
+        CMutableTransaction tx;
+        tx.vin.emplace_back(COutPoint{Txid::FromUint256(m_rng.rand256()), 0});
+        tx.vout.emplace_back(0, CScript() << OP_RETURN << std::vector<unsigned char>(99000));
+        txs.push_back(MakeTransactionRef(tx));
+        AddToMempool(pool, entry.Fee(100000LL * (100 - i)).FromTx(txs.back()));
+    }
+    const auto feerate = [&](int i) { return CFeeRate(pool.GetIter(txs[i]->GetHash()).value()->GetModifiedFee(), GetVirtualTransactionSize(*txs[i])); };
+
+    // Only the first two blocks are full.
+    auto projected{pool.GetProjectedBlockFeerates()};
+    BOOST_REQUIRE_EQUAL(projected.size(), 2U);
+    BOOST_CHECK(projected[0] == feerate(9));
+    BOOST_CHECK(projected[1] == feerate(19));
+
+    // Prioritising a transaction into the first block pushes the others back.
+    pool.PrioritiseTransaction(txs[19]->GetHash(), 10 * COIN);
+    projected = pool.GetProjectedBlockFeerates();
+    BOOST_REQUIRE_EQUAL(projected.size(), 2U);
+    BOOST_CHECK(projected[0] == feerate(8));
+    BOOST_CHECK(projected[1] == feerate(18));
+
+    // Removing transactions leaves a single full block.
+    for (int i = 20; i < 25; ++i) pool.removeRecursive(*txs[i], MemPoolRemovalReason::REPLACED);
+    pool.removeRecursive(*txs[0], MemPoolRemovalReason::REPLACED);
+    projected = pool.GetProjectedBlockFeerates();
+    BOOST_REQUIRE_EQUAL(projected.size(), 1U);
+    BOOST_CHECK(projected[0] == feerate(9));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
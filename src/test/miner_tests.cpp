@@ -12,6 +12,7 @@
 #include <node/miner.h>
 #include <policy/policy.h>
 #include <test/util/random.h>
+#include <test/util/time.h>
 #include <test/util/transaction_utils.h>
 #include <test/util/txmempool.h>
 #include <txmempool.h>
@@ -791,4 +792,53 @@ BOOST_AUTO_TEST_CASE(CreateNewBlock_validity)
     TestPrioritisedMining(scriptPubKey, txFirst);
 }
 
+BOOST_AUTO_TEST_CASE(BlockTemplateCache_reuse)
+{
+    node::BlockTemplateCache cache{*m_node.chainman, *m_node.mempool};
+    BlockAssembler::Options options;
+    options.coinbase_output_script = CScript() << OP_TRUE;
+
+    // Neither the tip nor the mempool changed, so the cached template is handed out again.
+    const auto first{cache.Get(options)};
+    BOOST_CHECK(cache.Get(options)->block.vtx[0] == first->block.vtx[0]);
+
+    // Different options require a new template.
+    BlockAssembler::Options other_options{options};
+    other_options.coinbase_output_script = CScript() << OP_2;
+    const auto other{cache.Get(other_options)};
+    BOOST_CHECK(other->block.vtx[0] != first->block.vtx[0]);
+    BOOST_CHECK(other->block.vtx[0]->vout[0].scriptPubKey == other_options.coinbase_output_script);
+    BOOST_CHECK(cache.Get(other_options)->block.vtx[0] == other->block.vtx[0]);
+
+    // Any mempool change makes the cached template stale.
+    const uint64_t assembled{cache.GetAssembledCount()};
+    BOOST_CHECK_EQUAL(cache.WaitForAssembly(assembled, MillisecondsDouble{0}), assembled);
+    m_node.mempool->AddTransactionsUpdated(1);
+    BOOST_CHECK(cache.Get(other_options)->block.vtx[0] != other->block.vtx[0]);
+    BOOST_CHECK_EQUAL(cache.WaitForAssembly(assembled, MillisecondsDouble{0}), assembled + 1);
+}
+
+BOOST_AUTO_TEST_CASE(BlockTemplateCache_expiry)
+{
+    ElapseSteady elapse_time{};
+    node::BlockTemplateCache cache{*m_node.chainman, *m_node.mempool};
+    BlockAssembler::Options options;
+    options.coinbase_output_script = CScript() << OP_TRUE;
+
+    cache.Get(options);
+    const uint64_t assembled{cache.GetAssembledCount()};
+
+    // Requesting the template keeps it cached.
+    elapse_time(node::BlockTemplateCache::TEMPLATE_EXPIRY);
+    cache.Get(options);
+    BOOST_CHECK_EQUAL(cache.GetAssembledCount(), assembled);
+
+    // Once it was not requested for too long, it is dropped and has to be assembled again.
+    elapse_time(node::BlockTemplateCache::TEMPLATE_EXPIRY + 1s);
+    cache.Get(options);
+    BOOST_CHECK_EQUAL(cache.GetAssembledCount(), assembled + 1);
+
+    MockableSteadyClock::ClearMockTime();
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -1546,4 +1546,79 @@ BOOST_AUTO_TEST_CASE(v2transport_test)
     }
 }
 
+BOOST_AUTO_TEST_CASE(recv_buffer_pool_test)
+{
+    // Memory usage of a buffer of 1000 bytes, including the malloc overhead
+    const size_t usage{[] { DataStream buffer; buffer.resize(1000); return buffer.GetMemoryUsage(); }()};
+    RecvBufferPool pool{/*max_pooled_bytes=*/3 * usage};
+
+    // Empty buffers are not retained.
+    pool.Put(DataStream{});
+    BOOST_CHECK_EQUAL(pool.GetPooledBytes(), 0U);
+
+    // Buffers are handed out again, cleared but with their allocation intact.
+    DataStream buffer;
+    buffer.resize(1000);
+    const auto* data{buffer.data()};
+    BOOST_CHECK_EQUAL(buffer.GetMemoryUsage(), usage);
+    pool.Put(std::move(buffer));
+    BOOST_CHECK_EQUAL(pool.GetPooledBytes(), usage);
+    DataStream reused{pool.Get()};
+    BOOST_CHECK(reused.empty());
+    BOOST_CHECK_EQUAL(reused.GetMemoryUsage(), usage);
+    reused.resize(10);
+    BOOST_CHECK(reused.data() == data);
+    BOOST_CHECK_EQUAL(pool.GetPooledBytes(), 0U);
+    BOOST_CHECK(pool.Get().empty());
+
+    // Buffers larger than MAX_BUFFER_SIZE are freed.
+    DataStream large;
+    large.resize(RecvBufferPool::MAX_BUFFER_SIZE + 1);
+    pool.Put(std::move(large));
+    BOOST_CHECK_EQUAL(pool.GetPooledBytes(), 0U);
+
+    // The total memory usage of retained buffers is bounded.
+    for (int i = 0; i < 5; ++i) {
+        DataStream small;
+        small.resize(1000);
+        pool.Put(std::move(small));
+    }
+    BOOST_CHECK_EQUAL(pool.GetPooledBytes(), 3 * usage);
+}
+
+BOOST_AUTO_TEST_CASE(v1transport_recv_buffer_reuse)
+{
+    RecvBufferPool pool{/*max_pooled_bytes=*/1'000'000};
+    V1Transport sender{/*node_id=*/0};
+    V1Transport receiver{/*node_id=*/0, &pool};
+
+    auto transfer = [&](std::vector<unsigned char> payload) {
+        CSerializedNetMsg msg{NetMsg::Make("tx", std::span{payload})};
+        BOOST_REQUIRE(sender.SetMessageToSend(msg));
+        while (true) {
+            const auto& [bytes, more, msg_type] = sender.GetBytesToSend(/*have_next_message=*/false);
+            if (bytes.empty()) break;
+            std::span<const uint8_t> to_recv{bytes};
+            while (!to_recv.empty()) BOOST_REQUIRE(receiver.ReceivedBytes(to_recv));
+            sender.MarkBytesSent(bytes.size());
+        }
+        BOOST_REQUIRE(receiver.ReceivedMessageComplete());
+        bool reject{false};
+        CNetMessage recv_msg{receiver.GetReceivedMessage(/*time=*/{}, reject)};
+        BOOST_CHECK(!reject);
+        BOOST_CHECK(std::ranges::equal(recv_msg.m_recv, MakeByteSpan(payload)));
+        return recv_msg;
+    };
+
+    CNetMessage msg1{transfer(std::vector<unsigned char>(500, 1))};
+    const auto* data1{msg1.m_recv.data()};
+    pool.Put(std::move(msg1.m_recv));
+    // The transport took its buffer for the next message before the first one was handed back.
+    CNetMessage msg2{transfer(std::vector<unsigned char>(400, 2))};
+    BOOST_CHECK(msg2.m_recv.data() != data1);
+    // The buffer of the first message is reused for the third one.
+    CNetMessage msg3{transfer(std::vector<unsigned char>(300, 3))};
+    BOOST_CHECK(msg3.m_recv.data() == data1);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
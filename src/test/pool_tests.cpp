@@ -116,6 +116,25 @@ BOOST_AUTO_TEST_CASE(allocate_any_byte)
     PoolResourceTester::CheckAllDataAccountedFor(resource);
 }
 
+BOOST_AUTO_TEST_CASE(used_bytes)
+{
+    auto resource = PoolResource<16, 8>();
+    BOOST_TEST(0U == resource.UsedBytes());
+
+    // pooled blocks are rounded up to the alignment, others are counted as requested
+    void* a = resource.Allocate(5, 1);
+    BOOST_TEST(8U == resource.UsedBytes());
+    void* b = resource.Allocate(100, 8);
+    BOOST_TEST(108U == resource.UsedBytes());
+
+    // the count drops again even though the pooled block is kept in a freelist
+    resource.Deallocate(a, 5, 1);
+    BOOST_TEST(100U == resource.UsedBytes());
+    resource.Deallocate(b, 100, 8);
+    BOOST_TEST(0U == resource.UsedBytes());
+    PoolResourceTester::CheckAllDataAccountedFor(resource);
+}
+
 BOOST_AUTO_TEST_CASE(random_allocations)
 {
     struct PtrSizeAlignment {
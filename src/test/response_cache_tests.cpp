@@ -0,0 +1,95 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <chain.h>
+#include <consensus/validation.h>
+#include <node/response_cache.h>
+#include <sync.h>
+#include <test/util/setup_common.h>
+#include <univalue.h>
+#include <validation.h>
+#include <validationinterface.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <string>
+#include <variant>
+
+using node::ResponseCache;
+
+BOOST_FIXTURE_TEST_SUITE(response_cache_tests, TestChain100Setup)
+
+static bool IsCached(ResponseCache& cache, const CChain& chain, const std::string& key)
+{
+    LOCK(cs_main);
+    return cache.Get(chain, key) != nullptr;
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_lru)
+{
+    const CChain& chain{*WITH_LOCK(cs_main, return &m_node.chainman->ActiveChain())};
+    const CBlockIndex& block{*WITH_LOCK(cs_main, return chain[50])};
+    ResponseCache cache{10000};
+
+    // Both kinds of responses are returned as they were cached
+    UniValue json(UniValue::VOBJ);
+    json.pushKV("hash", block.GetBlockHash().GetHex());
+    cache.Put(block, "json", json);
+    cache.Put(block, "bytes", std::string("\x00\x01", 2));
+    {
+        LOCK(cs_main);
+        BOOST_CHECK_EQUAL(std::get<UniValue>(*cache.Get(chain, "json")).write(), json.write());
+        BOOST_CHECK_EQUAL(std::get<std::string>(*cache.Get(chain, "bytes")), std::string("\x00\x01", 2));
+        BOOST_CHECK(!cache.Get(chain, "missing"));
+    }
+
+    // Responses larger than a quarter of the cache are not cached
+    cache.Put(block, "large", std::string(3000, 'x'));
+    BOOST_CHECK(!IsCached(cache, chain, "large"));
+
+    // Once full, the least recently used responses are evicted
+    for (int i{0}; i < 4; ++i) {
+        cache.Put(block, "r" + std::to_string(i), std::string(2000, 'x'));
+    }
+    BOOST_CHECK(IsCached(cache, chain, "json"));
+    cache.Put(block, "r4", std::string(2000, 'x'));
+    BOOST_CHECK(IsCached(cache, chain, "json"));
+    BOOST_CHECK(!IsCached(cache, chain, "bytes"));
+    BOOST_CHECK(!IsCached(cache, chain, "r0"));
+    BOOST_CHECK(IsCached(cache, chain, "r1"));
+    BOOST_CHECK(IsCached(cache, chain, "r4"));
+    BOOST_CHECK_LE(cache.GetSize(), 10000U);
+
+    // Replacing a response does not count it twice
+    const size_t size{cache.GetSize()};
+    cache.Put(block, "r4", std::string(2000, 'x'));
+    BOOST_CHECK_EQUAL(cache.GetSize(), size);
+}
+
+BOOST_AUTO_TEST_CASE(response_cache_reorg)
+{
+    const CChain& chain{*WITH_LOCK(cs_main, return &m_node.chainman->ActiveChain())};
+    const CBlockIndex& buried{*WITH_LOCK(cs_main, return chain[80])};
+    const CBlockIndex& recent{*WITH_LOCK(cs_main, return chain[95])};
+    ResponseCache cache{1 << 20};
+    m_node.validation_signals->RegisterValidationInterface(&cache);
+
+    cache.Put(buried, "buried", std::string(100, 'x'));
+    const size_t buried_size{cache.GetSize()};
+    cache.Put(recent, "recent", std::string(100, 'x'));
+    BOOST_CHECK(IsCached(cache, chain, "recent"));
+
+    // Disconnecting a block drops the responses depending on it, and no longer
+    // returns them even before the notification is processed
+    BlockValidationState state;
+    BOOST_CHECK(m_node.chainman->ActiveChainstate().InvalidateBlock(state, WITH_LOCK(cs_main, return chain[90])));
+    BOOST_CHECK(!IsCached(cache, chain, "recent"));
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+    BOOST_CHECK(IsCached(cache, chain, "buried"));
+    BOOST_CHECK_EQUAL(cache.GetSize(), buried_size);
+
+    m_node.validation_signals->UnregisterValidationInterface(&cache);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -2,6 +2,7 @@
 // Distributed under the MIT software license, see the accompanying
 // file COPYING or http://www.opensource.org/licenses/mit-license.php.
 
+#include <coins.h>
 #include <core_io.h>
 #include <interfaces/chain.h>
 #include <node/context.h>
@@ -10,10 +11,18 @@
 #include <rpc/server.h>
 #include <rpc/util.h>
 #include <test/util/setup_common.h>
+#include <txdb.h>
 #include <univalue.h>
 #include <util/time.h>
 
+#include <algorithm>
 #include <any>
+#include <atomic>
+#include <functional>
+#include <map>
+#include <memory>
+#include <set>
+#include <vector>
 
 #include <boost/test/unit_test.hpp>
 
@@ -168,6 +177,18 @@ BOOST_AUTO_TEST_CASE(rpc_rawparams)
     BOOST_CHECK_THROW(CallRPC(std::string("sendrawtransaction ")+rawtx+" extra"), std::runtime_error);
 }
 
+BOOST_AUTO_TEST_CASE(rpc_parallel_safe)
+{
+    // Read-only methods declare themselves parallel safe where they are defined.
+    BOOST_CHECK(IsRPCParallelSafe("getblockcount"));
+    BOOST_CHECK(IsRPCParallelSafe("getrawmempool"));
+    BOOST_CHECK(IsRPCParallelSafe("decoderawtransaction"));
+    // Methods changing node state do not, and neither do unknown ones.
+    BOOST_CHECK(!IsRPCParallelSafe("sendrawtransaction"));
+    BOOST_CHECK(!IsRPCParallelSafe("setnetworkactive"));
+    BOOST_CHECK(!IsRPCParallelSafe("nosuchmethod"));
+}
+
 BOOST_AUTO_TEST_CASE(rpc_togglenetwork)
 {
     UniValue r;
@@ -503,6 +524,66 @@ BOOST_AUTO_TEST_CASE(rpc_getblockstats_calculate_percentiles_by_weight)
     }
 }
 
+BOOST_AUTO_TEST_CASE(rpc_scantxoutset_ranges)
+{
+    CCoinsViewDB db{{.path = "test", .cache_bytes = 1 << 20, .memory_only = true}, {}};
+    const CScript needle{CScript() << OP_TRUE};
+    const CScript other{CScript() << OP_FALSE};
+    const std::vector<size_t> splits{2, 3, 7, 16};
+
+    // Put coins at the first and last txid of every range of the splits, and random ones in between
+    std::set<uint256> txids;
+    for (size_t n_ranges : splits) {
+        for (size_t i{1}; i < n_ranges; ++i) {
+            const uint256 start{ScanRangeStart(i, n_ranges).hash.ToUint256()};
+            txids.insert(start);
+            uint256 before;
+            std::fill(before.begin(), before.end(), 0xff);
+            const uint32_t position{0x100U * start.data()[0] + start.data()[1] - 1};
+            before.data()[0] = position >> 8;
+            before.data()[1] = position & 0xff;
+            txids.insert(before);
+        }
+    }
+    txids.insert(uint256::ZERO);
+    uint256 last;
+    std::fill(last.begin(), last.end(), 0xff);
+    txids.insert(last);
+    while (txids.size() < 500) txids.insert(m_rng.rand256());
+
+    std::map<COutPoint, CTxOut> expected;
+    {
+        CCoinsViewCache cache{&db};
+        bool match{false};
+        for (const uint256& txid : txids) {
+            const COutPoint outpoint{Txid::FromUint256(txid), 0};
+            match = !match;
+            CTxOut out{1000, match ? needle : other};
+            if (match) expected.emplace(outpoint, out);
+            cache.AddCoin(outpoint, Coin{std::move(out), 1, false}, /*possible_overwrite=*/false);
+        }
+        cache.SetBestBlock(uint256::ONE);
+        BOOST_REQUIRE(cache.Flush());
+    }
+
+    // Splitting the scan into ranges finds the same coins as a single cursor
+    for (size_t n_ranges : std::vector<size_t>{1, 2, 3, 7, 16}) {
+        std::vector<std::unique_ptr<CCoinsViewCursor>> cursors;
+        for (size_t i{0}; i < n_ranges; ++i) cursors.push_back(db.Cursor(ScanRangeStart(i, n_ranges)));
+        std::atomic<int> progress{0};
+        const std::atomic<bool> should_abort{false};
+        int64_t count{0};
+        std::map<COutPoint, Coin> found;
+        std::function<void()> interruption_point{[] {}};
+        BOOST_CHECK(FindScriptPubKey(progress, should_abort, count, cursors, {needle}, found, interruption_point));
+        BOOST_CHECK_EQUAL(count, int64_t(txids.size()));
+        BOOST_CHECK_EQUAL(progress, 100);
+        BOOST_CHECK(std::ranges::equal(found, expected, [](const auto& a, const auto& b) {
+            return a.first == b.first && a.second.out == b.second;
+        }));
+    }
+}
+
 // Make sure errors are triggered appropriately if parameters have the same names.
 BOOST_AUTO_TEST_CASE(check_dup_param_names)
 {
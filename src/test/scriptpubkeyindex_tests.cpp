@@ -0,0 +1,135 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or http://www.opensource.org/licenses/mit-license.php.
+
+#include <addresstype.h>
+#include <chainparams.h>
+#include <coins.h>
+#include <consensus/validation.h>
+#include <index/scriptpubkeyindex.h>
+#include <interfaces/chain.h>
+#include <script/script.h>
+#include <test/util/setup_common.h>
+#include <test/util/validation.h>
+#include <validation.h>
+
+#include <boost/test/unit_test.hpp>
+
+#include <map>
+#include <memory>
+
+BOOST_AUTO_TEST_SUITE(scriptpubkeyindex_tests)
+
+BOOST_FIXTURE_TEST_CASE(scriptpubkeyindex_initial_sync, TestChain100Setup)
+{
+    ScriptPubKeyIndex index{interfaces::MakeChain(m_node), 1 << 20, true};
+    BOOST_REQUIRE(index.Init());
+
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const CScript other_script{GetScriptForDestination(WitnessV0KeyHash{coinbaseKey.GetPubKey()})};
+    const COutPoint spent_coinbase{m_coinbase_txns[0]->GetHash(), 0};
+    std::map<COutPoint, Coin> outputs;
+    interfaces::BlockRef best_block;
+
+    // Nothing can be looked up before the index is synced
+    BOOST_CHECK(!index.FindUnspentOutputs({coinbase_script}, outputs, best_block));
+
+    index.Sync();
+
+    // All coinbase outputs pay to coinbase_script, the witness commitments are unspendable
+    BOOST_CHECK(index.FindUnspentOutputs({coinbase_script}, outputs, best_block));
+    BOOST_CHECK_EQUAL(outputs.size(), 100U);
+    BOOST_CHECK_EQUAL(best_block.height, 100);
+    BOOST_CHECK(outputs.contains(spent_coinbase));
+    BOOST_CHECK_EQUAL(outputs.at(spent_coinbase).nHeight, 1U);
+    BOOST_CHECK(outputs.at(spent_coinbase).IsCoinBase());
+
+    // Spent outputs are removed and new ones added
+    const CMutableTransaction tx{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey, other_script, 1 * COIN, /*submit=*/false)};
+    const CBlock block{CreateAndProcessBlock({tx}, coinbase_script)};
+    BOOST_CHECK(index.BlockUntilSyncedToCurrentChain());
+    outputs.clear();
+    BOOST_CHECK(index.FindUnspentOutputs({coinbase_script, other_script}, outputs, best_block));
+    BOOST_CHECK_EQUAL(outputs.size(), 101U);
+    BOOST_CHECK_EQUAL(best_block.height, 101);
+    BOOST_CHECK(best_block.hash == block.GetHash());
+    BOOST_CHECK(!outputs.contains(spent_coinbase));
+    BOOST_CHECK(outputs.contains(COutPoint{tx.GetHash(), 0}));
+
+    // A reorg restores the outputs spent by the disconnected block
+    BlockValidationState state;
+    BOOST_CHECK(m_node.chainman->ActiveChainstate().InvalidateBlock(state, WITH_LOCK(cs_main, return m_node.chainman->ActiveChain().Tip())));
+    CreateAndProcessBlock({}, other_script);
+    BOOST_CHECK(index.BlockUntilSyncedToCurrentChain());
+    outputs.clear();
+    BOOST_CHECK(index.FindUnspentOutputs({coinbase_script, other_script}, outputs, best_block));
+    BOOST_CHECK_EQUAL(outputs.size(), 101U);
+    BOOST_CHECK_EQUAL(best_block.height, 101);
+    BOOST_CHECK(outputs.contains(spent_coinbase));
+    BOOST_CHECK(!outputs.contains(COutPoint{tx.GetHash(), 0}));
+
+    // It is not safe to stop and destroy the index until it finishes handling
+    // the last BlockConnected notification, see coinstatsindex_tests.
+    m_node.validation_signals->SyncWithValidationInterfaceQueue();
+
+    // Shutdown sequence (c.f. Shutdown() in init.cpp)
+    index.Stop();
+}
+
+BOOST_FIXTURE_TEST_CASE(scriptpubkeyindex_unclean_shutdown_reorg, TestChain100Setup)
+{
+    Chainstate& chainstate = Assert(m_node.chainman)->ActiveChainstate();
+    const CScript coinbase_script{CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG};
+    const CScript other_script{GetScriptForDestination(WitnessV0KeyHash{coinbaseKey.GetPubKey()})};
+    const COutPoint spent_coinbase{m_coinbase_txns[0]->GetHash(), 0};
+    const CMutableTransaction tx{CreateValidMempoolTransaction(m_coinbase_txns[0], 0, 1, coinbaseKey, other_script, 1 * COIN, /*submit=*/false)};
+    CBlockIndex* stale_block_index{nullptr};
+    {
+        ScriptPubKeyIndex index{interfaces::MakeChain(m_node), 1 << 20};
+        BOOST_REQUIRE(index.Init());
+        index.Sync();
+
+        // Let the index write a block spending a coinbase output, but stop it before the block
+        // is committed and without the block ever becoming part of the active chain.
+        const auto block{std::make_shared<const CBlock>(CreateBlock({tx}, coinbase_script, chainstate))};
+        {
+            LOCK(cs_main);
+            BlockValidationState state;
+            BOOST_CHECK(CheckBlock(*block, state, Params().GetConsensus()));
+            BOOST_CHECK(m_node.chainman->AcceptBlock(block, state, &stale_block_index, true, nullptr, nullptr, true));
+            CCoinsViewCache view(&chainstate.CoinsTip());
+            BOOST_CHECK(chainstate.ConnectBlock(*block, state, stale_block_index, view));
+        }
+        ValidationInterfaceTest::BlockConnected(ChainstateRole::NORMAL, index, block, stale_block_index);
+        std::map<COutPoint, Coin> outputs;
+        interfaces::BlockRef best_block;
+        BOOST_CHECK(index.FindUnspentOutputs({coinbase_script, other_script}, outputs, best_block));
+        BOOST_CHECK_EQUAL(best_block.height, 101);
+        BOOST_CHECK(!outputs.contains(spent_coinbase));
+        BOOST_CHECK(outputs.contains(COutPoint{tx.GetHash(), 0}));
+        index.Stop();
+    }
+
+    // The chain moves on without that block while the index is down
+    BlockValidationState state;
+    BOOST_CHECK(chainstate.InvalidateBlock(state, stale_block_index));
+    CreateAndProcessBlock({}, coinbase_script);
+    CreateAndProcessBlock({}, coinbase_script);
+
+    {
+        // On restart, the index rolls back the block written after its committed best block
+        ScriptPubKeyIndex index{interfaces::MakeChain(m_node), 1 << 20};
+        BOOST_REQUIRE(index.Init());
+        index.Sync();
+        std::map<COutPoint, Coin> outputs;
+        interfaces::BlockRef best_block;
+        BOOST_CHECK(index.FindUnspentOutputs({coinbase_script, other_script}, outputs, best_block));
+        BOOST_CHECK_EQUAL(best_block.height, 102);
+        BOOST_CHECK_EQUAL(outputs.size(), 102U);
+        BOOST_CHECK(outputs.contains(spent_coinbase));
+        BOOST_CHECK(!outputs.contains(COutPoint{tx.GetHash(), 0}));
+        index.Stop();
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
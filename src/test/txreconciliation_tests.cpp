@@ -8,6 +8,9 @@
 
 #include <boost/test/unit_test.hpp>
 
+#include <set>
+#include <vector>
+
 BOOST_FIXTURE_TEST_SUITE(txreconciliation_tests, BasicTestingSetup)
 
 BOOST_AUTO_TEST_CASE(RegisterPeerTest)
@@ -81,4 +84,161 @@ BOOST_AUTO_TEST_CASE(IsPeerRegisteredTest)
     BOOST_CHECK(!tracker.IsPeerRegistered(peer_id0));
 }
 
+/** Register peer 0 in both trackers, with initiator reconciling with responder over an outbound connection. */
+static void RegisterPair(TxReconciliationTracker& initiator, TxReconciliationTracker& responder)
+{
+    const uint64_t initiator_salt{initiator.PreRegisterPeer(0)};
+    const uint64_t responder_salt{responder.PreRegisterPeer(0)};
+    BOOST_REQUIRE_EQUAL(initiator.RegisterPeer(0, /*is_peer_inbound=*/false, 1, responder_salt), ReconciliationRegisterResult::SUCCESS);
+    BOOST_REQUIRE_EQUAL(responder.RegisterPeer(0, /*is_peer_inbound=*/true, 1, initiator_salt), ReconciliationRegisterResult::SUCCESS);
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationSetTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Unregistered peers have no set.
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+    tracker.PreRegisterPeer(0);
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(0, true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_CHECK(tracker.AddToSet(0, wtxid));
+    BOOST_CHECK(tracker.TryRemovingFromSet(0, wtxid));
+    BOOST_CHECK(!tracker.TryRemovingFromSet(0, wtxid));
+
+    // The set is bounded.
+    for (size_t i = 0; i < MAX_RECONSET_SIZE; ++i) {
+        BOOST_CHECK(tracker.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+    BOOST_CHECK(!tracker.AddToSet(0, wtxid));
+}
+
+BOOST_AUTO_TEST_CASE(FanoutTest)
+{
+    TxReconciliationTracker tracker(TXRECONCILIATION_VERSION);
+    const Wtxid wtxid{Wtxid::FromUint256(m_rng.rand256())};
+
+    // Unregistered and inbound peers are never flooded to.
+    BOOST_CHECK(!tracker.IsFanoutTarget(0, wtxid));
+    tracker.PreRegisterPeer(0);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(0, /*is_peer_inbound=*/true, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_CHECK(!tracker.IsFanoutTarget(0, wtxid));
+
+    // A single outbound peer always gets the transaction flooded to it.
+    tracker.PreRegisterPeer(1);
+    BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(1, /*is_peer_inbound=*/false, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    BOOST_CHECK(tracker.IsFanoutTarget(1, wtxid));
+
+    // With more outbound peers, each transaction is flooded to exactly OUTBOUND_FANOUT_DESTINATIONS of them.
+    for (NodeId peer_id = 2; peer_id < 8; ++peer_id) {
+        tracker.PreRegisterPeer(peer_id);
+        BOOST_REQUIRE_EQUAL(tracker.RegisterPeer(peer_id, /*is_peer_inbound=*/false, 1, 1), ReconciliationRegisterResult::SUCCESS);
+    }
+    for (int i = 0; i < 10; ++i) {
+        const Wtxid tx{Wtxid::FromUint256(m_rng.rand256())};
+        size_t targets{0};
+        for (NodeId peer_id = 0; peer_id < 8; ++peer_id) {
+            if (tracker.IsFanoutTarget(peer_id, tx)) ++targets;
+        }
+        BOOST_CHECK_EQUAL(targets, OUTBOUND_FANOUT_DESTINATIONS);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationRoundTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION);
+    TxReconciliationTracker responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+
+    // Only the initiator requests reconciliations, at most once per interval.
+    const std::chrono::microseconds now{1'000'000'000};
+    BOOST_CHECK(!responder.InitiateReconciliationRequest(0, now));
+    const auto request{initiator.InitiateReconciliationRequest(0, now)};
+    BOOST_REQUIRE(request);
+    BOOST_CHECK(!initiator.InitiateReconciliationRequest(0, now + RECON_REQUEST_INTERVAL));
+
+    // Messages out of turn are protocol violations.
+    BOOST_CHECK(!initiator.HandleReconciliationRequest(0, 0, 0));
+    BOOST_CHECK(!responder.HandleSketch(0, {}));
+    BOOST_CHECK(!responder.HandleReconciliationDifference(0, true, {}));
+
+    // An empty responder set results in an empty sketch, after which we announce everything.
+    const Wtxid initiator_tx{Wtxid::FromUint256(m_rng.rand256())};
+    BOOST_CHECK(initiator.AddToSet(0, initiator_tx));
+    const auto empty_sketch{responder.HandleReconciliationRequest(0, request->first, request->second)};
+    BOOST_REQUIRE(empty_sketch);
+    BOOST_CHECK(empty_sketch->empty());
+    const auto empty_outcome{initiator.HandleSketch(0, *empty_sketch)};
+    BOOST_REQUIRE(empty_outcome);
+    BOOST_CHECK(empty_outcome->success);
+    BOOST_CHECK(empty_outcome->ask_shortids.empty());
+    BOOST_CHECK(empty_outcome->announce == std::vector<Wtxid>{initiator_tx});
+    BOOST_CHECK(responder.HandleReconciliationDifference(0, true, {})->empty());
+
+    // Each side has some transactions of its own and shares many with the other side.
+    std::set<Wtxid> initiator_only, responder_only;
+    for (int i = 0; i < 200; ++i) {
+        const Wtxid shared{Wtxid::FromUint256(m_rng.rand256())};
+        BOOST_CHECK(initiator.AddToSet(0, shared));
+        BOOST_CHECK(responder.AddToSet(0, shared));
+    }
+    for (int i = 0; i < 5; ++i) {
+        initiator_only.insert(Wtxid::FromUint256(m_rng.rand256()));
+        responder_only.insert(Wtxid::FromUint256(m_rng.rand256()));
+    }
+    for (const auto& wtxid : initiator_only) BOOST_CHECK(initiator.AddToSet(0, wtxid));
+    for (const auto& wtxid : responder_only) BOOST_CHECK(responder.AddToSet(0, wtxid));
+
+    const auto request2{initiator.InitiateReconciliationRequest(0, now + RECON_REQUEST_INTERVAL)};
+    BOOST_REQUIRE(request2);
+    BOOST_CHECK_EQUAL(request2->first, 205);
+    const auto sketch{responder.HandleReconciliationRequest(0, request2->first, request2->second)};
+    BOOST_REQUIRE(sketch);
+    BOOST_CHECK_GT(sketch->size(), 0U);
+    BOOST_CHECK_EQUAL(sketch->size() % BYTES_PER_SKETCH_CAPACITY, 0U);
+
+    const auto outcome{initiator.HandleSketch(0, *sketch)};
+    BOOST_REQUIRE(outcome);
+    BOOST_CHECK(outcome->success);
+    BOOST_CHECK(std::set<Wtxid>(outcome->announce.begin(), outcome->announce.end()) == initiator_only);
+    BOOST_CHECK_EQUAL(outcome->ask_shortids.size(), responder_only.size());
+
+    const auto responder_announce{responder.HandleReconciliationDifference(0, outcome->success, outcome->ask_shortids)};
+    BOOST_REQUIRE(responder_announce);
+    BOOST_CHECK(std::set<Wtxid>(responder_announce->begin(), responder_announce->end()) == responder_only);
+
+    // A malformed sketch is a protocol violation.
+    BOOST_REQUIRE(initiator.InitiateReconciliationRequest(0, now + 2 * RECON_REQUEST_INTERVAL));
+    BOOST_CHECK(!initiator.HandleSketch(0, std::vector<uint8_t>(BYTES_PER_SKETCH_CAPACITY + 1)));
+}
+
+BOOST_AUTO_TEST_CASE(ReconciliationFailureTest)
+{
+    TxReconciliationTracker initiator(TXRECONCILIATION_VERSION);
+    TxReconciliationTracker responder(TXRECONCILIATION_VERSION);
+    RegisterPair(initiator, responder);
+
+    // The initiator claims an empty set but has many transactions by the time the sketch
+    // arrives, so the difference exceeds the sketch capacity.
+    const auto request{initiator.InitiateReconciliationRequest(0, std::chrono::microseconds{1})};
+    BOOST_REQUIRE(request);
+    BOOST_CHECK(responder.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    for (int i = 0; i < 100; ++i) {
+        BOOST_CHECK(initiator.AddToSet(0, Wtxid::FromUint256(m_rng.rand256())));
+    }
+    const auto sketch{responder.HandleReconciliationRequest(0, request->first, request->second)};
+    BOOST_REQUIRE(sketch);
+    const auto outcome{initiator.HandleSketch(0, *sketch)};
+    BOOST_REQUIRE(outcome);
+    BOOST_CHECK(!outcome->success);
+    BOOST_CHECK_EQUAL(outcome->announce.size(), 100U);
+
+    // On failure, the responder announces its whole set.
+    const auto responder_announce{responder.HandleReconciliationDifference(0, outcome->success, outcome->ask_shortids)};
+    BOOST_REQUIRE(responder_announce);
+    BOOST_CHECK_EQUAL(responder_announce->size(), 1U);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
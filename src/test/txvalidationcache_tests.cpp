@@ -109,6 +109,47 @@ BOOST_FIXTURE_TEST_CASE(tx_mempool_block_doublespend, Dersig100Setup)
     BOOST_CHECK_EQUAL(m_node.mempool->size(), 0U);
 }
 
+BOOST_FIXTURE_TEST_CASE(tx_mempool_parallel_script_checks, TestChain100Setup)
+{
+    // Transactions with many inputs have their scripts verified on the script check
+    // threads. Make sure acceptance and the rejection reason are unaffected by that.
+    static_assert(MIN_PARALLEL_MEMPOOL_SCRIPT_CHECKS <= 32);
+    constexpr int num_inputs{32};
+    const CScript scriptPubKey = CScript() << ToByteVector(coinbaseKey.GetPubKey()) << OP_CHECKSIG;
+    const auto sign = [&](CMutableTransaction& tx, unsigned int input) {
+        std::vector<unsigned char> vchSig;
+        const uint256 hash = SignatureHash(scriptPubKey, tx, input, SIGHASH_ALL, 0, SigVersion::BASE);
+        BOOST_CHECK(coinbaseKey.Sign(hash, vchSig));
+        vchSig.push_back((unsigned char)SIGHASH_ALL);
+        tx.vin[input].scriptSig = CScript() << vchSig;
+    };
+
+    CMutableTransaction funding;
+    funding.vin.emplace_back(COutPoint{m_coinbase_txns[0]->GetHash(), 0});
+    for (int i = 0; i < num_inputs; ++i) funding.vout.emplace_back(1 * CENT, scriptPubKey);
+    sign(funding, 0);
+    CreateAndProcessBlock({funding}, scriptPubKey);
+
+    CMutableTransaction spend;
+    for (int i = 0; i < num_inputs; ++i) spend.vin.emplace_back(COutPoint{funding.GetHash(), uint32_t(i)});
+    spend.vout.emplace_back(num_inputs * CENT - 10000, scriptPubKey);
+    for (int i = 0; i < num_inputs; ++i) sign(spend, i);
+
+    // Reuse the first input's signature for the last input, which makes it invalid.
+    CMutableTransaction bad_spend{spend};
+    bad_spend.vin.back().scriptSig = spend.vin.front().scriptSig;
+
+    LOCK(cs_main);
+    const auto bad_result{m_node.chainman->ProcessTransaction(MakeTransactionRef(bad_spend))};
+    BOOST_CHECK(bad_result.m_result_type == MempoolAcceptResult::ResultType::INVALID);
+    BOOST_CHECK(bad_result.m_state.GetResult() == TxValidationResult::TX_NOT_STANDARD);
+    BOOST_CHECK_EQUAL(bad_result.m_state.GetRejectReason(), "mempool-script-verify-flag-failed (Signature must be zero for failed CHECK(MULTI)SIG operation)");
+
+    const auto result{m_node.chainman->ProcessTransaction(MakeTransactionRef(spend))};
+    BOOST_CHECK(result.m_result_type == MempoolAcceptResult::ResultType::VALID);
+    BOOST_CHECK_EQUAL(m_node.mempool->size(), 1U);
+}
+
 // Run CheckInputScripts (using CoinsTip()) on the given transaction, for all script
 // flags.  Test that CheckInputScripts passes for all flags that don't overlap with
 // the failing_flags argument, but otherwise fails.
@@ -183,13 +183,18 @@ private:
 };
 
 std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor() const
+{
+    return Cursor(COutPoint{Txid{}, 0});
+}
+
+std::unique_ptr<CCoinsViewCursor> CCoinsViewDB::Cursor(const COutPoint& start) const
 {
     auto i = std::make_unique<CCoinsViewDBCursor>(
         const_cast<CDBWrapper&>(*m_db).NewIterator(), GetBestBlock());
     /* It seems that there are no "const iterators" for LevelDB.  Since we
        only need read operations on it, use a const-cast to get around
        that restriction.  */
-    i->pcursor->Seek(DB_COIN);
+    i->pcursor->Seek(CoinEntry(&start));
     // Cache key of first record
     if (i->pcursor->Valid()) {
         CoinEntry entry(&i->keyTmp.second);
@@ -49,6 +49,8 @@ public:
     std::vector<uint256> GetHeadBlocks() const override;
     bool BatchWrite(CoinsViewCacheCursor& cursor, const uint256 &hashBlock) override;
     std::unique_ptr<CCoinsViewCursor> Cursor() const override;
+    //! Cursor starting at the first coin at or after start, for reading part of the coins
+    std::unique_ptr<CCoinsViewCursor> Cursor(const COutPoint& start) const;
 
     //! Whether an unsupported database format is used.
     bool NeedsUpgrade();
@@ -5,6 +5,7 @@
 #include <txgraph.h>
 
 #include <cluster_linearize.h>
+#include <memusage.h>
 #include <random.h>
 #include <util/bitset.h>
 #include <util/check.h>
@@ -617,6 +618,7 @@ public:
 
     std::unique_ptr<BlockBuilder> GetBlockBuilder() noexcept final;
     std::pair<std::vector<Ref*>, FeePerWeight> GetWorstMainChunk() noexcept final;
+    size_t GetMainMemoryUsage() noexcept final;
 
     void SanityCheck() const final;
 };
@@ -2657,6 +2659,21 @@ std::pair<std::vector<TxGraph::Ref*>, FeePerWeight> TxGraphImpl::GetWorstMainChu
     return ret;
 }
 
+size_t TxGraphImpl::GetMainMemoryUsage() noexcept
+{
+    ApplyRemovals(0);
+    // Every transaction in a Cluster takes a DepGraph entry, a mapping entry and a linearization
+    // entry. Those vectors are allocated per Cluster, but adding them up would take time linear in
+    // the number of clusters, so they are approximated from the transaction count instead.
+    static constexpr size_t CLUSTER_BYTES_PER_TX{sizeof(FeeFrac) + 2 * sizeof(Cluster::SetType) + sizeof(GraphIndex) + sizeof(DepGraphIndex)};
+    size_t cluster_count{0};
+    for (const auto& clusters : m_main_clusterset.m_clusters) cluster_count += clusters.size();
+    return memusage::DynamicUsage(m_entries) +
+           memusage::DynamicUsage(m_main_chunkindex) +
+           cluster_count * (memusage::MallocUsage(sizeof(Cluster)) + sizeof(std::unique_ptr<Cluster>)) +
+           m_main_clusterset.m_txcount * CLUSTER_BYTES_PER_TX;
+}
+
 std::vector<TxGraph::Ref*> TxGraphImpl::Trim() noexcept
 {
     int level = GetTopLevel();
@@ -203,6 +203,10 @@ public:
      *  reverse-topological order, so every element is preceded by all its descendants. The main
      *  graph must not be oversized. If the graph is empty, {{}, FeePerWeight{}} is returned. */
     virtual std::pair<std::vector<Ref*>, FeePerWeight> GetWorstMainChunk() noexcept = 0;
+    /** Get the approximate dynamic memory usage of the main graph, including its clusters and
+     *  chunk index. Pending removals are applied first, so that removed transactions are no
+     *  longer counted. This is cheap to call, and available even for oversized graphs. */
+    virtual size_t GetMainMemoryUsage() noexcept = 0;
 
     /** Perform an internal consistency check on this object. */
     virtual void SanityCheck() const = 0;
@@ -28,6 +28,7 @@
 
 #include <algorithm>
 #include <cmath>
+#include <limits>
 #include <numeric>
 #include <optional>
 #include <ranges>
@@ -158,6 +159,16 @@ void CTxMemPool::UpdateTransactionsFromBlock(const std::vector<Txid>& vHashesToU
             removeRecursive((*txiter)->GetTx(), MemPoolRemovalReason::SIZELIMIT);
         }
     }
+
+    // The transactions of the disconnected blocks may have merged clusters beyond the cluster
+    // limits. Remove enough transactions, along with their descendants, to bring them back within.
+    if (!HaveClusterLinearizations()) {
+        setEntries stage;
+        for (const TxGraph::Ref* ref : m_txgraph->Trim()) {
+            stage.insert(GetIter(*ref));
+        }
+        RemoveStaged(stage, false, MemPoolRemovalReason::SIZELIMIT);
+    }
 }
 
 util::Result<CTxMemPool::setEntries> CTxMemPool::CalculateAncestorsAndCheckLimits(
@@ -412,7 +423,8 @@ static CTxMemPool::Options&& Flatten(CTxMemPool::Options&& opts, bilingual_str&
 }
 
 CTxMemPool::CTxMemPool(Options opts, bilingual_str& error)
-    : m_opts{Flatten(std::move(opts), error)}
+    : m_txgraph{MakeTxGraph(MEMPOOL_MAX_CLUSTER_COUNT, std::numeric_limits<int32_t>::max(), MEMPOOL_ACCEPTABLE_ITERS)},
+      m_opts{Flatten(std::move(opts), error)}
 {
 }
 
@@ -452,12 +464,10 @@ void CTxMemPool::Apply(ChangeSet* changeset)
             // not the mempool policy limits are being respected).
             ancestors = *Assume(changeset->CalculateMemPoolAncestors(tx_entry, Limits::NoLimits()));
         }
-        // First splice this entry into mapTx.
-        auto node_handle = changeset->m_to_add.extract(tx_entry);
-        auto result = mapTx.insert(std::move(node_handle));
-
-        Assume(result.inserted);
-        txiter it = result.position;
+        // First copy this entry into mapTx. The staged entry is dropped with the rest of the
+        // change set.
+        auto [it, inserted] = mapTx.emplace(CTxMemPoolEntry::ExplicitCopy, *tx_entry);
+        Assume(inserted);
 
         // Now update the entry for ancestors/descendants.
         if (ancestors.has_value()) {
@@ -466,6 +476,7 @@ void CTxMemPool::Apply(ChangeSet* changeset)
             addNewTransaction(it);
         }
     }
+    m_txgraph->DoWork(MEMPOOL_POST_CHANGE_WORK);
 }
 
 void CTxMemPool::addNewTransaction(CTxMemPool::txiter it)
@@ -483,6 +494,13 @@ void CTxMemPool::addNewTransaction(CTxMemPool::txiter newit, CTxMemPool::setEntr
     // further updated.)
     cachedInnerUsage += entry.DynamicMemoryUsage();
 
+    m_projected_block_feerates.reset();
+
+    // Give the entry its place in the transaction graph before linking it to its parents.
+    mapTx.modify(newit, [&](CTxMemPoolEntry& e) {
+        static_cast<TxGraph::Ref&>(e) = m_txgraph->AddTransaction(GraphFeerate(e));
+    });
+
     const CTransaction& tx = newit->GetTx();
     std::set<Txid> setParentTransactions;
     for (unsigned int i = 0; i < tx.vin.size(); i++) {
@@ -522,6 +540,7 @@ void CTxMemPool::removeUnchecked(txiter it, MemPoolRemovalReason reason)
     // We increment mempool sequence value no matter removal reason
     // even if not directly reported below.
     uint64_t mempool_sequence = GetAndIncrementSequence();
+    m_projected_block_feerates.reset();
 
     if (reason != MemPoolRemovalReason::BLOCK && m_opts.signals) {
         // Notify clients that a transaction has been removed from the mempool
@@ -685,6 +704,7 @@ void CTxMemPool::removeForBlock(const std::vector<CTransactionRef>& vtx, unsigne
     if (m_opts.signals) {
         m_opts.signals->MempoolTransactionsRemovedForBlock(txs_removed_for_block, nBlockHeight);
     }
+    m_txgraph->DoWork(MEMPOOL_POST_CHANGE_WORK);
     lastRollingFeeUpdate = GetTime();
     blockSinceLastRollingFeeBump = true;
 }
@@ -894,6 +914,8 @@ void CTxMemPool::PrioritiseTransaction(const Txid& hash, const CAmount& nFeeDelt
         txiter it = mapTx.find(hash);
         if (it != mapTx.end()) {
             mapTx.modify(it, [&nFeeDelta](CTxMemPoolEntry& e) { e.UpdateModifiedFee(nFeeDelta); });
+            m_txgraph->SetTransactionFee(*it, it->GetModifiedFee());
+            m_projected_block_feerates.reset();
             // Now update all ancestors' modified fees with descendants
             auto ancestors{AssumeCalculateMemPoolAncestors(__func__, *it, Limits::NoLimits(), /*fSearchForParents=*/false)};
             for (txiter ancestorIt : ancestors) {
@@ -1044,8 +1066,40 @@ void CCoinsViewMemPool::Reset()
 
 size_t CTxMemPool::DynamicMemoryUsage() const {
     LOCK(cs);
-    // Estimate the overhead of mapTx to be 15 pointers + an allocation, as no exact formula for boost::multi_index_contained is implemented.
-    return memusage::MallocUsage(sizeof(CTxMemPoolEntry) + 15 * sizeof(void*)) * mapTx.size() + memusage::DynamicUsage(mapNextTx) + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + cachedInnerUsage;
+    // The nodes of mapTx and mapNextTx are allocated from m_index_memory_resource, which knows how
+    // many bytes they occupy. Free blocks kept in the pool for reuse are not counted, so that
+    // evicting transactions in TrimToSize() lowers the usage again. This means the usage can be
+    // lower than the memory held by the pool's chunks, by up to the size of its freelists after
+    // a large eviction, as the chunks are only released when the mempool is destroyed.
+    return m_index_memory_resource.UsedBytes() - m_index_empty_bytes + memusage::DynamicUsage(mapDeltas) + memusage::DynamicUsage(txns_randomized) + m_txgraph->GetMainMemoryUsage() + cachedInnerUsage;
+}
+
+std::vector<CFeeRate> CTxMemPool::GetProjectedBlockFeerates() const
+{
+    LOCK(cs);
+    if (m_projected_block_feerates) return *m_projected_block_feerates;
+
+    std::vector<CFeeRate> block_feerates;
+    if (HaveClusterLinearizations()) {
+        const auto builder{GetBlockBuilder()};
+        int64_t block_weight{0};
+        FeePerWeight block_min_feerate;
+        while (block_feerates.size() < MAX_PROJECTED_BLOCKS) {
+            const auto chunk{builder->GetCurrentChunk()};
+            if (!chunk) break;
+            const FeePerWeight& chunk_feerate{chunk->second};
+            if (block_weight + chunk_feerate.size > DEFAULT_BLOCK_MAX_WEIGHT) {
+                // The chunk does not fit anymore, so the block is full and the chunk starts the next one.
+                block_feerates.emplace_back(block_min_feerate.fee, block_min_feerate.size / WITNESS_SCALE_FACTOR);
+                block_weight = 0;
+            }
+            if (block_weight == 0 || chunk_feerate << block_min_feerate) block_min_feerate = chunk_feerate;
+            block_weight += chunk_feerate.size;
+            builder->Include();
+        }
+    }
+    m_projected_block_feerates = block_feerates;
+    return block_feerates;
 }
 
 void CTxMemPool::RemoveUnbroadcastTx(const Txid& txid, const bool unchecked) {
@@ -1089,6 +1143,8 @@ void CTxMemPool::UpdateChild(txiter entry, txiter child, bool add)
     CTxMemPoolEntry::Children s;
     if (add && entry->GetMemPoolChildren().insert(*child).second) {
         cachedInnerUsage += memusage::IncrementalDynamicUsage(s);
+        m_txgraph->AddDependency(/*parent=*/*entry, /*child=*/*child);
+        m_projected_block_feerates.reset();
     } else if (!add && entry->GetMemPoolChildren().erase(*child)) {
         cachedInnerUsage -= memusage::IncrementalDynamicUsage(s);
     }
@@ -1143,20 +1199,7 @@ void CTxMemPool::TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpends
 
     unsigned nTxnRemoved = 0;
     CFeeRate maxFeeRateRemoved(0);
-    while (!mapTx.empty() && DynamicMemoryUsage() > sizelimit) {
-        indexed_transaction_set::index<descendant_score>::type::iterator it = mapTx.get<descendant_score>().begin();
-
-        // We set the new mempool min fee to the feerate of the removed set, plus the
-        // "minimum reasonable fee rate" (ie some value under which we consider txn
-        // to have 0 fee). This way, we don't allow txn to enter mempool with feerate
-        // equal to txn which were removed with no block in between.
-        CFeeRate removed(it->GetModFeesWithDescendants(), it->GetSizeWithDescendants());
-        removed += m_opts.incremental_relay_feerate;
-        trackPackageRemoved(removed);
-        maxFeeRateRemoved = std::max(maxFeeRateRemoved, removed);
-
-        setEntries stage;
-        CalculateDescendants(mapTx.project<0>(it), stage);
+    const auto remove_staged{[&](setEntries& stage) EXCLUSIVE_LOCKS_REQUIRED(cs) {
         nTxnRemoved += stage.size();
 
         std::vector<CTransaction> txn;
@@ -1174,6 +1217,49 @@ void CTxMemPool::TrimToSize(size_t sizelimit, std::vector<COutPoint>* pvNoSpends
                 }
             }
         }
+    }};
+
+    // Clusters too large to be linearized have no chunks to evict by. As we need to evict
+    // anyway, first remove enough of their transactions to bring them within the limits.
+    // These are not chosen by feerate, so bump the minimum fee by their combined feerate to
+    // keep them from being accepted again right away.
+    if (!mapTx.empty() && DynamicMemoryUsage() > sizelimit && !HaveClusterLinearizations()) {
+        setEntries stage;
+        FeePerWeight trimmed_feerate;
+        for (const TxGraph::Ref* ref : m_txgraph->Trim()) {
+            const txiter it{GetIter(*ref)};
+            stage.insert(it);
+            trimmed_feerate += GraphFeerate(*it);
+        }
+        if (!stage.empty()) {
+            CFeeRate removed(trimmed_feerate.fee, trimmed_feerate.size / WITNESS_SCALE_FACTOR);
+            removed += m_opts.incremental_relay_feerate;
+            trackPackageRemoved(removed);
+            maxFeeRateRemoved = std::max(maxFeeRateRemoved, removed);
+        }
+        remove_staged(stage);
+    }
+
+    while (!mapTx.empty() && DynamicMemoryUsage() > sizelimit) {
+        // The chunk index of the graph is kept sorted as transactions are added and removed, so
+        // finding the lowest-feerate chunk does not depend on the size of the mempool. That
+        // chunk is the last one of its cluster, so it includes all of its descendants.
+        const auto [chunk, chunk_feerate]{m_txgraph->GetWorstMainChunk()};
+        setEntries stage;
+        for (const TxGraph::Ref* ref : chunk) {
+            stage.insert(GetIter(*ref));
+        }
+
+        // We set the new mempool min fee to the feerate of the removed set, plus the
+        // "minimum reasonable fee rate" (ie some value under which we consider txn
+        // to have 0 fee). This way, we don't allow txn to enter mempool with feerate
+        // equal to txn which were removed with no block in between.
+        CFeeRate removed(chunk_feerate.fee, chunk_feerate.size / WITNESS_SCALE_FACTOR);
+        removed += m_opts.incremental_relay_feerate;
+        trackPackageRemoved(removed);
+        maxFeeRateRemoved = std::max(maxFeeRateRemoved, removed);
+
+        remove_staged(stage);
     }
 
     if (maxFeeRateRemoved > CFeeRate(0)) {
@@ -1294,6 +1380,40 @@ std::optional<std::string> CTxMemPool::CheckConflictTopology(const setEntries& d
     return std::nullopt;
 }
 
+util::Result<void> CTxMemPool::ChangeSet::CheckClusterLimits()
+{
+    LOCK(m_pool->cs);
+    TxGraph& graph{*m_pool->m_txgraph};
+    graph.StartStaging();
+    for (auto it : m_to_remove) {
+        graph.RemoveTransaction(*it);
+    }
+    // The staged entries only get their own Refs once they are added to mapTx, so use temporary
+    // ones in the same order. Parents always come before their children in m_entry_vec.
+    std::vector<TxGraph::Ref> staged;
+    staged.reserve(m_entry_vec.size());
+    for (auto it : m_entry_vec) {
+        staged.push_back(graph.AddTransaction(GraphFeerate(*it)));
+        for (const CTxIn& txin : it->GetTx().vin) {
+            if (auto parent{m_pool->GetIter(txin.prevout.hash)}) {
+                graph.AddDependency(/*parent=*/**parent, /*child=*/staged.back());
+            } else {
+                for (size_t i{0}; i + 1 < staged.size(); ++i) {
+                    if (m_entry_vec[i]->GetTx().GetHash() == txin.prevout.hash) {
+                        graph.AddDependency(/*parent=*/staged[i], /*child=*/staged.back());
+                    }
+                }
+            }
+        }
+    }
+    const bool oversized{graph.IsOversized()};
+    graph.AbortStaging();
+    if (oversized) {
+        return util::Error{Untranslated(strprintf("exceeds cluster count limit of %u transactions", MEMPOOL_MAX_CLUSTER_COUNT))};
+    }
+    return {};
+}
+
 util::Result<std::pair<std::vector<FeeFrac>, std::vector<FeeFrac>>> CTxMemPool::ChangeSet::CalculateChunksForRBF()
 {
     LOCK(m_pool->cs);
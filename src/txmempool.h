@@ -8,6 +8,7 @@
 
 #include <coins.h>
 #include <consensus/amount.h>
+#include <consensus/consensus.h>
 #include <indirectmap.h>
 #include <kernel/cs_main.h>
 #include <kernel/mempool_entry.h>          // IWYU pragma: export
@@ -18,7 +19,10 @@
 #include <policy/packages.h>
 #include <primitives/transaction.h>
 #include <primitives/transaction_identifier.h>
+#include <support/allocators/pool.h>
 #include <sync.h>
+#include <txgraph.h>
+#include <util/check.h>
 #include <util/epochguard.h>
 #include <util/feefrac.h>
 #include <util/hasher.h>
@@ -34,6 +38,7 @@
 
 #include <atomic>
 #include <map>
+#include <memory>
 #include <optional>
 #include <set>
 #include <string>
@@ -49,6 +54,13 @@ struct bilingual_str;
 /** Fake height value used in Coin to signify they are only in the memory pool (since 0.8) */
 static const uint32_t MEMPOOL_HEIGHT = 0x7FFFFFFF;
 
+/** Maximum number of transactions in a cluster for which the mempool maintains a linearization. */
+static constexpr unsigned MEMPOOL_MAX_CLUSTER_COUNT{MAX_CLUSTER_COUNT_LIMIT};
+/** Number of linearization iterations per cluster after which its linearization is considered good enough. */
+static constexpr uint64_t MEMPOOL_ACCEPTABLE_ITERS{1'700};
+/** Amount of linearization work to do after each mempool change, to keep later queries cheap. */
+static constexpr uint64_t MEMPOOL_POST_CHANGE_WORK{5 * MEMPOOL_ACCEPTABLE_ITERS};
+
 /**
  * Test whether the LockPoints height and time are still valid on the current chain
  */
@@ -290,6 +302,8 @@ protected:
     mutable bool blockSinceLastRollingFeeBump GUARDED_BY(cs){false};
     mutable double rollingMinimumFeeRate GUARDED_BY(cs){0}; //!< minimum fee to get into the pool, decreases exponentially
     mutable Epoch m_epoch GUARDED_BY(cs){};
+    //! Result of GetProjectedBlockFeerates(), reset whenever the mempool's chunks may have changed.
+    mutable std::optional<std::vector<CFeeRate>> m_projected_block_feerates GUARDED_BY(cs);
 
     // In-memory counter for external mempool tracking purposes.
     // This number is incremented once every time a transaction
@@ -335,10 +349,23 @@ public:
             >
         >
         {};
+
+    /**
+     * Largest node allocated from the index memory resource: a mapTx node holds the entry and the
+     * links of its five indexes (thirteen pointers), with some headroom for other boost versions.
+     * mapNextTx nodes are much smaller.
+     */
+    static constexpr size_t INDEX_NODE_MAX_BYTES{(sizeof(CTxMemPoolEntry) / alignof(void*) + 16) * alignof(void*)};
+    using IndexMemoryResource = PoolResource<INDEX_NODE_MAX_BYTES, alignof(void*)>;
+    template <typename T>
+    using IndexAllocator = PoolAllocator<T, INDEX_NODE_MAX_BYTES, alignof(void*)>;
+
     typedef boost::multi_index_container<
         CTxMemPoolEntry,
-        CTxMemPoolEntry_Indices
+        CTxMemPoolEntry_Indices,
+        IndexAllocator<CTxMemPoolEntry>
     > indexed_transaction_set;
+    using NextTxMap = indirectmap<COutPoint, const CTransaction*, IndexAllocator<std::pair<const COutPoint* const, const CTransaction*>>>;
 
     /**
      * This mutex needs to be locked when accessing `mapTx` or other members
@@ -365,7 +392,15 @@ public:
      * the mempool is consistent with the new chain tip and fully populated.
      */
     mutable RecursiveMutex cs;
-    indexed_transaction_set mapTx GUARDED_BY(cs);
+private:
+    /**
+     * Arena the nodes of mapTx and mapNextTx are allocated from, so they do not each pay for a
+     * separate heap allocation and DynamicMemoryUsage() can report the bytes they actually use.
+     * Declared before both so that it is destroyed last.
+     */
+    IndexMemoryResource m_index_memory_resource;
+public:
+    indexed_transaction_set mapTx GUARDED_BY(cs){indexed_transaction_set::ctor_args_list{}, indexed_transaction_set::allocator_type{&m_index_memory_resource}};
 
     using txiter = indexed_transaction_set::nth_index<0>::type::const_iterator;
     std::vector<std::pair<Wtxid, txiter>> txns_randomized GUARDED_BY(cs); //!< All transactions in mapTx with their wtxids, in arbitrary order
@@ -384,6 +419,24 @@ private:
 
     std::vector<indexed_transaction_set::const_iterator> GetSortedDepthAndScore() const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
+    /**
+     * Transaction graph mirroring mapTx and the parent/child links between its entries. Every
+     * entry in mapTx is its own TxGraph::Ref in this graph. It keeps all clusters linearized and
+     * chunked as long as none of them exceeds MEMPOOL_MAX_CLUSTER_COUNT transactions; beyond that
+     * (see HaveClusterLinearizations()) callers fall back to ancestor and descendant scores.
+     * Admission keeps clusters within that limit (see ChangeSet::CheckClusterLimits()), so only
+     * transactions re-added from disconnected blocks can exceed it, until
+     * UpdateTransactionsFromBlock() trims them.
+     * Declared after mapTx so that it is destroyed first.
+     */
+    std::unique_ptr<TxGraph> m_txgraph GUARDED_BY(cs);
+
+    /** Feerate of an entry as tracked in m_txgraph. */
+    static FeePerWeight GraphFeerate(const CTxMemPoolEntry& entry)
+    {
+        return {entry.GetModifiedFee(), entry.GetTxSize() * WITNESS_SCALE_FACTOR};
+    }
+
     /**
      * Track locally submitted transactions to periodically retry initial broadcast.
      */
@@ -413,9 +466,18 @@ private:
     }
 
 public:
-    indirectmap<COutPoint, const CTransaction*> mapNextTx GUARDED_BY(cs);
+    NextTxMap mapNextTx GUARDED_BY(cs){NextTxMap::allocator_type{&m_index_memory_resource}};
     std::map<Txid, CAmount> mapDeltas GUARDED_BY(cs);
 
+private:
+    /**
+     * Bytes mapTx allocates from m_index_memory_resource while still empty, for its header node.
+     * They are not charged to the transactions, so an empty mempool has no index usage.
+     */
+    const size_t m_index_empty_bytes{m_index_memory_resource.UsedBytes()};
+
+public:
+
     using Options = kernel::MemPoolOptions;
 
     const Options m_opts;
@@ -502,6 +564,8 @@ public:
      *        vHashesToUpdate, which are already accounted for). Updated state
      *        includes add fee/size information for such descendants to the
      *        parent and updated ancestor state to include the parent.
+     *  @post no cluster exceeds the cluster limits, transactions were
+     *        removed with their descendants otherwise.
      *
      * @param[in] vHashesToUpdate          The set of txids from the
      *     disconnected block that have been accepted back into the mempool.
@@ -570,6 +634,40 @@ public:
      *  already in it.  */
     void CalculateDescendants(txiter it, setEntries& setDescendants) const EXCLUSIVE_LOCKS_REQUIRED(cs);
 
+    /** Whether every cluster in the mempool is small enough to be linearized, in which case
+     *  GetBlockBuilder() and chunk-based eviction are available. */
+    bool HaveClusterLinearizations() const EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        return !m_txgraph->IsOversized(/*main_only=*/true);
+    }
+
+    /** Get an object that reports the mempool's chunks from highest to lowest feerate, for block
+     *  building. Requires HaveClusterLinearizations(). The mempool must not be modified while the
+     *  returned object exists. */
+    std::unique_ptr<TxGraph::BlockBuilder> GetBlockBuilder() const EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        Assume(HaveClusterLinearizations());
+        return m_txgraph->GetBlockBuilder();
+    }
+
+    /** Maximum number of blocks projected by GetProjectedBlockFeerates(). */
+    static constexpr size_t MAX_PROJECTED_BLOCKS{12};
+
+    /**
+     * Project the next blocks a miner would build from the mempool right now, by filling blocks of
+     * DEFAULT_BLOCK_MAX_WEIGHT with chunks in block building order. Returns the lowest chunk
+     * feerate in each of the first MAX_PROJECTED_BLOCKS projected blocks that the mempool fills;
+     * a transaction paying that feerate competes for the block. The projection is cached until
+     * the mempool changes. Returns an empty vector if !HaveClusterLinearizations().
+     */
+    std::vector<CFeeRate> GetProjectedBlockFeerates() const;
+
+    /** Convert a Ref returned by the mempool's transaction graph back into a mapTx iterator. */
+    txiter GetIter(const TxGraph::Ref& ref) const EXCLUSIVE_LOCKS_REQUIRED(cs)
+    {
+        return mapTx.iterator_to(static_cast<const CTxMemPoolEntry&>(ref));
+    }
+
     /** The minimum fee to get into the mempool, which may itself not be enough
      *  for larger-sized transactions.
      *  The m_incremental_relay_feerate policy variable is used to bound the time it
@@ -663,6 +761,10 @@ public:
     std::vector<CTxMemPoolEntryRef> entryAll() const EXCLUSIVE_LOCKS_REQUIRED(cs);
     std::vector<TxMempoolInfo> infoAll() const;
 
+    /**
+     * Memory used by the transactions and indexes of the mempool. Index nodes freed by evictions
+     * are not counted, although their blocks stay in the index memory resource for reuse.
+     */
     size_t DynamicMemoryUsage() const;
 
     /** Adds a transaction to the unbroadcast set */
@@ -815,7 +917,9 @@ public:
      */
     class ChangeSet {
     public:
-        explicit ChangeSet(CTxMemPool* pool) : m_pool(pool) {}
+        explicit ChangeSet(CTxMemPool* pool)
+            : m_pool(pool),
+              m_to_add{indexed_transaction_set::ctor_args_list{}, indexed_transaction_set::allocator_type{&m_memory_resource}} {}
         ~ChangeSet() EXCLUSIVE_LOCKS_REQUIRED(m_pool->cs) { m_pool->m_have_changeset = false; }
 
         ChangeSet(const ChangeSet&) = delete;
@@ -859,13 +963,30 @@ public:
          */
         util::Result<std::pair<std::vector<FeeFrac>, std::vector<FeeFrac>>> CalculateChunksForRBF();
 
+        /**
+         * Check that applying this change set keeps every cluster in the mempool within
+         * MEMPOOL_MAX_CLUSTER_COUNT transactions, by staging it in the mempool's transaction graph.
+         *
+         * @return {} or the error reason if the limit is hit.
+         */
+        util::Result<void> CheckClusterLimits();
+
         size_t GetTxCount() const { return m_entry_vec.size(); }
         const CTransaction& GetAddedTxn(size_t index) const { return m_entry_vec.at(index)->GetTx(); }
 
         void Apply() EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
     private:
+        /** A change set holds at most a package, so it does not need chunks as large as the mempool's. */
+        static constexpr size_t MEMORY_RESOURCE_CHUNK_BYTES{16 << 10};
+
         CTxMemPool* m_pool;
+        /**
+         * Arena of the staged entries, separate from the mempool's so that they are not charged to
+         * its DynamicMemoryUsage(). Apply() copies the entries into mapTx, as nodes cannot be moved
+         * between containers allocating from different resources.
+         */
+        IndexMemoryResource m_memory_resource{MEMORY_RESOURCE_CHUNK_BYTES};
         CTxMemPool::indexed_transaction_set m_to_add;
         std::vector<CTxMemPool::txiter> m_entry_vec; // track the added transactions' insertion order
         // map from the m_to_add index to the ancestors for the transaction
@@ -17,7 +17,9 @@
 #include <boost/multi_index_container.hpp>
 #include <boost/tuple/tuple.hpp>
 
+#include <algorithm>
 #include <chrono>
+#include <numeric>
 #include <unordered_map>
 #include <utility>
 
@@ -593,6 +595,40 @@ public:
         ++m_current_sequence;
     }
 
+    void ReceivedInvs(NodeId peer, std::span<const GenTxid> gtxids, bool preferred,
+                      std::chrono::microseconds reqtime)
+    {
+        if (gtxids.empty()) return;
+
+        // Sequence numbers follow the order of gtxids, so that GetRequestable returns them in announcement order.
+        // Insertion happens in txhash order instead: all new announcements then end up next to each other in
+        // the ByPeer index, and each one can be inserted right after the previous one using a hint rather than
+        // with a full index lookup.
+        std::vector<size_t> order(gtxids.size());
+        std::iota(order.begin(), order.end(), size_t{0});
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b) {
+            return gtxids[a].ToUint256() < gtxids[b].ToUint256();
+        });
+
+        auto& index = m_index.get<ByPeer>();
+        auto hint = index.lower_bound(ByPeerView{peer, false, gtxids[order.front()].ToUint256()});
+        size_t added{0};
+        for (const size_t pos : order) {
+            const GenTxid& gtxid{gtxids[pos]};
+            // See ReceivedInv: skip existing CANDIDATE_BEST announcements here, and rely on the uniqueness
+            // of the ByPeer index for the other states.
+            if (index.count(ByPeerView{peer, true, gtxid.ToUint256()})) continue;
+            const size_t size_before{index.size()};
+            auto it = index.emplace_hint(hint, gtxid, peer, preferred, reqtime, m_current_sequence + pos);
+            if (index.size() != size_before) ++added;
+            hint = std::next(it);
+        }
+
+        // Update accounting metadata once for the whole batch.
+        if (added) m_peerinfo[peer].m_total += added;
+        m_current_sequence += gtxids.size();
+    }
+
     //! Find the GenTxids to request now from peer.
     std::vector<GenTxid> GetRequestable(NodeId peer, std::chrono::microseconds now,
                                         std::vector<std::pair<NodeId, GenTxid>>* expired)
@@ -735,6 +771,12 @@ void TxRequestTracker::ReceivedInv(NodeId peer, const GenTxid& gtxid, bool prefe
     m_impl->ReceivedInv(peer, gtxid, preferred, reqtime);
 }
 
+void TxRequestTracker::ReceivedInvs(NodeId peer, std::span<const GenTxid> gtxids, bool preferred,
+                                    std::chrono::microseconds reqtime)
+{
+    m_impl->ReceivedInvs(peer, gtxids, preferred, reqtime);
+}
+
 void TxRequestTracker::RequestedTx(NodeId peer, const uint256& txhash, std::chrono::microseconds expiry)
 {
     m_impl->RequestedTx(peer, txhash, expiry);
@@ -9,6 +9,7 @@
 #include <charconv>
 #include <cstddef>
 #include <cstdint>
+#include <functional>
 #include <map>
 #include <stdexcept>
 #include <string>
@@ -98,6 +99,12 @@ public:
 
     std::string write(unsigned int prettyIndent = 0,
                       unsigned int indentLevel = 0) const;
+    /**
+     * Serialize like write(), but pass the output to flush in pieces of at least chunk_size bytes
+     * (except for the last one) as it is produced, instead of returning it as a single string.
+     */
+    void writeChunked(const std::function<void(std::string_view)>& flush, size_t chunk_size,
+                      unsigned int prettyIndent = 0) const;
 
     bool read(std::string_view raw);
 
@@ -109,8 +116,10 @@ private:
 
     void checkType(const VType& expected) const;
     bool findKey(const std::string& key, size_t& retIdx) const;
-    void writeArray(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
-    void writeObject(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const;
+    using FlushFunc = std::function<void(std::string&)>;
+    void writeTo(unsigned int prettyIndent, unsigned int indentLevel, std::string& s, const FlushFunc* flush) const;
+    void writeArray(unsigned int prettyIndent, unsigned int indentLevel, std::string& s, const FlushFunc* flush) const;
+    void writeObject(unsigned int prettyIndent, unsigned int indentLevel, std::string& s, const FlushFunc* flush) const;
 
 public:
     // Strict type-specific getters, these throw std::runtime_error if the
@@ -0,0 +1,45 @@
+// Copyright (c) 2025-present The Bitcoin Core developers
+// Distributed under the MIT software license, see the accompanying
+// file COPYING or https://opensource.org/licenses/mit-license.php.
+
+#ifndef BITCOIN_UNIVALUE_INCLUDE_UNIVALUE_SCAN_H
+#define BITCOIN_UNIVALUE_INCLUDE_UNIVALUE_SCAN_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+/** Whether a byte can appear as itself in a JSON string, both when reading and when writing. */
+inline bool json_isplain(unsigned char ch)
+{
+    return ch >= 0x20 && ch < 0x7f && ch != '"' && ch != '\\';
+}
+
+/**
+ * Return the number of leading bytes in [first, last) for which json_isplain holds.
+ *
+ * Most JSON strings are long runs of such bytes (hex, addresses, keys), so test eight
+ * bytes per step with word arithmetic and only fall back to single bytes around the
+ * first byte that needs attention.
+ */
+inline size_t json_plain_prefix(const char* first, const char* last)
+{
+    constexpr uint64_t ONES{0x0101010101010101};
+    constexpr uint64_t HIGHS{0x8080808080808080};
+    const char* p{first};
+    while (last - p >= 8) {
+        uint64_t w;
+        std::memcpy(&w, p, 8);
+        const uint64_t below_space{(w - ONES * 0x20) & ~w};
+        const uint64_t above_tilde{(w + ONES) | w};
+        const uint64_t quote{w ^ (ONES * '"')};
+        const uint64_t backslash{w ^ (ONES * '\\')};
+        const uint64_t special{below_space | above_tilde | ((quote - ONES) & ~quote) | ((backslash - ONES) & ~backslash)};
+        if (special & HIGHS) break;
+        p += 8;
+    }
+    while (p < last && json_isplain(static_cast<unsigned char>(*p))) ++p;
+    return p - first;
+}
+
+#endif // BITCOIN_UNIVALUE_INCLUDE_UNIVALUE_SCAN_H
@@ -5,6 +5,7 @@
 #define BITCOIN_UNIVALUE_INCLUDE_UNIVALUE_UTFFILTER_H
 
 #include <string>
+#include <string_view>
 
 /**
  * Filter that generates and validates UTF-8, as well as collates UTF-16
@@ -45,6 +46,13 @@ public:
                 push_back_u(codepoint);
         }
     }
+    // Write a run of 7-bit ASCII characters, equivalent to push_back for each
+    void append_ascii(std::string_view s)
+    {
+        if (state) // Not a continuation, invalid
+            is_valid = false;
+        str.append(s);
+    }
     // Write codepoint directly, possibly collating surrogate pairs
     void push_back_u(unsigned int codepoint_)
     {
@@ -5,6 +5,7 @@
 
 #include <univalue.h>
 
+#include <charconv>
 #include <iomanip>
 #include <map>
 #include <memory>
@@ -55,22 +56,27 @@ void UniValue::setNumStr(std::string str)
     val = std::move(str);
 }
 
-void UniValue::setInt(uint64_t val_)
+template <typename Int>
+static std::string int_to_str(Int val)
 {
-    std::ostringstream oss;
-
-    oss << val_;
+    char buf[24];
+    const auto res{std::to_chars(buf, buf + sizeof(buf), val)};
+    return {buf, res.ptr};
+}
 
-    return setNumStr(oss.str());
+void UniValue::setInt(uint64_t val_)
+{
+    // Formatted integers are always valid JSON numbers, skip setNumStr's check.
+    clear();
+    typ = VNUM;
+    val = int_to_str(val_);
 }
 
 void UniValue::setInt(int64_t val_)
 {
-    std::ostringstream oss;
-
-    oss << val_;
-
-    return setNumStr(oss.str());
+    clear();
+    typ = VNUM;
+    val = int_to_str(val_);
 }
 
 void UniValue::setFloat(double val_)
@@ -3,6 +3,7 @@
 // file COPYING or https://opensource.org/licenses/mit-license.php.
 
 #include <univalue.h>
+#include <univalue_scan.h>
 #include <univalue_utffilter.h>
 
 #include <cstdint>
@@ -10,6 +11,7 @@
 #include <cstring>
 #include <string>
 #include <string_view>
+#include <utility>
 #include <vector>
 
 /*
@@ -124,8 +126,6 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
     case '8':
     case '9': {
         // part 1: int
-        std::string numStr;
-
         const char *first = raw;
 
         const char *firstDigit = first;
@@ -134,49 +134,42 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
         if ((*firstDigit == '0') && json_isdigit(firstDigit[1]))
             return JTOK_ERR;
 
-        numStr += *raw;                       // copy first char
-        raw++;
+        raw++;                                // skip first char
 
         if ((*first == '-') && (raw < end) && (!json_isdigit(*raw)))
             return JTOK_ERR;
 
-        while (raw < end && json_isdigit(*raw)) {  // copy digits
-            numStr += *raw;
+        while (raw < end && json_isdigit(*raw)) {  // skip digits
             raw++;
         }
 
         // part 2: frac
         if (raw < end && *raw == '.') {
-            numStr += *raw;                   // copy .
-            raw++;
+            raw++;                            // skip .
 
             if (raw >= end || !json_isdigit(*raw))
                 return JTOK_ERR;
-            while (raw < end && json_isdigit(*raw)) { // copy digits
-                numStr += *raw;
+            while (raw < end && json_isdigit(*raw)) { // skip digits
                 raw++;
             }
         }
 
         // part 3: exp
         if (raw < end && (*raw == 'e' || *raw == 'E')) {
-            numStr += *raw;                   // copy E
-            raw++;
+            raw++;                            // skip E
 
-            if (raw < end && (*raw == '-' || *raw == '+')) { // copy +/-
-                numStr += *raw;
+            if (raw < end && (*raw == '-' || *raw == '+')) { // skip +/-
                 raw++;
             }
 
             if (raw >= end || !json_isdigit(*raw))
                 return JTOK_ERR;
-            while (raw < end && json_isdigit(*raw)) { // copy digits
-                numStr += *raw;
+            while (raw < end && json_isdigit(*raw)) { // skip digits
                 raw++;
             }
         }
 
-        tokenVal = numStr;
+        tokenVal.assign(first, raw);
         consumed = (raw - rawStart);
         return JTOK_NUMBER;
         }
@@ -184,8 +177,7 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
     case '"': {
         raw++;                                // skip "
 
-        std::string valStr;
-        JSONUTF8StringFilter writer(valStr);
+        JSONUTF8StringFilter writer(tokenVal);
 
         while (true) {
             if (raw >= end || (unsigned char)*raw < 0x20)
@@ -230,6 +222,11 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
                 break;                        // stop scanning
             }
 
+            else if (const size_t plain{json_plain_prefix(raw, end)}) {
+                writer.append_ascii({raw, plain});
+                raw += plain;
+            }
+
             else {
                 writer.push_back(static_cast<unsigned char>(*raw));
                 raw++;
@@ -238,7 +235,6 @@ enum jtokentype getJsonToken(std::string& tokenVal, unsigned int& consumed,
 
         if (!writer.finalize())
             return JTOK_ERR;
-        tokenVal = valStr;
         consumed = (raw - rawStart);
         return JTOK_STRING;
         }
@@ -328,9 +324,8 @@ bool UniValue::read(std::string_view str_in)
                     setArray();
                 stack.push_back(this);
             } else {
-                UniValue tmpVal(utyp);
                 UniValue *top = stack.back();
-                top->values.push_back(tmpVal);
+                top->values.emplace_back(utyp);
 
                 UniValue *newTop = &(top->values.back());
                 stack.push_back(newTop);
@@ -405,26 +400,26 @@ bool UniValue::read(std::string_view str_in)
             }
 
             if (!stack.size()) {
-                *this = tmpVal;
+                *this = std::move(tmpVal);
                 break;
             }
 
             UniValue *top = stack.back();
-            top->values.push_back(tmpVal);
+            top->values.push_back(std::move(tmpVal));
 
             setExpect(NOT_VALUE);
             break;
             }
 
         case JTOK_NUMBER: {
-            UniValue tmpVal(VNUM, tokenVal);
+            UniValue tmpVal(VNUM, std::move(tokenVal));
             if (!stack.size()) {
-                *this = tmpVal;
+                *this = std::move(tmpVal);
                 break;
             }
 
             UniValue *top = stack.back();
-            top->values.push_back(tmpVal);
+            top->values.push_back(std::move(tmpVal));
 
             setExpect(NOT_VALUE);
             break;
@@ -433,17 +428,17 @@ bool UniValue::read(std::string_view str_in)
         case JTOK_STRING: {
             if (expect(OBJ_NAME)) {
                 UniValue *top = stack.back();
-                top->keys.push_back(tokenVal);
+                top->keys.push_back(std::move(tokenVal));
                 clearExpect(OBJ_NAME);
                 setExpect(COLON);
             } else {
-                UniValue tmpVal(VSTR, tokenVal);
+                UniValue tmpVal(VSTR, std::move(tokenVal));
                 if (!stack.size()) {
-                    *this = tmpVal;
+                    *this = std::move(tmpVal);
                     break;
                 }
                 UniValue *top = stack.back();
-                top->values.push_back(tmpVal);
+                top->values.push_back(std::move(tmpVal));
             }
 
             setExpect(NOT_VALUE);
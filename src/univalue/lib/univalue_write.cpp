@@ -4,36 +4,60 @@
 
 #include <univalue.h>
 #include <univalue_escapes.h>
+#include <univalue_scan.h>
 
+#include <functional>
 #include <memory>
 #include <string>
+#include <string_view>
 #include <vector>
 
-static std::string json_escape(const std::string& inS)
+static void json_escape(std::string_view in, std::string& out)
 {
-    std::string outS;
-    outS.reserve(inS.size() * 2);
+    while (!in.empty()) {
+        const size_t plain{json_plain_prefix(in.data(), in.data() + in.size())};
+        out.append(in.data(), plain);
+        in.remove_prefix(plain);
+        if (in.empty()) break;
 
-    for (unsigned int i = 0; i < inS.size(); i++) {
-        unsigned char ch = static_cast<unsigned char>(inS[i]);
+        unsigned char ch = static_cast<unsigned char>(in.front());
         const char *escStr = escapes[ch];
 
         if (escStr)
-            outS += escStr;
+            out += escStr;
         else
-            outS += static_cast<char>(ch);
+            out += static_cast<char>(ch);
+        in.remove_prefix(1);
     }
-
-    return outS;
 }
 
-// NOLINTNEXTLINE(misc-no-recursion)
 std::string UniValue::write(unsigned int prettyIndent,
                             unsigned int indentLevel) const
 {
     std::string s;
     s.reserve(1024);
+    writeTo(prettyIndent, indentLevel, s, nullptr);
+    return s;
+}
+
+void UniValue::writeChunked(const std::function<void(std::string_view)>& flush, size_t chunk_size,
+                            unsigned int prettyIndent) const
+{
+    std::string s;
+    s.reserve(chunk_size);
+    const FlushFunc flush_full{[&](std::string& pending) {
+        if (pending.size() >= chunk_size) {
+            flush(pending);
+            pending.clear();
+        }
+    }};
+    writeTo(prettyIndent, 0, s, &flush_full);
+    if (!s.empty()) flush(s);
+}
 
+// NOLINTNEXTLINE(misc-no-recursion)
+void UniValue::writeTo(unsigned int prettyIndent, unsigned int indentLevel, std::string& s, const FlushFunc* flush) const
+{
     unsigned int modIndent = indentLevel;
     if (modIndent == 0)
         modIndent = 1;
@@ -43,13 +67,15 @@ std::string UniValue::write(unsigned int prettyIndent,
         s += "null";
         break;
     case VOBJ:
-        writeObject(prettyIndent, modIndent, s);
+        writeObject(prettyIndent, modIndent, s, flush);
         break;
     case VARR:
-        writeArray(prettyIndent, modIndent, s);
+        writeArray(prettyIndent, modIndent, s, flush);
         break;
     case VSTR:
-        s += "\"" + json_escape(val) + "\"";
+        s += '"';
+        json_escape(val, s);
+        s += '"';
         break;
     case VNUM:
         s += val;
@@ -58,8 +84,6 @@ std::string UniValue::write(unsigned int prettyIndent,
         s += (val == "1" ? "true" : "false");
         break;
     }
-
-    return s;
 }
 
 static void indentStr(unsigned int prettyIndent, unsigned int indentLevel, std::string& s)
@@ -68,7 +92,7 @@ static void indentStr(unsigned int prettyIndent, unsigned int indentLevel, std::
 }
 
 // NOLINTNEXTLINE(misc-no-recursion)
-void UniValue::writeArray(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const
+void UniValue::writeArray(unsigned int prettyIndent, unsigned int indentLevel, std::string& s, const FlushFunc* flush) const
 {
     s += "[";
     if (prettyIndent)
@@ -77,12 +101,13 @@ void UniValue::writeArray(unsigned int prettyIndent, unsigned int indentLevel, s
     for (unsigned int i = 0; i < values.size(); i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += values[i].write(prettyIndent, indentLevel + 1);
+        values[i].writeTo(prettyIndent, indentLevel + 1, s, flush);
         if (i != (values.size() - 1)) {
             s += ",";
         }
         if (prettyIndent)
             s += "\n";
+        if (flush) (*flush)(s);
     }
 
     if (prettyIndent)
@@ -91,7 +116,7 @@ void UniValue::writeArray(unsigned int prettyIndent, unsigned int indentLevel, s
 }
 
 // NOLINTNEXTLINE(misc-no-recursion)
-void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel, std::string& s) const
+void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel, std::string& s, const FlushFunc* flush) const
 {
     s += "{";
     if (prettyIndent)
@@ -100,18 +125,20 @@ void UniValue::writeObject(unsigned int prettyIndent, unsigned int indentLevel,
     for (unsigned int i = 0; i < keys.size(); i++) {
         if (prettyIndent)
             indentStr(prettyIndent, indentLevel, s);
-        s += "\"" + json_escape(keys[i]) + "\":";
+        s += '"';
+        json_escape(keys[i], s);
+        s += "\":";
         if (prettyIndent)
             s += " ";
-        s += values.at(i).write(prettyIndent, indentLevel + 1);
+        values.at(i).writeTo(prettyIndent, indentLevel + 1, s, flush);
         if (i != (values.size() - 1))
             s += ",";
         if (prettyIndent)
             s += "\n";
+        if (flush) (*flush)(s);
     }
 
     if (prettyIndent)
         indentStr(prettyIndent, indentLevel - 1, s);
     s += "}";
 }
-
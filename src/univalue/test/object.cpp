@@ -455,6 +455,54 @@ void univalue_readwrite()
     BOOST_CHECK(!v.read("{} 42"));
 }
 
+void univalue_readwrite_long_strings()
+{
+    // Put characters that need attention at every offset of a string that is long
+    // enough to be scanned a word at a time.
+    for (const std::string special : {"\"", "\\", "\n", "\x01", "\x7f", "\xc3\xa9", "\xf0\x9d\x84\x9e"}) {
+        for (size_t pos{0}; pos <= 20; ++pos) {
+            const std::string str{std::string(pos, 'a') + special + std::string(20 - pos, 'b')};
+            const std::string json{UniValue{str}.write()};
+            UniValue v;
+            BOOST_CHECK(v.read(json));
+            BOOST_CHECK_EQUAL(v.get_str(), str);
+            BOOST_CHECK(v.read("{\"" + json.substr(1, json.size() - 2) + "\":" + json + "}"));
+            BOOST_CHECK_EQUAL(v.getKeys()[0], str);
+            BOOST_CHECK_EQUAL(v[str].get_str(), str);
+        }
+    }
+    BOOST_CHECK_EQUAL(UniValue{"0123456789\"0123456789\x7f"}.write(), "\"0123456789\\\"0123456789\\u007f\"");
+
+    UniValue v;
+    // Truncated UTF-8 sequences and unescaped control characters are caught ahead of long ASCII runs.
+    BOOST_CHECK(!v.read("\"\xc3" "abcdefghijklmnop\""));
+    BOOST_CHECK(!v.read("\"abcdefghijklmnop\xc3\""));
+    BOOST_CHECK(!v.read("\"abcdefghijklmnop\nqrstuvwxyz\""));
+    BOOST_CHECK(!v.read("\"abcdefghijklmnopqrstuvwxyz"));
+}
+
+void univalue_write_chunked()
+{
+    UniValue v;
+    BOOST_CHECK(v.read(json1));
+
+    for (unsigned int pretty : {0U, 4U}) {
+        for (size_t chunk_size : {size_t{1}, size_t{16}, size_t{1000}}) {
+            std::string out;
+            size_t num_chunks{0};
+            v.writeChunked([&](std::string_view chunk) {
+                // Every chunk but the last one reaches the requested size.
+                if (num_chunks > 0) BOOST_CHECK(out.size() >= chunk_size * num_chunks);
+                out += chunk;
+                ++num_chunks;
+            }, chunk_size, pretty);
+            BOOST_CHECK_EQUAL(out, v.write(pretty));
+            BOOST_CHECK(num_chunks >= 1);
+            if (chunk_size == 1000) BOOST_CHECK_EQUAL(num_chunks, 1);
+        }
+    }
+}
+
 int main(int argc, char* argv[])
 {
     univalue_constructor();
@@ -464,5 +512,7 @@ int main(int argc, char* argv[])
     univalue_array();
     univalue_object();
     univalue_readwrite();
+    univalue_readwrite_long_strings();
+    univalue_write_chunked();
     return 0;
 }
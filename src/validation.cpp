@@ -485,10 +485,14 @@ public:
         /** Whether CPFP carveout and RBF carveout are granted. */
         const bool m_allow_carveouts;
 
+        /** When true, input scripts are assumed valid and not verified. Nothing is added to the
+         * script cache, so blocks including the transaction still verify them. */
+        const bool m_skip_script_checks;
+
         /** Parameters for single transaction mempool validation. */
         static ATMPArgs SingleAccept(const CChainParams& chainparams, int64_t accept_time,
                                      bool bypass_limits, std::vector<COutPoint>& coins_to_uncache,
-                                     bool test_accept) {
+                                     bool test_accept, bool skip_script_checks) {
             return ATMPArgs{/* m_chainparams */ chainparams,
                             /* m_accept_time */ accept_time,
                             /* m_bypass_limits */ bypass_limits,
@@ -500,6 +504,7 @@ public:
                             /* m_package_feerates */ false,
                             /* m_client_maxfeerate */ {}, // checked by caller
                             /* m_allow_carveouts */ true,
+                            /* m_skip_script_checks */ skip_script_checks,
             };
         }
 
@@ -517,6 +522,7 @@ public:
                             /* m_package_feerates */ false,
                             /* m_client_maxfeerate */ {}, // checked by caller
                             /* m_allow_carveouts */ false,
+                            /* m_skip_script_checks */ false,
             };
         }
 
@@ -534,6 +540,7 @@ public:
                             /* m_package_feerates */ true,
                             /* m_client_maxfeerate */ client_maxfeerate,
                             /* m_allow_carveouts */ false,
+                            /* m_skip_script_checks */ false,
             };
         }
 
@@ -550,6 +557,7 @@ public:
                             /* m_package_feerates */ false, // only 1 transaction
                             /* m_client_maxfeerate */ package_args.m_client_maxfeerate,
                             /* m_allow_carveouts */ false,
+                            /* m_skip_script_checks */ false,
             };
         }
 
@@ -566,7 +574,8 @@ public:
                  bool package_submission,
                  bool package_feerates,
                  std::optional<CFeeRate> client_maxfeerate,
-                 bool allow_carveouts)
+                 bool allow_carveouts,
+                 bool skip_script_checks)
             : m_chainparams{chainparams},
               m_accept_time{accept_time},
               m_bypass_limits{bypass_limits},
@@ -577,7 +586,8 @@ public:
               m_package_submission{package_submission},
               m_package_feerates{package_feerates},
               m_client_maxfeerate{client_maxfeerate},
-              m_allow_carveouts{allow_carveouts}
+              m_allow_carveouts{allow_carveouts},
+              m_skip_script_checks{skip_script_checks}
         {
             // If we are using package feerates, we must be doing package submission.
             // It also means carveouts and sibling eviction are not permitted.
@@ -683,6 +693,13 @@ private:
     // only invoke this on transactions that have otherwise passed policy checks.
     bool PolicyScriptChecks(const ATMPArgs& args, Workspace& ws) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_pool.cs);
 
+    // Run the script checks of PolicyScriptChecks() for all given transactions at once on the
+    // script check queue, if it has worker threads and there are enough inputs to make that
+    // worthwhile. Returns true only if all scripts were verified successfully this way.
+    // Otherwise, PolicyScriptChecks() must still be run for each transaction, which also
+    // determines the exact failure.
+    bool ParallelPolicyScriptChecks(std::span<Workspace> workspaces) EXCLUSIVE_LOCKS_REQUIRED(cs_main, m_pool.cs);
+
     // Re-run the script checks, using consensus flags, and try to cache the
     // result in the scriptcache. This should be done after
     // PolicyScriptChecks(). This requires that all inputs either be in our
@@ -1265,6 +1282,29 @@ bool MemPoolAccept::PolicyScriptChecks(const ATMPArgs& args, Workspace& ws)
     return true;
 }
 
+bool MemPoolAccept::ParallelPolicyScriptChecks(std::span<Workspace> workspaces)
+{
+    AssertLockHeld(cs_main);
+    AssertLockHeld(m_pool.cs);
+
+    auto& queue{m_active_chainstate.m_chainman.GetCheckQueue()};
+    if (!queue.HasThreads()) return false;
+    size_t num_inputs{0};
+    for (const Workspace& ws : workspaces) num_inputs += ws.m_ptx->vin.size();
+    if (num_inputs < MIN_PARALLEL_MEMPOOL_SCRIPT_CHECKS) return false;
+
+    // Both this and ConnectBlock() hold cs_main while using the queue, so it is never contended.
+    CCheckQueueControl<CScriptCheck> control(queue);
+    for (Workspace& ws : workspaces) {
+        std::vector<CScriptCheck> checks;
+        if (!CheckInputScripts(*ws.m_ptx, ws.m_state, m_view, STANDARD_SCRIPT_VERIFY_FLAGS, true, false, ws.m_precomputed_txdata, GetValidationCache(), &checks)) {
+            return false;
+        }
+        control.Add(std::move(checks));
+    }
+    return !control.Complete().has_value();
+}
+
 bool MemPoolAccept::ConsensusScriptChecks(const ATMPArgs& args, Workspace& ws)
 {
     AssertLockHeld(cs_main);
@@ -1464,11 +1504,20 @@ MempoolAcceptResult MemPoolAccept::AcceptSingleTransaction(const CTransactionRef
         return MempoolAcceptResult::Failure(ws.m_state);
     }
 
+    if (!args.m_bypass_limits) {
+        if (auto result{m_subpackage.m_changeset->CheckClusterLimits()}; !result) {
+            ws.m_state.Invalid(TxValidationResult::TX_MEMPOOL_POLICY, "too-large-cluster", util::ErrorString(result).original);
+            return MempoolAcceptResult::Failure(ws.m_state);
+        }
+    }
+
     // Perform the inexpensive checks first and avoid hashing and signature verification unless
     // those checks pass, to mitigate CPU exhaustion denial-of-service attacks.
-    if (!PolicyScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
+    if (!args.m_skip_script_checks) {
+        if (!ParallelPolicyScriptChecks({&ws, 1}) && !PolicyScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
 
-    if (!ConsensusScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
+        if (!ConsensusScriptChecks(args, ws)) return MempoolAcceptResult::Failure(ws.m_state);
+    }
 
     const CFeeRate effective_feerate{ws.m_modified_fees, static_cast<int32_t>(ws.m_vsize)};
     // Tx was accepted, but not added
@@ -1605,6 +1654,13 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptMultipleTransactions(const std::
         return PackageMempoolAcceptResult(package_state, std::move(results));
     }
 
+    if (!args.m_bypass_limits) {
+        if (auto result{m_subpackage.m_changeset->CheckClusterLimits()}; !result) {
+            package_state.Invalid(PackageValidationResult::PCKG_POLICY, "too-large-cluster", util::ErrorString(result).original);
+            return PackageMempoolAcceptResult(package_state, std::move(results));
+        }
+    }
+
     // Now that we've bounded the resulting possible ancestry count, check package for dust spends
     if (m_pool.m_opts.require_standard) {
         TxValidationState child_state;
@@ -1616,9 +1672,10 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptMultipleTransactions(const std::
         }
     }
 
+    const bool scripts_checked{ParallelPolicyScriptChecks(workspaces)};
     for (Workspace& ws : workspaces) {
         ws.m_package_feerate = package_feerate;
-        if (!PolicyScriptChecks(args, ws)) {
+        if (!scripts_checked && !PolicyScriptChecks(args, ws)) {
             // Exit early to avoid doing pointless work. Update the failed tx result; the rest are unfinished.
             package_state.Invalid(PackageValidationResult::PCKG_TX, "transaction failed");
             results.emplace(ws.m_ptx->GetWitnessHash(), MempoolAcceptResult::Failure(ws.m_state));
@@ -1856,7 +1913,8 @@ PackageMempoolAcceptResult MemPoolAccept::AcceptPackage(const Package& package,
 } // anon namespace
 
 MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTransactionRef& tx,
-                                       int64_t accept_time, bool bypass_limits, bool test_accept)
+                                       int64_t accept_time, bool bypass_limits, bool test_accept,
+                                       bool skip_script_checks)
 {
     AssertLockHeld(::cs_main);
     const CChainParams& chainparams{active_chainstate.m_chainman.GetParams()};
@@ -1864,7 +1922,7 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
     CTxMemPool& pool{*active_chainstate.GetMempool()};
 
     std::vector<COutPoint> coins_to_uncache;
-    auto args = MemPoolAccept::ATMPArgs::SingleAccept(chainparams, accept_time, bypass_limits, coins_to_uncache, test_accept);
+    auto args = MemPoolAccept::ATMPArgs::SingleAccept(chainparams, accept_time, bypass_limits, coins_to_uncache, test_accept, skip_script_checks);
     MempoolAcceptResult result = MemPoolAccept(pool, active_chainstate).AcceptSingleTransaction(tx, args);
     if (result.m_result_type != MempoolAcceptResult::ResultType::VALID) {
         // Remove coins that were not present in the coins cache before calling
@@ -1885,6 +1943,36 @@ MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTra
     return result;
 }
 
+void PrewarmMempoolSignatureCache(Chainstate& active_chainstate, std::span<const CTransactionRef> txs)
+{
+    AssertLockHeld(::cs_main);
+    auto& queue{active_chainstate.m_chainman.GetCheckQueue()};
+    CTxMemPool* pool{active_chainstate.GetMempool()};
+    if (!queue.HasThreads() || !pool) return;
+
+    LOCK(pool->cs);
+    CCoinsViewMemPool view_mempool{&active_chainstate.CoinsTip(), *pool};
+    CCoinsViewCache view{&view_mempool};
+    // The checks refer to the precomputed data, so it must outlive them.
+    std::vector<PrecomputedTransactionData> txdata(txs.size());
+    std::vector<CScriptCheck> checks;
+    for (size_t i{0}; i < txs.size(); ++i) {
+        const CTransaction& tx{*txs[i]};
+        if (view.HaveInputs(tx)) {
+            TxValidationState state;
+            CheckInputScripts(tx, state, view, STANDARD_SCRIPT_VERIFY_FLAGS, /*cacheSigStore=*/true, /*cacheFullScriptStore=*/false,
+                              txdata[i], active_chainstate.m_chainman.m_validation_cache, &checks);
+        }
+        // Make the outputs available to the transactions after it.
+        AddCoins(view, tx, MEMPOOL_HEIGHT, /*check=*/true);
+    }
+
+    // Signatures are cached as the checks succeed; a failure only stops the remaining checks early.
+    CCheckQueueControl<CScriptCheck> control(queue);
+    control.Add(std::move(checks));
+    (void)control.Complete();
+}
+
 PackageMempoolAcceptResult ProcessNewPackage(Chainstate& active_chainstate, CTxMemPool& pool,
                                                    const Package& package, bool test_accept, const std::optional<CFeeRate>& client_maxfeerate)
 {
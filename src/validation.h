@@ -83,6 +83,8 @@ static const uint64_t MIN_DISK_SPACE_FOR_BLOCK_FILES = 550 * 1024 * 1024;
 
 /** Maximum number of dedicated script-checking threads allowed */
 static constexpr int MAX_SCRIPTCHECK_THREADS{15};
+/** Minimum number of inputs for mempool acceptance to verify scripts on the script-checking threads */
+static constexpr size_t MIN_PARALLEL_MEMPOOL_SCRIPT_CHECKS{16};
 
 /** Current sync state passed to tip changed callbacks. */
 enum class SynchronizationState {
@@ -263,11 +265,23 @@ struct PackageMempoolAcceptResult
  * @param[in]  bypass_limits      When true, don't enforce mempool fee and capacity limits,
  *                                and set entry_sequence to zero.
  * @param[in]  test_accept        When true, run validation checks but don't submit to mempool.
+ * @param[in]  skip_script_checks When true, don't verify input scripts. Only for transactions that
+ *                                were validated at the current tip before, e.g. by this node.
  *
  * @returns a MempoolAcceptResult indicating whether the transaction was accepted/rejected with reason.
  */
 MempoolAcceptResult AcceptToMemoryPool(Chainstate& active_chainstate, const CTransactionRef& tx,
-                                       int64_t accept_time, bool bypass_limits, bool test_accept)
+                                       int64_t accept_time, bool bypass_limits, bool test_accept,
+                                       bool skip_script_checks = false)
+    EXCLUSIVE_LOCKS_REQUIRED(cs_main);
+
+/**
+ * Verify the input scripts of transactions about to be submitted to the mempool in parallel on the
+ * script check queue, so that their signatures are cached by the time AcceptToMemoryPool() is
+ * called for each of them. Transactions may spend outputs of earlier transactions in txs. Failures
+ * are ignored and left to AcceptToMemoryPool() to report. Does nothing without script check threads.
+ */
+void PrewarmMempoolSignatureCache(Chainstate& active_chainstate, std::span<const CTransactionRef> txs)
     EXCLUSIVE_LOCKS_REQUIRED(cs_main);
 
 /**
@@ -5,6 +5,7 @@
 """Test the RBF code."""
 
 from decimal import Decimal
+from math import ceil
 
 from test_framework.messages import (
     MAX_BIP125_RBF_SEQUENCE,
@@ -21,6 +22,9 @@ from test_framework.wallet import MiniWallet
 from test_framework.address import ADDRESS_BCRT1_UNSPENDABLE
 
 MAX_REPLACEMENT_LIMIT = 100
+# Transactions per tree of conflicting transactions, so that each one stays within the cluster
+# count limit of 64 transactions.
+MAX_TREE_TXS = 50
 class ReplaceByFeeTest(BitcoinTestFramework):
     def set_test_params(self):
         self.num_nodes = 2
@@ -185,7 +189,6 @@ class ReplaceByFeeTest(BitcoinTestFramework):
         """Doublespend of a big tree of transactions"""
 
         initial_nValue = 5 * COIN
-        tx0_outpoint = self.make_utxo(self.nodes[0], initial_nValue)
 
         def branch(prevout, initial_value, max_txs, tree_width=5, fee=0.00001 * COIN, _total_txs=None):
             if _total_txs is None:
@@ -215,25 +218,33 @@ class ReplaceByFeeTest(BitcoinTestFramework):
                                   _total_txs=_total_txs):
                     yield x
 
+        def trees(n):
+            """Make trees of n transactions in total, return their root outpoints and txids"""
+            outpoints = [self.make_utxo(self.nodes[0], initial_nValue) for _ in range(ceil(n / MAX_TREE_TXS))]
+            tree_txs = []
+            for outpoint in outpoints:
+                tree_txs += branch(outpoint, initial_nValue, min(n - len(tree_txs), MAX_TREE_TXS), fee=fee)
+            assert_equal(len(tree_txs), n)
+            return outpoints, tree_txs
+
         fee = int(0.00001 * COIN)
         n = MAX_REPLACEMENT_LIMIT
-        tree_txs = list(branch(tx0_outpoint, initial_nValue, n, fee=fee))
-        assert_equal(len(tree_txs), n)
+        tx0_outpoints, tree_txs = trees(n)
 
         # Attempt double-spend, will fail because too little fee paid
-        dbl_tx_hex = self.wallet.create_self_transfer(
-            utxo_to_spend=tx0_outpoint,
+        dbl_tx_hex = self.wallet.create_self_transfer_multi(
+            utxos_to_spend=tx0_outpoints,
             sequence=0,
-            fee=(Decimal(fee) / COIN) * n,
+            fee_per_output=fee * n,
         )["hex"]
         # This will raise an exception due to insufficient fee
         assert_raises_rpc_error(-26, "insufficient fee", self.nodes[0].sendrawtransaction, dbl_tx_hex, 0)
 
         # 0.1 BTC fee is enough
-        dbl_tx_hex = self.wallet.create_self_transfer(
-            utxo_to_spend=tx0_outpoint,
+        dbl_tx_hex = self.wallet.create_self_transfer_multi(
+            utxos_to_spend=tx0_outpoints,
             sequence=0,
-            fee=(Decimal(fee) / COIN) * n + Decimal("0.1"),
+            fee_per_output=fee * n + int(0.1 * COIN),
         )["hex"]
         self.nodes[0].sendrawtransaction(dbl_tx_hex, 0)
 
@@ -246,14 +257,12 @@ class ReplaceByFeeTest(BitcoinTestFramework):
         # double-spent at once" anti-DoS limit.
         for n in (MAX_REPLACEMENT_LIMIT + 1, MAX_REPLACEMENT_LIMIT * 2):
             fee = int(0.00001 * COIN)
-            tx0_outpoint = self.make_utxo(self.nodes[0], initial_nValue)
-            tree_txs = list(branch(tx0_outpoint, initial_nValue, n, fee=fee))
-            assert_equal(len(tree_txs), n)
+            tx0_outpoints, tree_txs = trees(n)
 
-            dbl_tx_hex = self.wallet.create_self_transfer(
-                utxo_to_spend=tx0_outpoint,
+            dbl_tx_hex = self.wallet.create_self_transfer_multi(
+                utxos_to_spend=tx0_outpoints,
                 sequence=0,
-                fee=2 * (Decimal(fee) / COIN) * n,
+                fee_per_output=2 * fee * n,
             )["hex"]
             # This will raise an exception
             assert_raises_rpc_error(-26, "too many potential replacements", self.nodes[0].sendrawtransaction, dbl_tx_hex, 0)
@@ -364,19 +373,22 @@ class ReplaceByFeeTest(BitcoinTestFramework):
         # Try directly replacing more than MAX_REPLACEMENT_LIMIT
         # transactions
 
-        # Start by creating a single transaction with many outputs
+        # Start by creating two transactions with many outputs, so that each one stays within
+        # the cluster count limit together with the spends of its outputs
         initial_nValue = 10 * COIN
-        utxo = self.make_utxo(self.nodes[0], initial_nValue)
+        utxos = [self.make_utxo(self.nodes[0], initial_nValue) for _ in range(2)]
         fee = int(0.0001 * COIN)
         split_value = int((initial_nValue - fee) / (MAX_REPLACEMENT_LIMIT + 1))
 
-        splitting_tx_utxos = self.wallet.send_self_transfer_multi(
-            from_node=self.nodes[0],
-            utxos_to_spend=[utxo],
-            sequence=0,
-            num_outputs=MAX_REPLACEMENT_LIMIT + 1,
-            amount_per_output=split_value,
-        )["new_utxos"]
+        splitting_tx_utxos = []
+        for utxo, num_outputs in zip(utxos, (MAX_REPLACEMENT_LIMIT // 2 + 1, MAX_REPLACEMENT_LIMIT // 2)):
+            splitting_tx_utxos += self.wallet.send_self_transfer_multi(
+                from_node=self.nodes[0],
+                utxos_to_spend=[utxo],
+                sequence=0,
+                num_outputs=num_outputs,
+                amount_per_output=split_value,
+            )["new_utxos"]
 
         # Now spend each of those outputs individually
         for utxo in splitting_tx_utxos:
@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test scriptpubkeyindex across nodes.
+
+Test that scantxoutset returns the same unspent outputs on a node running
+the scriptpubkeyindex as on a node scanning the UTXO set, and test the
+getaddressutxos RPC that requires the index.
+"""
+
+from decimal import Decimal
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import (
+    MiniWallet,
+    getnewdestination,
+)
+
+
+class ScriptPubKeyIndexTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.extra_args = [
+            ["-scriptpubkeyindex"],
+            [],
+        ]
+
+    def assert_same_unspents(self, descriptors):
+        with_index = self.nodes[0].scantxoutset("start", descriptors)
+        without_index = self.nodes[1].scantxoutset("start", descriptors)
+        for key in ["success", "height", "bestblock", "unspents", "total_amount"]:
+            assert_equal(with_index[key], without_index[key])
+        return with_index
+
+    def run_test(self):
+        self.wallet = MiniWallet(self.nodes[0])
+        self.wait_until(lambda: self.nodes[0].getindexinfo("scriptpubkeyindex")["scriptpubkeyindex"]["synced"])
+
+        _, spk_bech32, addr_bech32 = getnewdestination("bech32")
+        _, spk_legacy, addr_legacy = getnewdestination("legacy")
+        descriptors = [self.wallet.get_descriptor(), f"addr({addr_bech32})", f"addr({addr_legacy})"]
+
+        self.log.info("Check that scantxoutset finds the same outputs with and without the index")
+        result = self.assert_same_unspents(descriptors)
+        # Only the matching outputs are read from the index
+        assert_equal(result["txouts"], len(result["unspents"]))
+
+        self.wallet.send_to(from_node=self.nodes[0], scriptPubKey=spk_bech32, amount=1_000_000)
+        self.wallet.send_to(from_node=self.nodes[0], scriptPubKey=spk_legacy, amount=2_000_000)
+        self.wallet.send_to(from_node=self.nodes[0], scriptPubKey=spk_legacy, amount=4_000_000)
+        self.generate(self.nodes[0], 1)
+        self.assert_same_unspents(descriptors)
+
+        self.log.info("Test getaddressutxos")
+        result = self.nodes[0].getaddressutxos([addr_bech32, addr_legacy])
+        assert_equal(result["height"], self.nodes[0].getblockcount())
+        assert_equal(result["bestblock"], self.nodes[0].getbestblockhash())
+        assert_equal(sorted(u["address"] for u in result["unspents"]), sorted([addr_bech32, addr_legacy, addr_legacy]))
+        assert_equal(result["total_amount"], Decimal("0.07"))
+        for unspent in result["unspents"]:
+            assert_equal(unspent["blockhash"], self.nodes[0].getbestblockhash())
+            assert_equal(unspent["confirmations"], 1)
+            assert_equal(unspent["coinbase"], False)
+        assert_equal(self.nodes[0].getaddressutxos([getnewdestination()[2]])["unspents"], [])
+        assert_raises_rpc_error(-5, "Invalid address: foo", self.nodes[0].getaddressutxos, ["foo"])
+        assert_raises_rpc_error(-1, "Looking up outputs by address requires -scriptpubkeyindex", self.nodes[1].getaddressutxos, [addr_bech32])
+
+        self.log.info("Check that spent outputs are removed")
+        wallet_utxos = self.nodes[0].getaddressutxos([self.wallet.get_address()])["unspents"]
+        for _ in range(5):
+            self.wallet.send_self_transfer(from_node=self.nodes[0])
+        self.generate(self.nodes[0], 1)
+        self.assert_same_unspents(descriptors)
+
+        self.log.info("Check that a reorg restores the spent outputs")
+        for node in self.nodes:
+            node.invalidateblock(node.getbestblockhash())
+        # The index is only rewound when the next block is connected
+        assert_raises_rpc_error(-32603, "Unable to get data because scriptpubkeyindex is still syncing", self.nodes[0].getaddressutxos, [addr_bech32])
+        self.assert_same_unspents(descriptors)
+        # Leave the transactions of the disconnected block in the mempool
+        self.generateblock(self.nodes[0], self.wallet.get_address(), [])
+        self.assert_same_unspents(descriptors)
+        restored = self.nodes[0].getaddressutxos([self.wallet.get_address()])["unspents"]
+        assert {(u["txid"], u["vout"]) for u in wallet_utxos} < {(u["txid"], u["vout"]) for u in restored}
+
+        self.log.info("Check that the index is kept across restarts")
+        self.restart_node(0)
+        self.wait_until(lambda: self.nodes[0].getindexinfo("scriptpubkeyindex")["scriptpubkeyindex"]["synced"])
+        self.assert_same_unspents(descriptors)
+
+
+if __name__ == '__main__':
+    ScriptPubKeyIndexTest(__file__).main()
@@ -4,10 +4,15 @@
 # file COPYING or http://www.opensource.org/licenses/mit-license.php.
 """Test the RPC HTTP basics."""
 
+from test_framework.netutil import test_unix_socket
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import assert_equal, str_to_b64str
 
 import http.client
+import json
+import os
+import socket
+import tempfile
 import time
 import urllib.parse
 
@@ -155,6 +160,21 @@ class HTTPBasicsTest (BitcoinTestFramework):
         assert chunks[1].startswith(b'{"hash":')
         assert chunks[2].startswith(bytes(f'{tip_height + 1}', 'utf8'))
 
+        self.log.info("Check pipelined requests arriving at once are all answered, in order")
+        conn = http.client.HTTPConnection(urlNode2.hostname, urlNode2.port)
+        conn.connect()
+        sock = conn.sock
+        sock.settimeout(5)
+        heights = range(10)
+        bodies = [f'{{"method": "getblockhash", "params": [{height}]}}' for height in heights]
+        sock.sendall("".join(f'{req}Content-Length: {len(body)}\r\n\r\n{body}' for body in bodies).encode("utf-8"))
+        res = b""
+        while res.count(b'"result":') != len(bodies):
+            res += sock.recv(1024)
+        hashes = [chunk.split(b'"')[1].decode() for chunk in res.split(b'"result":')[1:]]
+        assert_equal(hashes, [self.nodes[2].getblockhash(height) for height in heights])
+        conn.close()
+
 
         self.log.info("Check HTTP request encoded with chunked transfer")
         headers_chunked = headers.copy()
@@ -179,6 +199,23 @@ class HTTPBasicsTest (BitcoinTestFramework):
         assert_equal(out1, b'{"result":"high-hash","error":null}\n')
 
 
+        self.log.info("Check large replies are sent with chunked transfer encoding")
+        conn = http.client.HTTPConnection(urlNode2.hostname, urlNode2.port)
+        conn.connect()
+        conn.request('POST', '/', '{"method": "echo", "params": ["' + 'a' * 1000000 + '"]}', headers)
+        response = conn.getresponse()
+        assert_equal(response.getheader('Transfer-Encoding'), 'chunked')
+        assert_equal(response.getheader('Content-Length'), None)
+        assert_equal(response.read(), b'{"result":["' + b'a' * 1000000 + b'"],"error":null}\n')
+        # Small replies still come with a Content-Length
+        conn.request('POST', '/', '{"method": "echo", "params": ["a"]}', headers)
+        response = conn.getresponse()
+        assert_equal(response.getheader('Transfer-Encoding'), None)
+        assert_equal(response.read(), b'{"result":["a"],"error":null}\n')
+        assert conn.sock is not None
+        conn.close()
+
+
         self.log.info("Check -rpcservertimeout")
         # The test framework typically reuses a single persistent HTTP connection
         # for all RPCs to a TestNode. Because we are setting -rpcservertimeout
@@ -237,5 +274,39 @@ class HTTPBasicsTest (BitcoinTestFramework):
         conn.request('GET', '/')
         conn.getresponse()
 
+        if test_unix_socket():
+            self.test_unix_socket()
+        else:
+            self.log.warning("Skipping unix domain socket test, not supported on this platform")
+
+    def test_unix_socket(self):
+        self.log.info("Check that JSON-RPC is served on a unix domain socket")
+        socket_path = tempfile.NamedTemporaryFile().name
+        # Bound without -rpcallowip, next to the default loopback addresses
+        self.restart_node(0, extra_args=[f"-rpcbind=unix:{socket_path}"])
+        url = urllib.parse.urlparse(self.nodes[0].url)
+        authpair = f'{url.username}:{url.password}'
+        headers = {"Authorization": f"Basic {str_to_b64str(authpair)}"}
+
+        sock = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+        sock.connect(socket_path)
+        conn = http.client.HTTPConnection('localhost')
+        conn.sock = sock
+        conn.request('POST', '/', '{"method": "getbestblockhash"}', headers)
+        response = conn.getresponse()
+        assert_equal(response.status, http.client.OK)
+        assert_equal(json.loads(response.read())['result'], self.nodes[0].getbestblockhash())
+
+        # Requests are authenticated the same as over TCP
+        conn.request('POST', '/', '{"method": "getbestblockhash"}')
+        response = conn.getresponse()
+        assert_equal(response.status, http.client.UNAUTHORIZED)
+        response.read()
+        conn.close()
+
+        self.log.info("Check that the socket file is removed on shutdown")
+        self.stop_node(0)
+        assert not os.path.exists(socket_path)
+
 if __name__ == '__main__':
     HTTPBasicsTest(__file__).main()
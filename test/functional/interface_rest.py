@@ -16,7 +16,9 @@ import urllib.parse
 from test_framework.messages import (
     BLOCK_HEADER_SIZE,
     COIN,
+    CBlock,
     deser_block_spent_outputs,
+    deser_compact_size,
 )
 from test_framework.test_framework import BitcoinTestFramework
 from test_framework.util import (
@@ -377,6 +379,22 @@ class RESTTest (BitcoinTestFramework):
 
         assert_equal(json_obj, raw_mempool)
 
+        # Check the binary mempool summary against the verbose contents
+        bin_mempool = BytesIO(self.test_rest_request("/mempool/contents", req_type=ReqType.BIN, ret_type=RetType.BYTES))
+        assert_equal(int.from_bytes(bin_mempool.read(8), 'little'), raw_mempool['mempool_sequence'])
+        assert_equal(deser_compact_size(bin_mempool), len(raw_mempool_verbose))
+        for _ in range(len(raw_mempool_verbose)):
+            txid = bin_mempool.read(32)[::-1].hex()
+            entry = raw_mempool_verbose[txid]
+            assert_equal(int.from_bytes(bin_mempool.read(8), 'little', signed=True), int(entry['fees']['base'] * COIN))
+            assert_equal(int.from_bytes(bin_mempool.read(8), 'little', signed=True), int(entry['fees']['modified'] * COIN))
+            assert_equal(int.from_bytes(bin_mempool.read(4), 'little', signed=True), entry['vsize'])
+            assert_equal(int.from_bytes(bin_mempool.read(8), 'little', signed=True), entry['time'])
+        assert_equal(bin_mempool.read(), b'')
+        hex_mempool = self.test_rest_request("/mempool/contents", req_type=ReqType.HEX, ret_type=RetType.OBJ).read().decode('utf-8').strip()
+        assert_equal(bytes.fromhex(hex_mempool), bin_mempool.getvalue())
+        self.test_rest_request("/mempool/info", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=404)
+
         # Check for error response if verbose=true and mempool_sequence=true
         resp = self.test_rest_request("/mempool/contents", ret_type=RetType.OBJ, status=400, query_params={"verbose": "true", "mempool_sequence": "true"})
         assert_equal(resp.read().decode('utf-8').strip(), 'Verbose results cannot contain mempool sequence values. (hint: set "verbose=false")')
@@ -456,6 +474,39 @@ class RESTTest (BitcoinTestFramework):
                 assert_equal(expected, actual)
 
 
+        self.log.info("Test the /blockrange URI")
+
+        block_count = self.nodes[0].getblockcount()
+        # Ask for more blocks than there are, the range stops at the tip
+        range_bin = self.test_rest_request(f"/blockrange/1/{block_count + 10}", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        range_spent_bin = self.test_rest_request(f"/blockrange/1/{block_count + 10}", req_type=ReqType.BIN, ret_type=RetType.BYTES, query_params={"spenttxouts": 1})
+        range_stream = BytesIO(range_bin)
+        range_spent_stream = BytesIO(range_spent_bin)
+        for height in range(1, block_count + 1):
+            blockhash = self.nodes[0].getblockhash(height)
+            block = CBlock()
+            block.deserialize(range_stream)
+            assert_equal(block.hash_hex, blockhash)
+            block.deserialize(range_spent_stream)
+            assert_equal(block.hash_hex, blockhash)
+            spent_start = range_spent_stream.tell()
+            deser_block_spent_outputs(range_spent_stream)
+            spent_bin = self.test_rest_request(f"/spenttxouts/{blockhash}", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+            assert_equal(range_spent_bin[spent_start:range_spent_stream.tell()], spent_bin)
+        assert_equal(range_stream.read(), b"")
+        assert_equal(range_spent_stream.read(), b"")
+
+        single_bin = self.test_rest_request(f"/blockrange/{block_count}/1", req_type=ReqType.BIN, ret_type=RetType.BYTES)
+        assert_equal(single_bin, self.test_rest_request(f"/block/{self.nodes[0].getbestblockhash()}", req_type=ReqType.BIN, ret_type=RetType.BYTES))
+
+        resp = self.test_rest_request(f"/blockrange/{block_count + 1}/1", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=404)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Block height out of range")
+        resp = self.test_rest_request("/blockrange/0/1001", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400)
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Block count is invalid or out of acceptable range (1-1000): 1001")
+        resp = self.test_rest_request("/blockrange/0/1", req_type=ReqType.BIN, ret_type=RetType.OBJ, status=400, query_params={"spenttxouts": "yes"})
+        assert_equal(resp.read().decode('utf-8').rstrip(), "Invalid spenttxouts value, expected 0 or 1: yes")
+        self.test_rest_request("/blockrange/0/1", req_type=ReqType.JSON, ret_type=RetType.OBJ, status=404)
+
         self.log.info("Test the /deploymentinfo URI")
 
         deployment_info = self.nodes[0].getdeploymentinfo()
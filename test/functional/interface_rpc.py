@@ -105,6 +105,36 @@ class RPCInterfaceTest(BitcoinTestFramework):
         assert_greater_than_or_equal(command['duration'], 0)
         assert_equal(info['logpath'], os.path.join(self.nodes[0].chain_path, 'debug.log'))
 
+        assert_equal([queue['priority'] for queue in info['work_queue']], ['high', 'normal'])
+        normal = info['work_queue'][1]
+        assert_greater_than_or_equal(normal['processed'], 1)
+        assert_greater_than_or_equal(normal['max_wait'], 0)
+        assert_greater_than_or_equal(normal['total_wait'], normal['max_wait'])
+
+        # Calls of methods that only read node state are queued as high priority work.
+        high_processed = info['work_queue'][0]['processed']
+        self.nodes[0].getblockcount()
+        assert_greater_than_or_equal(self.nodes[0].getrpcinfo()['work_queue'][0]['processed'], high_processed + 1)
+
+    def test_rpc_timings(self):
+        self.log.info("Testing per-method timings in getrpcinfo...")
+        node = self.nodes[0]
+        node.getblockcount()
+        # The send phase is timed once the reply has been written, which may be after it arrived
+        self.wait_until(lambda: 'send' in node.getrpcinfo()['methods']['getblockcount'])
+        methods = node.getrpcinfo()['methods']
+        assert 'getchaintips' not in methods
+        for phase in ['queue', 'execution', 'serialization', 'send']:
+            timing = methods['getblockcount'][phase]
+            assert_greater_than_or_equal(timing['count'], 1)
+            assert_greater_than_or_equal(timing['total'], timing['max'])
+            assert_equal(len(timing['histogram']), 24)
+            assert_equal(sum(timing['histogram']), timing['count'])
+
+        self.log.info("Testing batch requests are timed as a whole under *other*...")
+        assert_greater_than_or_equal(methods['*other*']['queue']['count'], 1)
+        assert 'execution' not in methods['*other*']
+
     def test_batch_request(self, call_options):
         calls = [
             # A basic request that will work fine.
@@ -177,6 +207,33 @@ class RPCInterfaceTest(BitcoinTestFramework):
             request_fields={"jsonrpc": "2.1"},
             response_fields={"result": None, "error": {"code": RPC_INVALID_REQUEST, "message": "JSON-RPC version not supported"}}))
 
+    def test_parallel_batch_request(self):
+        self.log.info("Testing batch request with runs of parallel-safe calls...")
+        genesis_hash = self.nodes[0].getblockhash(0)
+        request = []
+        for idx in range(300):
+            if idx % 100 == 50:
+                # Not parallel-safe, splits the batch into runs
+                request.append({"jsonrpc": "2.0", "id": idx, "method": "uptime"})
+            elif idx % 13 == 0:
+                request.append({"jsonrpc": "2.0", "method": "getblockcount"})
+            elif idx % 7 == 0:
+                request.append({"jsonrpc": "2.0", "id": idx, "method": "getblockhash", "params": [idx]})
+            else:
+                request.append({"jsonrpc": "2.0", "id": idx, "method": "getblockheader", "params": [genesis_hash]})
+
+        rpc_response, http_status = send_json_rpc(self.nodes[0], request)
+        assert_equal(http_status, 200)
+        # Responses come back in request order, without the notifications
+        assert_equal([r["id"] for r in rpc_response], [r["id"] for r in request if "id" in r])
+        for r in rpc_response:
+            if r["id"] % 100 == 50:
+                assert_greater_than_or_equal(r["result"], 0)
+            elif r["id"] % 7 == 0:
+                assert_equal(r["error"], {"code": RPC_INVALID_PARAMETER, "message": "Block height out of range"})
+            else:
+                assert_equal(r["result"]["hash"], genesis_hash)
+
     def test_http_status_codes(self):
         self.log.info("Testing HTTP status codes for JSON-RPC 1.1 requests...")
         # OK
@@ -237,10 +294,13 @@ class RPCInterfaceTest(BitcoinTestFramework):
             threads.append(t)
         for t in threads:
             t.join()
+        assert_greater_than_or_equal(self.nodes[0].getrpcinfo()['work_queue'][1]['rejected'], 1)
 
     def run_test(self):
         self.test_getrpcinfo()
         self.test_batch_requests()
+        self.test_parallel_batch_request()
+        self.test_rpc_timings()
         self.test_http_status_codes()
         self.test_work_queue_exceeded()
 
@@ -0,0 +1,53 @@
+#!/usr/bin/env python3
+# Copyright (c) The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test that the mempool rejects transactions that would create a cluster over the count limit."""
+
+from test_framework.blocktools import COINBASE_MATURITY
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import (
+    assert_equal,
+    assert_raises_rpc_error,
+)
+from test_framework.wallet import MiniWallet
+
+# Maximum number of transactions in a mempool cluster, see MEMPOOL_MAX_CLUSTER_COUNT.
+MAX_CLUSTER_COUNT = 64
+
+
+class MempoolClusterTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+
+    def run_test(self):
+        node = self.nodes[0]
+        wallet = MiniWallet(node)
+
+        self.log.info("Build a cluster in which every transaction is well within the ancestor and descendant limits")
+        # Parents with two outputs each, and children spending outputs of neighbouring parents, so
+        # that every transaction has at most 3 ancestors and 3 descendants while all of them end up
+        # in a single cluster.
+        num_parents = MAX_CLUSTER_COUNT // 2 + 1
+        self.generate(wallet, num_parents)
+        self.generate(node, COINBASE_MATURITY)
+        parents = [wallet.send_self_transfer_multi(from_node=node, num_outputs=2, confirmed_only=True) for _ in range(num_parents)]
+        for i in range(num_parents - 2):
+            wallet.send_self_transfer_multi(from_node=node, utxos_to_spend=[parents[i]["new_utxos"][1], parents[i + 1]["new_utxos"][0]])
+        # All parents but the last one are in a cluster of MAX_CLUSTER_COUNT - 1 transactions.
+        assert_equal(node.getmempoolinfo()["size"], MAX_CLUSTER_COUNT)
+
+        self.log.info("A transaction that would merge the cluster beyond the limit is rejected")
+        last_child = wallet.create_self_transfer_multi(utxos_to_spend=[parents[-2]["new_utxos"][1], parents[-1]["new_utxos"][0]])
+        assert_raises_rpc_error(-26, "too-large-cluster", node.sendrawtransaction, last_child["hex"])
+        testres = node.testmempoolaccept([last_child["hex"]])[0]
+        assert_equal(testres["allowed"], False)
+        assert_equal(testres["reject-reason"], "too-large-cluster")
+
+        self.log.info("Transactions that stay within the limit are still accepted")
+        wallet.send_self_transfer(from_node=node, utxo_to_spend=parents[-1]["new_utxos"][1])
+        assert_equal(node.getmempoolinfo()["size"], MAX_CLUSTER_COUNT + 1)
+
+
+if __name__ == '__main__':
+    MempoolClusterTest(__file__).main()
@@ -195,6 +195,7 @@ class MempoolPersistTest(BitcoinTestFramework):
 
         self.test_importmempool_union()
         self.test_persist_unbroadcast()
+        self.test_persist_trusted()
 
     def test_persist_unbroadcast(self):
         node0 = self.nodes[0]
@@ -218,6 +219,26 @@ class MempoolPersistTest(BitcoinTestFramework):
         node0.mockscheduler(16 * 60)  # 15 min + 1 for buffer
         self.wait_until(lambda: len(conn.get_invs()) == 1)
 
+    def test_persist_trusted(self):
+        self.log.debug("Submit a transaction and restart node0 with -persistmempooltrust")
+        node0 = self.nodes[0]
+        tx = self.mini_wallet.send_self_transfer(from_node=node0)
+        with node0.assert_debug_log(["Loading mempool transactions saved at the current tip without script verification"]):
+            self.restart_node(0, extra_args=["-persistmempooltrust"])
+        assert tx["txid"] in node0.getrawmempool()
+
+        self.log.debug("Verify the scripts are checked again once the tip changed")
+        node0.savemempool()
+        mempooldat0 = node0.chain_path / "mempool.dat"
+        saved = mempooldat0.read_bytes()
+        self.generate(node0, 1, sync_fun=self.no_op)
+        self.stop_node(0)
+        mempooldat0.write_bytes(saved)
+        with node0.assert_debug_log(expected_msgs=["Imported mempool transactions from file: 0 succeeded"],
+                                    unexpected_msgs=["without script verification"]):
+            self.start_node(0, extra_args=["-persistmempooltrust"])
+        assert_equal(node0.getrawmempool(), [])
+
     def test_importmempool_union(self):
         self.log.debug("Submit different transactions to node0 and node1's mempools")
         self.start_node(0)
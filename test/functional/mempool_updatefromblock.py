@@ -23,6 +23,8 @@ MAX_DISCONNECTED_TX_POOL_BYTES = 20_000_000
 
 CUSTOM_ANCESTOR_COUNT = 100
 CUSTOM_DESCENDANT_COUNT = CUSTOM_ANCESTOR_COUNT
+# Maximum number of transactions in a mempool cluster, see MEMPOOL_MAX_CLUSTER_COUNT.
+MAX_CLUSTER_COUNT = 64
 
 class MempoolUpdateFromBlockTest(BitcoinTestFramework):
     def set_test_params(self):
@@ -197,12 +199,12 @@ class MempoolUpdateFromBlockTest(BitcoinTestFramework):
         # Prep fork
         fork_blocks = self.create_empty_fork(fork_length=10)
 
-        # Two higher than descendant count
-        chain = wallet.create_self_transfer_chain(chain_length=CUSTOM_DESCENDANT_COUNT + 2)
+        # Two higher than the cluster count limit, which is below the custom ancestor and descendant limits
+        chain = wallet.create_self_transfer_chain(chain_length=MAX_CLUSTER_COUNT + 2)
         for tx in chain[:-2]:
             self.nodes[0].sendrawtransaction(tx["hex"])
 
-        assert_raises_rpc_error(-26, "too-long-mempool-chain, too many unconfirmed ancestors [limit: 100]", self.nodes[0].sendrawtransaction, chain[-2]["hex"])
+        assert_raises_rpc_error(-26, "too-large-cluster", self.nodes[0].sendrawtransaction, chain[-2]["hex"])
 
         # Mine a block with all but last transaction, non-standardly long chain
         self.generateblock(self.nodes[0], output="raw(42)", transactions=[tx["hex"] for tx in chain[:-1]])
@@ -219,8 +221,8 @@ class MempoolUpdateFromBlockTest(BitcoinTestFramework):
         assert_equal(set(mempool), set([tx["txid"] for tx in chain[:-2]]))
 
     def run_test(self):
-        # Mine in batches of 25 to test multi-block reorg under chain limits
-        self.transaction_graph_test(size=CUSTOM_ANCESTOR_COUNT, n_tx_to_mine=[25, 50, 75])
+        # Mine in batches of 16 to test multi-block reorg under chain and cluster limits
+        self.transaction_graph_test(size=MAX_CLUSTER_COUNT, n_tx_to_mine=[16, 32, 48])
 
         self.test_max_disconnect_pool_bytes()
 
@@ -0,0 +1,136 @@
+#!/usr/bin/env python3
+# Copyright (c) The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test transaction reconciliation rounds (BIP-330) against the node.
+
+The test framework plays both roles: as an inbound peer the node responds to our
+reconciliation requests, as an outbound peer the node initiates them.
+"""
+
+from test_framework.crypto.siphash import siphash256
+from test_framework.key import TaggedHash
+from test_framework.messages import (
+    MSG_WTX,
+    msg_reconcildiff,
+    msg_reqrecon,
+    msg_sendtxrcncl,
+    msg_sketch,
+)
+from test_framework.p2p import (
+    P2PInterface,
+    p2p_lock,
+)
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import MiniWallet
+
+# Fixed-point q coefficient the node sends in reqrecon, see RECON_Q and Q_PRECISION.
+RECON_Q = int(0.25 * ((2 << 14) - 1))
+# Enough time to pass at least one transaction trickle towards any peer.
+TRICKLE_TIME = 300
+
+
+class ReconciliationPeer(P2PInterface):
+    def __init__(self, salt):
+        super().__init__(wtxidrelay=True)
+        self.salt = salt
+        self.node_salt = None
+
+    def send_version(self):
+        super().send_version()
+        # Reconciliation support has to be announced between VERSION and VERACK.
+        sendtxrcncl = msg_sendtxrcncl()
+        sendtxrcncl.version = 1
+        sendtxrcncl.salt = self.salt
+        self.send_without_ping(sendtxrcncl)
+
+    def on_sendtxrcncl(self, message):
+        self.node_salt = message.salt
+
+    def short_id(self, wtxid):
+        """Short ID of a transaction in sketches exchanged with the node."""
+        salts = sorted([self.salt, self.node_salt])
+        full_salt = TaggedHash("Tx Relay Salting", b"".join(salt.to_bytes(8, "little") for salt in salts))
+        k0 = int.from_bytes(full_salt[0:8], "little")
+        k1 = int.from_bytes(full_salt[8:16], "little")
+        return 1 + siphash256(k0, k1, wtxid) % 0xFFFFFFFF
+
+    def announced(self, wtxid):
+        """Whether the last inv received announced the transaction. Must be called with p2p_lock held."""
+        return "inv" in self.last_message and any(inv.type == MSG_WTX and inv.hash == wtxid for inv in self.last_message["inv"].inv)
+
+
+class TxReconciliationTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 1
+        self.extra_args = [['-txreconciliation']]
+
+    def run_test(self):
+        node = self.nodes[0]
+        self.wallet = MiniWallet(node)
+        node.setmocktime(int(node.getblockheader(node.getbestblockhash())["time"]))
+
+        self.test_initiator(node)
+        self.test_responder(node)
+
+    def test_initiator(self, node):
+        self.log.info("Outbound peers we reconcile with are sent reqrecon and get transactions flooded to them")
+        peer = node.add_outbound_p2p_connection(ReconciliationPeer(salt=2), p2p_idx=0, connection_type="outbound-full-relay")
+        peer.wait_until(lambda: "reqrecon" in peer.last_message)
+        with p2p_lock:
+            assert_equal(peer.last_message["reqrecon"].set_size, 0)
+            assert_equal(peer.last_message["reqrecon"].q, RECON_Q)
+
+        # As the only outbound peer, it is a fanout target for every transaction.
+        wtxid = self.wallet.send_self_transfer(from_node=node)["tx"].wtxid_int
+        node.bumpmocktime(TRICKLE_TIME)
+        peer.wait_until(lambda: peer.announced(wtxid))
+
+        # We have nothing to offer, so the node has nothing to ask for.
+        peer.send_without_ping(msg_sketch())
+        peer.wait_until(lambda: "reconcildiff" in peer.last_message)
+        with p2p_lock:
+            assert_equal(peer.last_message["reconcildiff"].success, 1)
+            assert_equal(peer.last_message["reconcildiff"].ask_shortids, [])
+        node.disconnect_p2ps()
+
+    def test_responder(self, node):
+        self.log.info("Inbound peers we reconcile with learn about transactions through reconciliation")
+        peer = node.add_p2p_connection(ReconciliationPeer(salt=3))
+        assert peer.node_salt is not None
+
+        wtxid = self.wallet.send_self_transfer(from_node=node)["tx"].wtxid_int
+        node.bumpmocktime(TRICKLE_TIME)
+        # Make sure the node went through its send loop for this peer after the time bump.
+        peer.sync_with_ping()
+        peer.sync_with_ping()
+        with p2p_lock:
+            assert not peer.announced(wtxid)
+
+        self.log.info("The node responds to reqrecon with a sketch of its set")
+        reqrecon = msg_reqrecon()
+        reqrecon.set_size = 0
+        reqrecon.q = RECON_Q
+        peer.send_without_ping(reqrecon)
+        peer.wait_until(lambda: "sketch" in peer.last_message)
+        with p2p_lock:
+            skdata = peer.last_message["sketch"].skdata
+        assert len(skdata) > 0
+        assert_equal(len(skdata) % 4, 0)
+
+        self.log.info("Transactions asked for in reconcildiff are announced")
+        reconcildiff = msg_reconcildiff()
+        reconcildiff.success = 1
+        reconcildiff.ask_shortids = [peer.short_id(wtxid)]
+        peer.send_without_ping(reconcildiff)
+        peer.wait_until(lambda: peer.announced(wtxid))
+
+        self.log.info("A sketch from a peer that we did not ask for one is a protocol violation")
+        with node.assert_debug_log(["txreconciliation protocol violation (unexpected sketch)"]):
+            peer.send_without_ping(msg_sketch())
+            peer.wait_for_disconnect()
+
+
+if __name__ == '__main__':
+    TxReconciliationTest(__file__).main()
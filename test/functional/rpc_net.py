@@ -22,6 +22,7 @@ from test_framework.util import (
     assert_approx,
     assert_equal,
     assert_greater_than,
+    assert_greater_than_or_equal,
     assert_raises_rpc_error,
     p2p_port,
 )
@@ -82,6 +83,7 @@ class NetTest(BitcoinTestFramework):
         self.test_connection_count()
         self.test_getpeerinfo()
         self.test_getnettotals()
+        self.test_getnetmsgstats()
         self.test_getnetworkinfo()
         self.test_addnode_getaddednodeinfo()
         self.test_service_flags()
@@ -202,6 +204,24 @@ class NetTest(BitcoinTestFramework):
             self.wait_until(lambda: peer_after()['bytesrecv_per_msg'].get('pong', 0) >= peer_before['bytesrecv_per_msg'].get('pong', 0) + ping_size, timeout=1)
             self.wait_until(lambda: peer_after()['bytessent_per_msg'].get('ping', 0) >= peer_before['bytessent_per_msg'].get('ping', 0) + ping_size, timeout=1)
 
+    def test_getnetmsgstats(self):
+        self.log.info("Test getnetmsgstats")
+        stats_before = self.nodes[0].getnetmsgstats()
+        pongs_before = stats_before.get('pong', {}).get('count', 0)
+
+        self.nodes[0].ping()
+        # Each of the two peers answers our ping with a pong
+        self.wait_until(lambda: self.nodes[0].getnetmsgstats().get('pong', {}).get('count', 0) >= pongs_before + 2, timeout=1)
+
+        stats = self.nodes[0].getnetmsgstats()
+        for msg_type, msg_stats in stats.items():
+            assert msg_stats['count'] > 0
+            assert_greater_than_or_equal(msg_stats['processing_time'], msg_stats['max_processing_time'])
+            for histogram in ['processing_time_histogram', 'queue_wait_histogram']:
+                assert_equal(len(msg_stats[histogram]), 24)
+                assert_equal(sum(msg_stats[histogram]), msg_stats['count'])
+        assert 'version' in stats
+
     def test_getnetworkinfo(self):
         self.log.info("Test getnetworkinfo")
         info = self.nodes[0].getnetworkinfo()
@@ -0,0 +1,73 @@
+#!/usr/bin/env python3
+# Copyright (c) 2025-present The Bitcoin Core developers
+# Distributed under the MIT software license, see the accompanying
+# file COPYING or http://www.opensource.org/licenses/mit-license.php.
+"""Test the response cache enabled with -rpccachesize.
+
+Node 0 caches responses and node 1 does not. As both follow the same chain, they
+must answer the same, including after new blocks and after a reorg.
+"""
+
+import http.client
+import urllib.parse
+
+from test_framework.test_framework import BitcoinTestFramework
+from test_framework.util import assert_equal
+from test_framework.wallet import MiniWallet
+
+
+class ResponseCacheTest(BitcoinTestFramework):
+    def set_test_params(self):
+        self.num_nodes = 2
+        self.extra_args = [
+            ["-rpccachesize=8", "-rest", "-txindex", "-blockfilterindex"],
+            ["-rest", "-txindex", "-blockfilterindex"],
+        ]
+
+    def rest_get(self, node, uri):
+        url = urllib.parse.urlparse(node.url)
+        conn = http.client.HTTPConnection(url.hostname, url.port)
+        conn.request('GET', f'/rest{uri}')
+        response = conn.getresponse()
+        assert_equal(response.status, 200)
+        return response.read()
+
+    def assert_same_responses(self, blockhashes, txid):
+        # The second round is answered from the cache by node 0
+        for _ in range(2):
+            for blockhash in blockhashes:
+                for verbosity in range(4):
+                    assert_equal(self.nodes[0].getblock(blockhash, verbosity), self.nodes[1].getblock(blockhash, verbosity))
+                assert_equal(self.nodes[0].getblockfilter(blockhash), self.nodes[1].getblockfilter(blockhash))
+                for uri in [f'/block/{blockhash}.json', f'/block/notxdetails/{blockhash}.json']:
+                    assert_equal(self.rest_get(self.nodes[0], uri), self.rest_get(self.nodes[1], uri))
+            for ext in ['bin', 'hex', 'json']:
+                assert_equal(self.rest_get(self.nodes[0], f'/tx/{txid}.{ext}'), self.rest_get(self.nodes[1], f'/tx/{txid}.{ext}'))
+
+    def run_test(self):
+        wallet = MiniWallet(self.nodes[0])
+        txid = wallet.send_self_transfer(from_node=self.nodes[0])['txid']
+        self.generate(self.nodes[0], 3)
+        height = self.nodes[0].getblockcount()
+        blockhashes = [self.nodes[0].getblockhash(h) for h in range(height - 3, height + 1)]
+
+        self.log.info("Check that cached responses match uncached ones")
+        self.assert_same_responses(blockhashes, txid)
+
+        self.log.info("Check that confirmations and next block hashes follow new blocks")
+        self.generate(self.nodes[0], 1)
+        self.assert_same_responses(blockhashes, txid)
+
+        self.log.info("Check that responses about disconnected blocks are not served from the cache")
+        for node in self.nodes:
+            node.invalidateblock(blockhashes[1])
+        # The transaction is back in the mempool now
+        assert 'blockhash' not in self.rest_get(self.nodes[0], f'/tx/{txid}.json').decode()
+        self.assert_same_responses(blockhashes[:1], txid)
+        self.generate(self.nodes[0], 4)
+        height = self.nodes[0].getblockcount()
+        self.assert_same_responses([self.nodes[0].getblockhash(h) for h in range(height - 4, height + 1)], txid)
+
+
+if __name__ == '__main__':
+    ResponseCacheTest(__file__).main()
@@ -60,10 +60,13 @@ from test_framework.messages import (
     msg_notfound,
     msg_ping,
     msg_pong,
+    msg_reconcildiff,
+    msg_reqrecon,
     msg_sendaddrv2,
     msg_sendcmpct,
     msg_sendheaders,
     msg_sendtxrcncl,
+    msg_sketch,
     msg_tx,
     MSG_TX,
     MSG_TYPE_MASK,
@@ -138,10 +141,13 @@ MESSAGEMAP = {
     b"notfound": msg_notfound,
     b"ping": msg_ping,
     b"pong": msg_pong,
+    b"reconcildiff": msg_reconcildiff,
+    b"reqrecon": msg_reqrecon,
     b"sendaddrv2": msg_sendaddrv2,
     b"sendcmpct": msg_sendcmpct,
     b"sendheaders": msg_sendheaders,
     b"sendtxrcncl": msg_sendtxrcncl,
+    b"sketch": msg_sketch,
     b"tx": msg_tx,
     b"verack": msg_verack,
     b"version": msg_version,
@@ -556,6 +562,9 @@ class P2PInterface(P2PConnection):
     def on_sendcmpct(self, message): pass
     def on_sendheaders(self, message): pass
     def on_sendtxrcncl(self, message): pass
+    def on_reqrecon(self, message): pass
+    def on_sketch(self, message): pass
+    def on_reconcildiff(self, message): pass
     def on_tx(self, message): pass
     def on_wtxidrelay(self, message): pass
 
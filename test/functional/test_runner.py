@@ -247,6 +247,7 @@ BASE_SCRIPTS = [
     'wallet_txn_clone.py --mineblock',
     'feature_notifications.py',
     'rpc_getblockfilter.py',
+    'rpc_response_cache.py',
     'rpc_getblockfrompeer.py',
     'rpc_invalidateblock.py',
     'feature_utxo_set_hash.py',
@@ -254,6 +255,7 @@ BASE_SCRIPTS = [
     'mempool_packages.py',
     'mempool_package_onemore.py',
     'mempool_package_limits.py',
+    'mempool_cluster.py',
     'mempool_package_rbf.py',
     'tool_utxo_to_sqlite.py',
     'feature_versionbits_warning.py',
@@ -336,6 +338,7 @@ BASE_SCRIPTS = [
     'rpc_getdescriptoractivity.py',
     'rpc_scanblocks.py',
     'p2p_sendtxrcncl.py',
+    'p2p_txreconciliation.py',
     'rpc_scantxoutset.py',
     'feature_unsupported_utxo_db.py',
     'feature_logging.py',
@@ -344,6 +347,7 @@ BASE_SCRIPTS = [
     'mempool_datacarrier.py',
     'feature_coinstatsindex.py',
     'feature_coinstatsindex_compatibility.py',
+    'feature_scriptpubkeyindex.py',
     'wallet_orphanedreward.py',
     'wallet_timelock.py',
     'p2p_permissions.py',